@@ -11,11 +11,57 @@ CONFIG += c++17
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
-    basler_camera.cpp
+    basler_camera.cpp \
+    bayer_demosaic.cpp \
+    camera_configuration.cpp \
+    camera_controller.cpp \
+    camera_manager.cpp \
+    camera_parameter_model.cpp \
+    display_scheduler.cpp \
+    frame_handle.cpp \
+    frame_recorder.cpp \
+    frame_statistics.cpp \
+    frame_timing_monitor.cpp \
+    latency_histogram.cpp \
+    mono_display_mapper.cpp \
+    packed_mono_unpacker.cpp \
+    playback_frame_source.cpp \
+    pooled_buffer_factory.cpp \
+    pre_trigger_buffer.cpp \
+    preview_renderer.cpp \
+    pylon_frame_source.cpp \
+    raw_sequence.cpp \
+    synthetic_frame_source.cpp \
+    thread_affinity.cpp \
+    thread_policy.cpp
 
 HEADERS += \
     mainwindow.h \
-    basler_camera.h
+    basler_camera.h \
+    bayer_demosaic.h \
+    camera_configuration.h \
+    camera_controller.h \
+    camera_manager.h \
+    camera_parameter_model.h \
+    display_scheduler.h \
+    frame_handle.h \
+    frame_mailbox.h \
+    frame_recorder.h \
+    frame_source.h \
+    frame_statistics.h \
+    frame_timing_monitor.h \
+    latency_histogram.h \
+    mono_display_mapper.h \
+    packed_mono_unpacker.h \
+    playback_frame_source.h \
+    pooled_buffer_factory.h \
+    pre_trigger_buffer.h \
+    preview_renderer.h \
+    pylon_frame_source.h \
+    raw_sequence.h \
+    synthetic_frame_source.h \
+    thread_affinity.h \
+    thread_policy.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -28,7 +74,8 @@ LIBS += -L/usr/lib/x86_64-linux-gnu/
 LIBS += -lopencv_core \
         -lopencv_highgui \
         -lopencv_imgcodecs \
-        -lopencv_imgproc
+        -lopencv_imgproc \
+        -lopencv_videoio
 
 # Basler Pylon
 INCLUDEPATH += /opt/pylon/include
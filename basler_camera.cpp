@@ -1,10 +1,20 @@
 #include "basler_camera.h"
-#include <QDir>
+#include "pylon_frame_source.h"
 #include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+// Control commands that only read settings back, they report no write
+static const char *const READ_BACK_KEY = "ReadBack";
+static const char *const AUTO_EXPOSURE_KEY = "AutoExposure";
 
 BaslerCamera::BaslerCamera(QObject *parent)
     : QObject(parent)
+    , m_source(nullptr)
+    , m_syntheticSource(nullptr)
+    , m_playbackSource(nullptr)
     , m_camera(nullptr)
+    , m_sourceType(SourceGigE)
     , m_grabThread(nullptr)
     , m_grabFlag(false)
     , m_connected(false)
@@ -16,23 +26,58 @@ BaslerCamera::BaslerCamera(QObject *parent)
     , m_exposureAuto(false)
     , m_frameRateEnabled(false)
     , m_frameRate(30.0)
+    , m_payloadSize(0)
+    , m_linkThroughput(0)
     , m_triggerEnabled(false)
     , m_triggerMode("Off")
     , m_triggerSource("Software")
     , m_triggerDelay(0.0)
+    , m_syntheticWidth(1920)
+    , m_syntheticHeight(1200)
+    , m_syntheticPixelType(PixelType_Mono8)
+    , m_syntheticFrameRate(30.0)
+    , m_syntheticFrameRateEnabled(true)
+    , m_playbackPacing(PlaybackFrameSource::PacingRealTime)
+    , m_playbackLoop(false)
+    , m_playbackFrameRate(30.0)
     , m_recordingEnabled(false)
-    , m_recordingPath("./recorded_images")
-    , m_recordedImageCount(0)
-    , m_maxRecordedImages(100)
-    , m_frameCount(0)
+    , m_recorder(new FrameRecorder(this))
+    , m_preTrigger(new PreTriggerBuffer(this))
+    , m_parameters(new CameraParameterModel(this))
+    , m_controller(new CameraController(this))
+    , m_grabBufferCount(0)
+    , m_grabBufferSize(0)
+    , m_grabBufferHugePages(false)
+    , m_grabBufferLockMemory(false)
+    , m_grabStrategy(IFrameSource::GrabOneByOne)
+    , m_grabQueueSize(2)
+    , m_eventDriven(false)
+    , m_eventDrivenActive(false)
+    , m_appliedGrabThreadCore(-1)
+    , m_grabThreadPolicyApplied(false)
+    , m_statisticsTimer(new QTimer(this))
     , m_realTimeFrameRate(0.0)
-    , m_lastFrameTime(0.0)
-    ,     m_currentFrameId(0)
+    , m_currentFrameId(0)
     , m_errorsCount(0)
     , m_cameraIP("192.168.0.2")
 {
     qDebug() << "[BaslerCamera] Constructor called";
     
+    QObject::connect(m_recorder, &FrameRecorder::statsUpdated, this, &BaslerCamera::recordingStatsUpdated);
+    QObject::connect(m_preTrigger, &PreTriggerBuffer::dumpFinished, this, &BaslerCamera::preTriggerDumpFinished);
+    QObject::connect(m_parameters, &CameraParameterModel::parametersChanged, this, &BaslerCamera::onParametersChanged);
+    QObject::connect(m_controller, &CameraController::commandFinished, this, &BaslerCamera::onControlCommandFinished);
+    m_recorder->setWriteLatencyHistogram(&m_latencyHistograms[LatencyRecordWrite]);
+    m_recorder->setEncodeTimeHistogram(&m_latencyHistograms[LatencyRecordEncode]);
+    
+    m_statisticsTimer->setInterval(STATISTICS_PUBLISH_INTERVAL_MS);
+    QObject::connect(m_statisticsTimer, &QTimer::timeout, this, &BaslerCamera::publishStatistics);
+    
+    // The Pylon camera emulator only shows up when PYLON_CAMEMU is set before initialization
+    if (qEnvironmentVariableIsEmpty("PYLON_CAMEMU")) {
+        qputenv("PYLON_CAMEMU", "1");
+    }
+    
     try {
         // Initialize Pylon
         PylonInitialize();
@@ -65,167 +110,90 @@ bool BaslerCamera::connect()
     qDebug() << "[BaslerCamera] Connecting to camera...";
     updateStatus("Connecting to camera...");
     
-    try {
-        // Get the transport layer factory
-        CTlFactory& tlFactory = CTlFactory::GetInstance();
-        
-//        // Get all attached devices
-//        DeviceInfoList_t devices;
-
-//        for (size_t i = 0; i < devices.size(); ++i) {
-//            qDebug() << "[BaslerCamera] Found device:"
-//                     << QString::fromUtf8(devices[i].GetFriendlyName().c_str());
-//        }
-
-//        if (tlFactory.EnumerateDevices(devices) == 0) {
-//            qDebug() << "[BaslerCamera] No camera found!";
-//            updateStatus("No camera found");
-//            return false;
-//        }
-        
-//        qDebug() << "[BaslerCamera] Found" << devices.size() << "camera(s)";
-//        updateStatus(QString("Found %1 camera(s)").arg(devices.size()));
-
-        DeviceInfoList_t allDevices;
-        tlFactory.EnumerateDevices(allDevices);
-
-        qDebug() << "[BaslerCamera] Total devices found:" << allDevices.size();
-
-        for (size_t i = 0; i < allDevices.size(); ++i) {
-            qDebug() << "[BaslerCamera] Found device:"
-                    << QString::fromUtf8(allDevices[i].GetFriendlyName().c_str())
-                    << "Device Class:" << allDevices[i].GetDeviceClass();
-        }
-
-        // Check all devices for IP address and find specific IP camera
-        DeviceInfoList_t gigeDevices;
-        CDeviceInfo targetDevice;
-        bool foundTargetCamera = false;
-        
-        for (const auto& deviceInfo : allDevices) {
-            qDebug() << "[BaslerCamera] Checking device:" << QString::fromUtf8(deviceInfo.GetFriendlyName().c_str());
+    // Create the frame source for the selected backend
+    switch (m_sourceType) {
+        case SourceSynthetic:
+            m_syntheticSource = new SyntheticFrameSource(m_syntheticWidth, m_syntheticHeight, m_syntheticPixelType,
+                                                         m_syntheticFrameRateEnabled ? m_syntheticFrameRate : 0.0);
+            m_source = m_syntheticSource;
+            break;
             
-            // Check if this is a GigE device
-            if (deviceInfo.GetDeviceClass() == BaslerGigEDeviceClass) {
-                gigeDevices.push_back(deviceInfo);
-                qDebug() << "[BaslerCamera] This is a GigE device";
-                
-                // Check if this is our target camera (IP: 192.168.0.2)
-                try {
-                    QString deviceIP = QString::fromUtf8(deviceInfo.GetIpAddress().c_str());
-                    qDebug() << "[BaslerCamera] Found GigE device with IP:" << deviceIP;
-                    
-                    if (deviceIP == m_cameraIP) {
-                        targetDevice = deviceInfo;
-                        foundTargetCamera = true;
-                        qDebug() << "[BaslerCamera] Found target camera at IP" << m_cameraIP;
-                    }
-                }
-                catch (const GenericException& e) {
-                    qDebug() << "[BaslerCamera] Error getting device IP:" << e.GetDescription();
-                }
-            } else {
-                // Check if this device has an IP address (might be a different device class)
-                try {
-                    QString deviceIP = QString::fromUtf8(deviceInfo.GetIpAddress().c_str());
-                    if (!deviceIP.isEmpty()) {
-                        qDebug() << "[BaslerCamera] Found non-GigE device with IP:" << deviceIP;
-                        
-                        if (deviceIP == m_cameraIP) {
-                            targetDevice = deviceInfo;
-                            foundTargetCamera = true;
-                            qDebug() << "[BaslerCamera] Found target camera at IP" << m_cameraIP << "(non-GigE device)";
-                        }
-                    }
-                }
-                catch (const GenericException& e) {
-                    // IP address not available for this device type
-                }
-            }
-        }
-
-        if (gigeDevices.empty()) {
-            qDebug() << "[BaslerCamera] No GigE camera found!";
-            updateStatus("No camera found");
-            return false;
-        }
-
-        qDebug() << "[BaslerCamera] Found" << gigeDevices.size() << "GigE camera(s)";
-
-        if (!foundTargetCamera) {
-            qDebug() << "[BaslerCamera] Target camera (" << m_cameraIP << ") not found!";
-            updateStatus("Target camera not found");
-            return false;
-        }
-        
-        // Create camera object with specific device
-        m_camera = new CInstantCamera(tlFactory.CreateDevice(targetDevice));
-        
-        if (m_camera == nullptr) {
-            qDebug() << "[BaslerCamera] Failed to create camera object";
-            updateStatus("Failed to create camera object");
-            return false;
-        }
-        
-        qDebug() << "[BaslerCamera] Camera created successfully";
-        
-        // Get camera information
-        try {
-            CDeviceInfo deviceInfo = m_camera->GetDeviceInfo();
-            m_cameraName = QString::fromUtf8(deviceInfo.GetFriendlyName().c_str());
-            m_cameraModel = QString::fromUtf8(deviceInfo.GetModelName().c_str());
-            m_cameraSerial = QString::fromUtf8(deviceInfo.GetSerialNumber().c_str());
+        case SourcePlayback:
+            m_playbackSource = new PlaybackFrameSource(m_playbackPath);
+            m_playbackSource->setPacing(m_playbackPacing);
+            m_playbackSource->setLoop(m_playbackLoop);
+            m_playbackSource->setFrameRate(m_playbackFrameRate);
+            m_source = m_playbackSource;
+            break;
             
-            qDebug() << "[BaslerCamera] Camera Name:" << m_cameraName;
-            qDebug() << "[BaslerCamera] Camera Model:" << m_cameraModel;
-            qDebug() << "[BaslerCamera] Camera Serial:" << m_cameraSerial;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Error getting camera info:" << e.GetDescription();
+        case SourceEmulator:
+        case SourceGigE:
+        default: {
+            PylonFrameSource *pylonSource = new PylonFrameSource(
+                m_sourceType == SourceEmulator ? PylonFrameSource::DeviceEmulator : PylonFrameSource::DeviceGigE,
+                m_cameraIP);
+            pylonSource->setSerialNumber(m_deviceSerial);
+            m_source = pylonSource;
+            break;
         }
-        
-        // Open camera
-        m_camera->Open();
-        qDebug() << "[BaslerCamera] Camera opened successfully";
-        
-        // Update camera settings
-        updateCameraSettings();
-        
-        m_connected = true;
-        updateStatus("Camera connected successfully");
-        
-        return true;
     }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error connecting to camera:" << e.GetDescription();
-        updateStatus("Connection failed");
+    
+    QString error;
+    if (!m_source->open(error)) {
+        qDebug() << "[BaslerCamera] Error connecting to camera:" << error;
+        updateStatus(error);
         m_connected = false;
-        if (m_camera) {
-            delete m_camera;
-            m_camera = nullptr;
-        }
+        delete m_source;
+        m_source = nullptr;
+        m_syntheticSource = nullptr;
+        m_playbackSource = nullptr;
         return false;
     }
+    
+    // GenApi parameters are only available on Pylon-backed sources
+    m_camera = m_source->getCamera();
+    m_parameters->attach(m_camera);
+    
+    // Get camera information
+    m_cameraName = m_source->getName();
+    m_cameraModel = m_source->getModel();
+    m_cameraSerial = m_source->getSerial();
+    
+    // Update camera settings
+    updateCameraSettings();
+    
+    m_connected = true;
+    updateStatus("Camera connected successfully");
+    
+    return true;
 }
 
 void BaslerCamera::disconnect()
 {
     qDebug() << "[BaslerCamera] Disconnecting camera...";
     
-    stopGrabbing();
+    // Queued writes are dropped, a running one finishes before the camera goes away
+    m_controller->cancelPending();
+    m_controller->waitForIdle();
     
-    if (m_camera) {
-        try {
-            if (m_camera->IsOpen()) {
-                m_camera->Close();
-            }
-            delete m_camera;
-            m_camera = nullptr;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Error closing camera:" << e.GetDescription();
-        }
-    }
+    stopGrabbing();
+
+    // Release frames still referencing Pylon buffers before the camera goes away
+    m_recordingEnabled = false;
+    m_recorder->stop();
+    m_recorder->waitForFinished();
+    m_frameMailbox.clear();
+
+    m_parameters->detach();
+    if (m_source) {
+        emit sourceClosing();
+        m_source->close();
+        delete m_source;
+        m_source = nullptr;
+    }
+    m_syntheticSource = nullptr;
+    m_playbackSource = nullptr;
+    m_camera = nullptr;
     
     m_connected = false;
     updateStatus("Camera disconnected");
@@ -233,7 +201,9 @@ void BaslerCamera::disconnect()
 
 void BaslerCamera::startGrabbing()
 {
-    if (!m_camera || !m_camera->IsOpen()) {
+    std::lock_guard<std::mutex> lock(m_grabControlMutex);
+    
+    if (!m_source || !m_source->isOpen()) {
         qDebug() << "[BaslerCamera] Camera not open, cannot start grabbing";
         return;
     }
@@ -243,12 +213,13 @@ void BaslerCamera::startGrabbing()
         return;
     }
     
+    // Reset frame rate measurement before the grab thread records into it
+    resetFrameRateMeasurement();
+    
     try {
         m_grabFlag = true;
         m_grabThread = new std::thread(&BaslerCamera::grabLoop, this);
-        
-        // Reset frame rate measurement
-        resetFrameRateMeasurement();
+        updateStatisticsTimer();
         
         qDebug() << "[BaslerCamera] Grabbing started";
         updateStatus("Grabbing started");
@@ -262,12 +233,21 @@ void BaslerCamera::startGrabbing()
 
 void BaslerCamera::stopGrabbing()
 {
+    std::lock_guard<std::mutex> lock(m_grabControlMutex);
+    
     if (!m_grabFlag) {
         qDebug() << "[BaslerCamera] Not grabbing";
         return;
     }
     
-    m_grabFlag = false;
+    {
+        std::lock_guard<std::mutex> lock(m_grabWaitMutex);
+        m_grabFlag = false;
+    }
+    m_grabWait.notify_all();
+    
+    // Wake a retrieve that is still waiting for the next frame
+    m_source->interruptRetrieve();
     
     if (m_grabThread && m_grabThread->joinable()) {
         m_grabThread->join();
@@ -275,6 +255,8 @@ void BaslerCamera::stopGrabbing()
         m_grabThread = nullptr;
     }
     
+    updateStatisticsTimer();
+    
     qDebug() << "[BaslerCamera] Grabbing stopped";
     updateStatus("Grabbing stopped");
 }
@@ -283,102 +265,94 @@ void BaslerCamera::grabLoop()
 {
     qDebug() << "[BaslerCamera] Grab loop started";
     
+    // Before the grab buffers are allocated, so they land on the chosen node
+    m_appliedGrabThreadCore = -1;
+    m_grabThreadPolicyApplied = false;
+    applyGrabThreadPolicy();
+    
+    // Relate the camera clock to ours before the first frame arrives
+    m_frameTiming.start(m_source->getTimestampTickFrequency());
+    m_recorder->setTimestampTickFrequency(m_source->getTimestampTickFrequency());
+    m_preTrigger->setTimestampTickFrequency(m_source->getTimestampTickFrequency());
+    uint64_t latchTicks = 0;
+    int64_t latchHostNs = 0;
+    try {
+        if (m_source->latchTimestamp(latchTicks, latchHostNs) && m_source->getTimestampTickFrequency() > 0.0) {
+            const int64_t cameraNs = static_cast<int64_t>(
+                static_cast<long double>(latchTicks) * 1e9L / m_source->getTimestampTickFrequency());
+            m_frameTiming.setClockOffset(latchHostNs - cameraNs);
+        }
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[BaslerCamera] Error latching camera timestamp:" << e.GetDescription();
+    }
+    
     // Start continuous grabbing
+    bool eventDriven = false;
     try {
-        m_camera->StartGrabbing(GrabStrategy_OneByOne, GrabLoop_ProvidedByUser);
-        qDebug() << "[BaslerCamera] Continuous grabbing started";
+        IFrameSource::BufferConfig bufferConfig;
+        bufferConfig.count = m_grabBufferCount;
+        if (bufferConfig.count <= 0) {
+            // Frames waiting in the recorder queue keep their grab buffers, leave room for them
+            bufferConfig.count = DEFAULT_NUM_GRAB_BUFFERS + m_recorder->getQueueCapacity();
+        }
+        bufferConfig.size = m_grabBufferSize;
+        bufferConfig.hugePages = m_grabBufferHugePages;
+        bufferConfig.lockMemory = m_grabBufferLockMemory;
+        
+        IFrameSource::AcquisitionConfig acquisition;
+        acquisition.strategy = static_cast<IFrameSource::GrabStrategy>(m_grabStrategy.load());
+        acquisition.queueSize = m_grabQueueSize;
+        
+        if (m_eventDriven) {
+            eventDriven = m_source->startGrabbingEventDriven(bufferConfig, acquisition,
+                [this](IFrameSource::RetrieveStatus status, const FrameHandle &frame, const QString &error) {
+                    // Runs on the source's grab thread, exceptions must not reach it
+                    try {
+                        if (!m_grabThreadPolicyApplied.exchange(true)) {
+                            applyGrabThreadPolicy();
+                        }
+                        handleFrame(status, frame, error);
+                    }
+                    catch (const GenericException& e) {
+                        qDebug() << "[BaslerCamera] Error handling frame:" << e.GetDescription();
+                    }
+                });
+            if (!eventDriven) {
+                qDebug() << "[BaslerCamera] Event-driven acquisition not available, polling instead";
+            }
+        }
+        if (!eventDriven) {
+            m_source->startGrabbing(bufferConfig, acquisition);
+        }
+        m_eventDrivenActive = eventDriven;
+        qDebug() << "[BaslerCamera] Continuous grabbing started:" << IFrameSource::grabStrategyName(acquisition.strategy)
+                 << (eventDriven ? "event-driven" : "polling");
     }
     catch (const GenericException& e) {
         qDebug() << "[BaslerCamera] Error starting continuous grabbing:" << e.GetDescription();
         return;
     }
     
-    while (m_grabFlag) {
+    if (eventDriven) {
+        // Frames are handled by the callback, only wait for stopGrabbing()
+        std::unique_lock<std::mutex> lock(m_grabWaitMutex);
+        m_grabWait.wait(lock, [this]() { return !m_grabFlag; });
+    }
+    
+    while (!eventDriven && m_grabFlag) {
         try {
-            // Retrieve result with shorter timeout for continuous grabbing
-            if (m_camera->RetrieveResult(100, m_grabResult, TimeoutHandling_Return)) {
-                if (m_grabResult->GrabSucceeded()) {
-                    // Update current frame ID
-                    m_currentFrameId = m_grabResult->GetID();
-                    
-                    // Increment frame count immediately after successful grab
-                    {
-                        std::lock_guard<std::mutex> lock(m_frameRateMutex);
-                        m_frameCount++;
-                        
-                        // Start timer on first frame
-                        if (m_frameCount == 1) {
-                            m_frameRateTimer.start();
-                        }
-                    }
-                    
-                    qDebug() << "[BaslerCamera Grab] Frame ID:" << m_grabResult->GetID() << "Count:" << m_frameCount;
-
-                    // Convert image to OpenCV format
-                    cv::Mat image;
-                    convertBaslerImageToOpenCV(m_grabResult, image);
-
-                    // Update current image
-                    {
-                        std::lock_guard<std::mutex> lock(m_imageMutex);
-                        m_currentImage = image.clone();
-                    }
-                    
-                    // Save image if recording is enabled
-                    if (m_recordingEnabled && !image.empty()) {
-                        // Create directory if it doesn't exist
-                        QDir dir(m_recordingPath);
-                        if (!dir.exists()) {
-                            dir.mkpath(".");
-                        }
-                        
-                        // Generate filename with pattern_XX.bmp format
-                        QString filename = QString("%1/pattern_%2.bmp")
-                                         .arg(m_recordingPath)
-                                         .arg(m_recordedImageCount, 2, 10, QChar('0')); // 2 digits, zero-padded
-                        
-                        // Save image in original format (Mono8) for recording
-                        cv::Mat originalImage;
-                        if (m_grabResult->GetPixelType() == PixelType_Mono8) {
-                            // Create Mono8 image for saving
-                            const uint8_t* pImageBuffer = (uint8_t*)m_grabResult->GetBuffer();
-                            originalImage = cv::Mat(m_height, m_width, CV_8UC1, (void*)pImageBuffer);
-                        } else {
-                            // For other formats, use the converted image
-                            originalImage = image;
-                        }
-                        
-                        if (cv::imwrite(filename.toStdString(), originalImage)) {
-                            m_recordedImageCount++;
-                            qDebug() << "[BaslerCamera] Image saved:" << filename << "Total saved:" << m_recordedImageCount;
-                            
-                            // Check if max count reached and reset if needed
-                            if (m_recordedImageCount >= m_maxRecordedImages) {
-                                qDebug() << "[BaslerCamera] Max count reached (" << m_maxRecordedImages << "), resetting count to 0";
-                                m_recordedImageCount = 0;
-                            }
-                        } else {
-                            qDebug() << "[BaslerCamera] Failed to save image:" << filename;
-                        }
-                    }
-                    
-                    // Emit image updated signal
-                    emit imageUpdated();
-                    
-                    // Emit frame ID updated signal
-                    emit frameIdUpdated(m_currentFrameId);
-                    
-                    // Update real-time frame rate after image is processed and emitted
-                    updateRealTimeFrameRate();
-                } else {
-                    // Increment error count
-                    m_errorsCount++;
-                    emit errorsCountUpdated(m_errorsCount);
-                    
-                    qDebug() << "[BaslerCamera] Grab failed:" << m_grabResult->GetErrorDescription();
-                }
+            // Retrieve frame with shorter timeout for continuous grabbing
+            FrameHandle frame;
+            QString error;
+            qint64 retrieveStart = FrameHandle::currentTimestampNs();
+            IFrameSource::RetrieveStatus status = m_source->retrieveFrame(100, frame, error);
+            
+            if (status == IFrameSource::RetrieveOk) {
+                // The frame is timestamped when the source hands it over
+                m_latencyHistograms[LatencyRetrieve].record(frame.timestampNs() - retrieveStart);
             }
-            // Note: No else clause here as RetrieveResult returns false on timeout, which is normal
+            handleFrame(status, frame, error);
         }
         catch (const GenericException& e) {
             qDebug() << "[BaslerCamera] Error in grab loop:" << e.GetDescription();
@@ -388,7 +362,7 @@ void BaslerCamera::grabLoop()
     
     // Stop continuous grabbing
     try {
-        m_camera->StopGrabbing();
+        m_source->stopGrabbing();
         qDebug() << "[BaslerCamera] Continuous grabbing stopped";
     }
     catch (const GenericException& e) {
@@ -398,10 +372,70 @@ void BaslerCamera::grabLoop()
     qDebug() << "[BaslerCamera] Grab loop ended";
 }
 
+void BaslerCamera::applyGrabThreadPolicy()
+{
+    ThreadPolicy::Config config = getGrabThreadPolicy();
+    ThreadPolicy::Applied applied = ThreadPolicy::applyToCurrentThread(config);
+    
+    m_appliedGrabThreadCore = (applied.cores.size() == 1) ? applied.cores.first() : -1;
+    {
+        std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+        m_grabThreadPolicyReport = applied.description;
+    }
+    qDebug() << "[BaslerCamera] Grab thread policy:" << applied.description;
+}
+
+void BaslerCamera::handleFrame(IFrameSource::RetrieveStatus status, const FrameHandle &frame, const QString &error)
+{
+    if (status == IFrameSource::RetrieveOk) {
+        // Lock-free, the figures are derived on the statistics timer
+        m_currentFrameId = frame.frameId();
+        m_statistics.record(frame.timestampNs());
+        m_frameTiming.record(frame);
+        
+        // Publish as the current frame, never blocks on readers
+        qint64 publishStart = FrameHandle::currentTimestampNs();
+        m_frameMailbox.publish(frame);
+        
+        // Hand the frame to the recorder, disk I/O happens on its writer threads
+        if (m_recordingEnabled && !frame.isEmpty()) {
+            m_recorder->enqueue(frame);
+        }
+        // Copied into the pre-trigger ring, a no-op while it is disabled
+        m_preTrigger->push(frame);
+        m_latencyHistograms[LatencyPublish].record(FrameHandle::currentTimestampNs() - publishStart);
+        
+        // Emit image updated signal
+        emit imageUpdated();
+    } else if (status == IFrameSource::RetrieveFailed) {
+        // Increment error count
+        m_errorsCount++;
+        emit errorsCountUpdated(m_errorsCount);
+        
+        qDebug() << "[BaslerCamera] Grab failed:" << error;
+    }
+    // Note: RetrieveTimeout is normal and needs no handling
+}
+
+FrameHandle BaslerCamera::getFrame()
+{
+    FrameHandle frame;
+    m_frameMailbox.read(frame);
+    return frame;
+}
+
 cv::Mat BaslerCamera::getImage()
 {
-    std::lock_guard<std::mutex> lock(m_imageMutex);
-    return m_currentImage.clone();
+    FrameHandle frame = getFrame();
+    cv::Mat image = frame.toBGR8(m_recorder->getWhiteBalance());
+    
+    // A BGR8 frame comes back as a view into the grab buffer, copy it so the
+    // result stays valid after the handle is released
+    if (image.data == frame.image().data) {
+        image = image.clone();
+    }
+    
+    return image;
 }
 
 QString BaslerCamera::getCameraInfo() const
@@ -425,135 +459,115 @@ void BaslerCamera::updateStatus(const QString &status)
 
 void BaslerCamera::updateCameraSettings()
 {
+    // The synthetic source has no node map, report its own settings
+    if (m_syntheticSource) {
+        m_width = m_syntheticWidth;
+        m_height = m_syntheticHeight;
+        m_frameRateEnabled = m_syntheticFrameRateEnabled;
+        m_frameRate = m_syntheticFrameRate;
+        m_fps = m_frameRateEnabled ? m_frameRate : 0.0;
+        m_pixelFormat = QString::fromUtf8(CPixelTypeMapper::GetNameByPixelType(m_syntheticPixelType));
+        m_payloadSize = static_cast<qint64>(m_width) * m_height * BitPerPixel(m_syntheticPixelType) / 8;
+        m_linkThroughput = 0;
+        
+        updateStatus(QString("Settings: %1x%2 @ %3 FPS (synthetic)").arg(m_width).arg(m_height)
+                     .arg(m_frameRateEnabled ? QString::number(m_fps, 'f', 1) : QString("max")));
+        return;
+    }
+    
+    // Geometry and format of the recording, the frame rate paces recordings without timestamps
+    if (m_playbackSource) {
+        m_width = m_playbackSource->getWidth();
+        m_height = m_playbackSource->getHeight();
+        m_frameRateEnabled = (m_playbackSource->getPacing() == PlaybackFrameSource::PacingRealTime);
+        m_frameRate = m_playbackFrameRate;
+        m_fps = 0.0;
+        m_pixelFormat = QString::fromUtf8(CPixelTypeMapper::GetNameByPixelType(m_playbackSource->getPixelType()));
+        m_payloadSize = static_cast<qint64>(m_width) * m_height * BitPerPixel(m_playbackSource->getPixelType()) / 8;
+        m_linkThroughput = 0;
+        
+        updateStatus(QString("Settings: %1x%2, %3 frames (playback)").arg(m_width).arg(m_height)
+                     .arg(m_playbackSource->getFrameCount()));
+        return;
+    }
+    
     if (!m_camera || !m_camera->IsOpen()) {
         qDebug() << "[BaslerCamera] Camera not open, cannot get settings";
         return;
     }
     
-    try {
-        // Get width and height
-        CIntegerParameter widthParam(m_camera->GetNodeMap(), "Width");
-        CIntegerParameter heightParam(m_camera->GetNodeMap(), "Height");
-        
-        m_width = widthParam.GetValue();
-        m_height = heightParam.GetValue();
-        
-        qDebug() << "[BaslerCamera] Resolution:" << m_width << "x" << m_height;
-        
-        // Get FPS (AcquisitionFrameRate)
-        try {
-            CFloatParameter fpsParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-            m_fps = fpsParam.GetValue();
-            qDebug() << "[BaslerCamera] FPS:" << m_fps;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get FPS:" << e.GetDescription();
-            m_fps = 0.0;
-        }
-        
-        // Get scaling factor
-        try {
-            CFloatParameter scalingParam(m_camera->GetNodeMap(), "ScalingFactor");
-            m_scalingFactor = scalingParam.GetValue();
-            qDebug() << "[BaslerCamera] Scaling Factor:" << m_scalingFactor;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Scaling Factor:" << e.GetDescription();
-            m_scalingFactor = 1.0;
-        }
-        
-        // Get exposure time
-        try {
-            CFloatParameter exposureParam(m_camera->GetNodeMap(), "ExposureTime");
-            m_exposureTime = exposureParam.GetValue();
-            qDebug() << "[BaslerCamera] Exposure Time:" << m_exposureTime << "μs";
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Exposure Time:" << e.GetDescription();
-            m_exposureTime = 10000.0;
-        }
-        
-        // Get exposure auto
-        try {
-            CEnumParameter exposureAutoParam(m_camera->GetNodeMap(), "ExposureAuto");
-            m_exposureAuto = (exposureAutoParam.GetValue() == "Continuous");
-            qDebug() << "[BaslerCamera] Exposure Auto:" << (m_exposureAuto ? "On" : "Off");
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Exposure Auto:" << e.GetDescription();
-            m_exposureAuto = false;
-        }
-        
-        // Get frame rate enable
-        try {
-            CBooleanParameter frameRateEnableParam(m_camera->GetNodeMap(), "AcquisitionFrameRateEnable");
-            m_frameRateEnabled = frameRateEnableParam.GetValue();
-            qDebug() << "[BaslerCamera] Frame Rate Enable:" << (m_frameRateEnabled ? "On" : "Off");
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Frame Rate Enable:" << e.GetDescription();
-            m_frameRateEnabled = false;
-        }
-        
-        // Get frame rate
-        try {
-            CFloatParameter frameRateParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-            m_frameRate = frameRateParam.GetValue();
-            qDebug() << "[BaslerCamera] Frame Rate:" << m_frameRate << "fps";
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Frame Rate:" << e.GetDescription();
-            m_frameRate = 30.0;
-        }
-        
-        // Get trigger mode
-        try {
-            CEnumParameter triggerModeParam(m_camera->GetNodeMap(), "TriggerMode");
-            m_triggerMode = QString::fromUtf8(triggerModeParam.GetValue().c_str());
-            m_triggerEnabled = (m_triggerMode != "Off");
-            qDebug() << "[BaslerCamera] Trigger Mode:" << m_triggerMode;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Trigger Mode:" << e.GetDescription();
-            m_triggerMode = "Off";
-            m_triggerEnabled = false;
-        }
-        
-        // Get trigger source
-        try {
-            CEnumParameter triggerSourceParam(m_camera->GetNodeMap(), "TriggerSource");
-            m_triggerSource = QString::fromUtf8(triggerSourceParam.GetValue().c_str());
-            qDebug() << "[BaslerCamera] Trigger Source:" << m_triggerSource;
-        }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Trigger Source:" << e.GetDescription();
-            m_triggerSource = "Software";
+    // Served from the parameter model, nodes are only read after GenApi invalidated them
+    readSettingsFromModel();
+    
+    qDebug() << "[BaslerCamera] Settings:" << m_width << "x" << m_height << m_pixelFormat
+             << "exposure" << m_exposureTime << "frame rate" << m_frameRate
+             << "trigger" << m_triggerMode << m_triggerSource;
+    
+    updateStatus(QString("Settings: %1x%2 @ %3 FPS, Scale: %4, Exp: %5 μs, FR: %6, Trig: %7").arg(m_width).arg(m_height).arg(m_fps, 0, 'f', 1).arg(m_scalingFactor, 0, 'f', 2).arg(m_exposureTime, 0, 'f', 0).arg(m_frameRateEnabled ? "Fixed" : "Auto").arg(m_triggerEnabled ? m_triggerMode : "Off"));
+}
+
+void BaslerCamera::readSettingsFromModel()
+{
+    typedef CameraParameterModel Model;
+    
+    // Entries are read back on the control thread (writes, postReadBack()),
+    // here they normally come from the cache
+    m_width = static_cast<int>(m_parameters->value(Model::Width, 0.0));
+    m_height = static_cast<int>(m_parameters->value(Model::Height, 0.0));
+    m_fps = m_parameters->value(Model::AcquisitionFrameRate, 0.0);
+    m_scalingFactor = m_parameters->value(Model::ScalingFactor, 1.0);
+    m_exposureTime = m_parameters->value(Model::ExposureTime, 10000.0);
+    m_recorder->setExposureTime(m_exposureTime);
+    m_preTrigger->setExposureTime(m_exposureTime);
+    m_exposureAuto = (m_parameters->text(Model::ExposureAuto, "Off") == "Continuous");
+    m_frameRateEnabled = (m_parameters->value(Model::AcquisitionFrameRateEnable, 0.0) != 0.0);
+    m_frameRate = m_parameters->value(Model::AcquisitionFrameRate, 30.0);
+    m_pixelFormat = m_parameters->text(Model::PixelFormat, QString());
+    
+    // SFNC reports the link speed, older GigE models only the bandwidth limit
+    m_payloadSize = static_cast<qint64>(m_parameters->value(Model::PayloadSize, 0.0));
+    m_linkThroughput = static_cast<qint64>(m_parameters->value(Model::DeviceLinkSpeed, 0.0));
+    
+    m_triggerMode = m_parameters->text(Model::TriggerMode, "Off");
+    m_triggerEnabled = (m_triggerMode != "Off");
+    m_triggerSource = m_parameters->text(Model::TriggerSource, "Software");
+    m_triggerDelay = m_parameters->value(Model::TriggerDelay, 0.0);
+}
+
+void BaslerCamera::onParametersChanged(quint32 mask)
+{
+    Q_UNUSED(mask);
+    
+    // Changes that did not go through our setters, e.g. limits that depend on other nodes.
+    // Asynchronous writes read their settings back once they are finished.
+    if (!m_connected || !m_camera || m_syntheticSource || m_controller->isBusy()) {
+        return;
+    }
+    postReadBack(READ_BACK_KEY, false);
+}
+
+void BaslerCamera::postReadBack(const QString &key, bool exposureOnly)
+{
+    // Register access on the control thread, onControlCommandFinished() copies
+    // the cache. Coalesced by key, one read covers the changes posted meanwhile.
+    const bool exposureAuto = m_exposureAuto;
+    m_controller->post(key, [this, exposureOnly, exposureAuto](QString &error) {
+        if (!m_camera || !m_camera->IsOpen()) {
+            error = "Camera not open";
+            return false;
         }
         
-        // Get trigger delay
-        try {
-            CFloatParameter triggerDelayParam(m_camera->GetNodeMap(), "TriggerDelay");
-            m_triggerDelay = triggerDelayParam.GetValue();
-            qDebug() << "[BaslerCamera] Trigger Delay:" << m_triggerDelay << "μs";
+        // Auto exposure changes the value without GenApi noticing
+        if (exposureAuto || exposureOnly) {
+            m_parameters->markStale(CameraParameterModel::ExposureTime);
         }
-        catch (const GenericException& e) {
-            qDebug() << "[BaslerCamera] Could not get Trigger Delay:" << e.GetDescription();
-            m_triggerDelay = 0.0;
+        if (exposureOnly) {
+            m_parameters->get(CameraParameterModel::ExposureTime);
+        } else {
+            m_parameters->refresh();
         }
-        
-        updateStatus(QString("Settings: %1x%2 @ %3 FPS, Scale: %4, Exp: %5 μs, FR: %6, Trig: %7").arg(m_width).arg(m_height).arg(m_fps, 0, 'f', 1).arg(m_scalingFactor, 0, 'f', 2).arg(m_exposureTime, 0, 'f', 0).arg(m_frameRateEnabled ? "Fixed" : "Auto").arg(m_triggerEnabled ? m_triggerMode : "Off"));
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting camera settings:" << e.GetDescription();
-        m_width = 0;
-        m_height = 0;
-        m_fps = 0.0;
-        m_scalingFactor = 1.0;
-        m_exposureTime = 10000.0;
-        m_exposureAuto = false;
-        m_frameRateEnabled = false;
-        m_frameRate = 30.0;
-    }
+        return true;
+    });
 }
 
 int BaslerCamera::getWidth() const
@@ -577,7 +591,7 @@ QString BaslerCamera::getCurrentSettings() const
         return "Camera not connected";
     }
     
-    QString settings = QString("Resolution: %1 x %2\nFPS: %3\nScaling Factor: %4\nExposure: %5 μs (%6)\nFrame Rate: %7 (%8)")
+    QString settings = QString("Resolution: %1 x %2\nFPS: %3\nScaling Factor: %4\nExposure: %5 μs (%6)\nFrame Rate: %7 (%8)\nPixel Format: %9")
                        .arg(m_width)
                        .arg(m_height)
                        .arg(m_fps, 0, 'f', 1)
@@ -585,13 +599,28 @@ QString BaslerCamera::getCurrentSettings() const
                        .arg(m_exposureTime, 0, 'f', 0)
                        .arg(m_exposureAuto ? "Auto" : "Manual")
                        .arg(m_frameRate, 0, 'f', 1)
-                       .arg(m_frameRateEnabled ? "Fixed" : "Auto");
+                       .arg(m_frameRateEnabled ? "Fixed" : "Auto")
+                       .arg(m_pixelFormat);
+    
+    settings += QString("\nAcquisition: %1 (%2)")
+                .arg(IFrameSource::grabStrategyName(getGrabStrategy()))
+                .arg(!m_grabFlag ? "idle" : (m_eventDrivenActive ? "event-driven" : "polling"));
+    
+    if (m_parameters->isAttached()) {
+        settings += QString("\nParameter cache: %1 node reads since connect").arg(m_parameters->getNodeReadCount());
+    }
     
     return settings;
 } 
 
 bool BaslerCamera::setResolution(int width, int height)
 {
+    if (m_syntheticSource) {
+        m_syntheticWidth = width;
+        m_syntheticHeight = height;
+        return applySyntheticSettings(QString("Resolution changed to: %1x%2").arg(width).arg(height));
+    }
+    
     if (!m_camera || !m_camera->IsOpen()) {
         qDebug() << "[BaslerCamera] Camera not open, cannot set resolution";
         return false;
@@ -605,13 +634,9 @@ bool BaslerCamera::setResolution(int width, int height)
             wasGrabbing = true;
         }
         
-        // Set width
-        CIntegerParameter widthParam(m_camera->GetNodeMap(), "Width");
-        widthParam.SetValue(width);
-        
-        // Set height
-        CIntegerParameter heightParam(m_camera->GetNodeMap(), "Height");
-        heightParam.SetValue(height);
+        // Set width and height
+        m_parameters->setValue(CameraParameterModel::Width, width);
+        m_parameters->setValue(CameraParameterModel::Height, height);
         
         // Update stored values
         m_width = width;
@@ -645,144 +670,206 @@ QStringList BaslerCamera::getAvailableResolutions() const
         return resolutions;
     }
     
-    try {
-        // Get width range
-        CIntegerParameter widthParam(m_camera->GetNodeMap(), "Width");
-        int64_t widthMin = widthParam.GetMin();
-        int64_t widthMax = widthParam.GetMax();
-        int64_t widthInc = widthParam.GetInc();
-        
-        // Get height range
-        CIntegerParameter heightParam(m_camera->GetNodeMap(), "Height");
-        int64_t heightMin = heightParam.GetMin();
-        int64_t heightMax = heightParam.GetMax();
-        int64_t heightInc = heightParam.GetInc();
-        
-        // Add some common resolutions within the range
-        QList<QPair<int, int>> commonResolutions = {
-            {1920, 1200}
-        };
-        
-        for (const auto& res : commonResolutions) {
-            int w = res.first;
-            int h = res.second;
-            
-            // Check if resolution is within camera's supported range
-            if (w >= widthMin && w <= widthMax && h >= heightMin && h <= heightMax) {
-                // Check if resolution is aligned with increment
-                if ((w - widthMin) % widthInc == 0 && (h - heightMin) % heightInc == 0) {
-                    resolutions.append(QString("%1 x %2").arg(w).arg(h));
-                }
+    CameraParameterModel::Entry widthEntry = m_parameters->get(CameraParameterModel::Width);
+    CameraParameterModel::Entry heightEntry = m_parameters->get(CameraParameterModel::Height);
+    if (!widthEntry.readable || !heightEntry.readable) {
+        return resolutions;
+    }
+    
+    // Get width range
+    int64_t widthMin = static_cast<int64_t>(widthEntry.min);
+    int64_t widthMax = static_cast<int64_t>(widthEntry.max);
+    int64_t widthInc = qMax<int64_t>(1, static_cast<int64_t>(widthEntry.inc));
+    
+    // Get height range
+    int64_t heightMin = static_cast<int64_t>(heightEntry.min);
+    int64_t heightMax = static_cast<int64_t>(heightEntry.max);
+    int64_t heightInc = qMax<int64_t>(1, static_cast<int64_t>(heightEntry.inc));
+    
+    // Add some common resolutions within the range
+    QList<QPair<int, int>> commonResolutions = {
+        {1920, 1200}
+    };
+    
+    for (const auto& res : commonResolutions) {
+        int w = res.first;
+        int h = res.second;
+        
+        // Check if resolution is within camera's supported range
+        if (w >= widthMin && w <= widthMax && h >= heightMin && h <= heightMax) {
+            // Check if resolution is aligned with increment
+            if ((w - widthMin) % widthInc == 0 && (h - heightMin) % heightInc == 0) {
+                resolutions.append(QString("%1 x %2").arg(w).arg(h));
             }
         }
-        
-        // Add current resolution if not in list
-        QString currentRes = QString("%1 x %2").arg(m_width).arg(m_height);
-        if (!resolutions.contains(currentRes)) {
-            resolutions.prepend(currentRes + " (Current)");
-        }
-        
     }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting available resolutions:" << e.GetDescription();
+    
+    // Add current resolution if not in list
+    QString currentRes = QString("%1 x %2").arg(m_width).arg(m_height);
+    if (!resolutions.contains(currentRes)) {
+        resolutions.prepend(currentRes + " (Current)");
     }
     
     return resolutions;
 } 
 
-double BaslerCamera::getScalingFactor() const
+QString BaslerCamera::getPixelFormat() const
 {
-    return m_scalingFactor;
+    return m_pixelFormat;
 }
 
-bool BaslerCamera::setScalingFactor(double factor)
+bool BaslerCamera::setPixelFormat(const QString &format)
 {
+    if (m_syntheticSource) {
+        return setSyntheticPixelType(CPixelTypeMapper::GetPylonPixelTypeByName(format.toUtf8().constData()));
+    }
+    
     if (!m_camera || !m_camera->IsOpen()) {
-        qDebug() << "[BaslerCamera] Camera not open, cannot set scaling factor";
+        qDebug() << "[BaslerCamera] Camera not open, cannot set pixel format";
+        return false;
+    }
+    
+    if (!FrameHandle::isSupportedPixelType(CPixelTypeMapper::GetPylonPixelTypeByName(format.toUtf8().constData()))) {
+        qDebug() << "[BaslerCamera] Pixel format not supported by the pipeline:" << format;
+        updateStatus("Unsupported pixel format: " + format);
         return false;
     }
     
     try {
-        // Stop grabbing if active
-        bool wasGrabbing = false;
-        if (m_grabFlag) {
+        // PixelFormat is locked while grabbing
+        bool wasGrabbing = m_grabFlag.load();
+        if (wasGrabbing) {
             stopGrabbing();
-            wasGrabbing = true;
         }
         
-        // Set scaling factor
-        CFloatParameter scalingParam(m_camera->GetNodeMap(), "ScalingFactor");
-        scalingParam.SetValue(factor);
+        m_parameters->setText(CameraParameterModel::PixelFormat, format);
         
-        // Update stored value
-        m_scalingFactor = factor;
+        m_pixelFormat = format;
+        qDebug() << "[BaslerCamera] Pixel format set to:" << format;
         
-        qDebug() << "[BaslerCamera] Scaling factor set to:" << m_scalingFactor;
+        // Payload size and buffer size depend on the format
+        updateCameraSettings();
         
-        // Restart grabbing if it was active
         if (wasGrabbing) {
             startGrabbing();
         }
         
-        // Emit settings changed signal
         emit settingsChanged();
         
-        updateStatus(QString("Scaling factor changed to: %1").arg(factor, 0, 'f', 2));
+        updateStatus("Pixel format changed to: " + format);
         return true;
     }
     catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error setting scaling factor:" << e.GetDescription();
-        updateStatus("Failed to set scaling factor");
+        qDebug() << "[BaslerCamera] Error setting pixel format:" << e.GetDescription();
+        updateStatus("Failed to set pixel format");
         return false;
     }
 }
 
-double BaslerCamera::getMinScalingFactor() const
+QStringList BaslerCamera::getAvailablePixelFormats() const
 {
+    QStringList formats;
+    
     if (!m_camera || !m_camera->IsOpen()) {
-        return 1.0;
+        return formats;
     }
     
-    try {
-        CFloatParameter scalingParam(m_camera->GetNodeMap(), "ScalingFactor");
-        return scalingParam.GetMin();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting min scaling factor:" << e.GetDescription();
-        return 1.0;
+    // Only offer what the camera accepts right now and the pipeline can handle
+    for (const QString &name : m_parameters->get(CameraParameterModel::PixelFormat).entries) {
+        if (FrameHandle::isSupportedPixelType(CPixelTypeMapper::GetPylonPixelTypeByName(name.toUtf8().constData()))) {
+            formats.append(name);
+        }
     }
+    
+    return formats;
 }
 
-double BaslerCamera::getMaxScalingFactor() const
+QString BaslerCamera::getBandwidthInfo() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1.0;
+    if (!m_connected || m_payloadSize <= 0) {
+        return "Not available";
     }
     
-    try {
-        CFloatParameter scalingParam(m_camera->GetNodeMap(), "ScalingFactor");
-        return scalingParam.GetMax();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting max scaling factor:" << e.GetDescription();
-        return 1.0;
+    // Throughput at the measured frame rate, and the rate the link could carry
+    double payloadMB = m_payloadSize / 1e6;
+    double frameRate = getRealTimeFrameRate();
+    QString info = QString("%1 %2 MB/frame, %3 MB/s @ %4 fps")
+                   .arg(m_pixelFormat)
+                   .arg(payloadMB, 0, 'f', 2)
+                   .arg(payloadMB * frameRate, 0, 'f', 1)
+                   .arg(frameRate, 0, 'f', 1);
+    
+    if (m_linkThroughput > 0) {
+        info += QString("\nLink %1 MB/s, max %2 fps")
+                .arg(m_linkThroughput / 1e6, 0, 'f', 0)
+                .arg(static_cast<double>(m_linkThroughput) / m_payloadSize, 0, 'f', 1);
     }
+    
+    return info;
 }
 
-double BaslerCamera::getScalingFactorIncrement() const
+double BaslerCamera::getScalingFactor() const
+{
+    return m_scalingFactor;
+}
+
+bool BaslerCamera::setScalingFactor(double factor)
 {
     if (!m_camera || !m_camera->IsOpen()) {
-        return 0.1;
+        qDebug() << "[BaslerCamera] Camera not open, cannot set scaling factor";
+        return false;
     }
     
     try {
-        CFloatParameter scalingParam(m_camera->GetNodeMap(), "ScalingFactor");
-        return scalingParam.GetInc();
+        // Stop grabbing if active
+        bool wasGrabbing = false;
+        if (m_grabFlag) {
+            stopGrabbing();
+            wasGrabbing = true;
+        }
+        
+        // Set scaling factor
+        m_parameters->setValue(CameraParameterModel::ScalingFactor, factor);
+        
+        // Update stored value
+        m_scalingFactor = factor;
+        
+        qDebug() << "[BaslerCamera] Scaling factor set to:" << m_scalingFactor;
+        
+        // Restart grabbing if it was active
+        if (wasGrabbing) {
+            startGrabbing();
+        }
+        
+        // Emit settings changed signal
+        emit settingsChanged();
+        
+        updateStatus(QString("Scaling factor changed to: %1").arg(factor, 0, 'f', 2));
+        return true;
     }
     catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting scaling factor increment:" << e.GetDescription();
-        return 0.1;
+        qDebug() << "[BaslerCamera] Error setting scaling factor:" << e.GetDescription();
+        updateStatus("Failed to set scaling factor");
+        return false;
     }
+}
+
+double BaslerCamera::getMinScalingFactor() const
+{
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ScalingFactor);
+    return entry.readable ? entry.min : 1.0;
+}
+
+double BaslerCamera::getMaxScalingFactor() const
+{
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ScalingFactor);
+    return entry.readable ? entry.max : 1.0;
+}
+
+double BaslerCamera::getScalingFactorIncrement() const
+{
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ScalingFactor);
+    return entry.readable ? entry.inc : 0.1;
 } 
 
 double BaslerCamera::getExposureTime() const
@@ -806,8 +893,7 @@ bool BaslerCamera::setExposureTime(double exposureTime)
         }
         
         // Set exposure time
-        CFloatParameter exposureParam(m_camera->GetNodeMap(), "ExposureTime");
-        exposureParam.SetValue(exposureTime);
+        m_parameters->setValue(CameraParameterModel::ExposureTime, exposureTime);
         
         // Update stored value
         m_exposureTime = exposureTime;
@@ -834,50 +920,20 @@ bool BaslerCamera::setExposureTime(double exposureTime)
 
 double BaslerCamera::getMinExposureTime() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1000.0;
-    }
-    
-    try {
-        CFloatParameter exposureParam(m_camera->GetNodeMap(), "ExposureTime");
-        return exposureParam.GetMin();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting min exposure time:" << e.GetDescription();
-        return 1000.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ExposureTime);
+    return entry.readable ? entry.min : 1000.0;
 }
 
 double BaslerCamera::getMaxExposureTime() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1000000.0;
-    }
-    
-    try {
-        CFloatParameter exposureParam(m_camera->GetNodeMap(), "ExposureTime");
-        return exposureParam.GetMax();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting max exposure time:" << e.GetDescription();
-        return 1000000.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ExposureTime);
+    return entry.readable ? entry.max : 1000000.0;
 }
 
 double BaslerCamera::getExposureTimeIncrement() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 100.0;
-    }
-    
-    try {
-        CFloatParameter exposureParam(m_camera->GetNodeMap(), "ExposureTime");
-        return exposureParam.GetInc();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting exposure time increment:" << e.GetDescription();
-        return 100.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::ExposureTime);
+    return entry.readable ? entry.inc : 100.0;
 }
 
 bool BaslerCamera::isExposureAuto() const
@@ -901,8 +957,7 @@ bool BaslerCamera::setExposureAuto(bool enable)
         }
         
         // Set exposure auto
-        CEnumParameter exposureAutoParam(m_camera->GetNodeMap(), "ExposureAuto");
-        exposureAutoParam.SetValue(enable ? "Continuous" : "Off");
+        m_parameters->setText(CameraParameterModel::ExposureAuto, enable ? "Continuous" : "Off");
         
         // Update stored value
         m_exposureAuto = enable;
@@ -934,6 +989,12 @@ bool BaslerCamera::isFrameRateEnabled() const
 
 bool BaslerCamera::setFrameRateEnabled(bool enable)
 {
+    // Without a fixed frame rate the synthetic source runs as fast as possible
+    if (m_syntheticSource) {
+        m_syntheticFrameRateEnabled = enable;
+        return applySyntheticSettings(QString("Frame rate %1").arg(enable ? "fixed" : "unlimited"));
+    }
+    
     if (!m_camera || !m_camera->IsOpen()) {
         qDebug() << "[BaslerCamera] Camera not open, cannot set frame rate enable";
         return false;
@@ -948,8 +1009,7 @@ bool BaslerCamera::setFrameRateEnabled(bool enable)
         }
         
         // Set frame rate enable
-        CBooleanParameter frameRateEnableParam(m_camera->GetNodeMap(), "AcquisitionFrameRateEnable");
-        frameRateEnableParam.SetValue(enable);
+        m_parameters->setValue(CameraParameterModel::AcquisitionFrameRateEnable, enable ? 1.0 : 0.0);
         
         // Update stored value
         m_frameRateEnabled = enable;
@@ -981,6 +1041,19 @@ double BaslerCamera::getFrameRate() const
 
 bool BaslerCamera::setFrameRate(double frameRate)
 {
+    if (m_playbackSource) {
+        m_playbackFrameRate = frameRate;
+        m_playbackSource->setFrameRate(frameRate);
+        updateCameraSettings();
+        emit settingsChanged();
+        return true;
+    }
+    
+    if (m_syntheticSource) {
+        m_syntheticFrameRate = frameRate;
+        return applySyntheticSettings(QString("Frame rate changed to: %1 fps").arg(frameRate, 0, 'f', 1));
+    }
+    
     if (!m_camera || !m_camera->IsOpen()) {
         qDebug() << "[BaslerCamera] Camera not open, cannot set frame rate";
         return false;
@@ -995,8 +1068,7 @@ bool BaslerCamera::setFrameRate(double frameRate)
         }
         
         // Set frame rate
-        CFloatParameter frameRateParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-        frameRateParam.SetValue(frameRate);
+        m_parameters->setValue(CameraParameterModel::AcquisitionFrameRate, frameRate);
         
         // Update stored value
         m_frameRate = frameRate;
@@ -1023,136 +1095,237 @@ bool BaslerCamera::setFrameRate(double frameRate)
 
 double BaslerCamera::getMinFrameRate() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1.0;
-    }
-    
-    try {
-        CFloatParameter frameRateParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-        return frameRateParam.GetMin();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting min frame rate:" << e.GetDescription();
-        return 1.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::AcquisitionFrameRate);
+    return entry.readable ? entry.min : 1.0;
 }
 
 double BaslerCamera::getMaxFrameRate() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 100.0;
-    }
-    
-    try {
-        CFloatParameter frameRateParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-        return frameRateParam.GetMax();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting max frame rate:" << e.GetDescription();
-        return 100.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::AcquisitionFrameRate);
+    return entry.readable ? entry.max : 100.0;
 }
 
 double BaslerCamera::getFrameRateIncrement() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 0.1;
-    }
-    
-    try {
-        CFloatParameter frameRateParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-        return frameRateParam.GetInc();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting frame rate increment:" << e.GetDescription();
-        return 0.1;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::AcquisitionFrameRate);
+    return entry.readable ? entry.inc : 0.1;
 } 
 
-void BaslerCamera::updateRealTimeFrameRate()
+void BaslerCamera::publishStatistics()
 {
-    std::lock_guard<std::mutex> lock(m_frameRateMutex);
-    
-    // Get current time
-    qint64 currentTime = m_lastFrameTimer.nsecsElapsed();
-    double currentTimeMs = currentTime / 1000000.0; // Convert to milliseconds
-    
-    // Start timer on first frame
-    if (m_frameCount == 1) {
-        m_lastFrameTimer.start();
-        m_lastFrameTime = currentTimeMs;
-        return;
+    // Runs on the GUI thread, off the grab path
+    FrameStatistics::Snapshot snapshot = m_statistics.snapshot();
+    if (snapshot.windowSize > 0) {
+        m_realTimeFrameRate = snapshot.windowFps;
     }
     
-    // Calculate frame interval
-    double frameInterval = currentTimeMs - m_lastFrameTime;
-    m_lastFrameTime = currentTimeMs;
+    emit frameRateUpdated(m_realTimeFrameRate);
+    emit frameIdUpdated(m_currentFrameId);
     
-    // Add interval to our moving average buffer
-    m_frameIntervals.append(frameInterval);
-    
-    // Keep only the last MAX_INTERVALS intervals
-    if (m_frameIntervals.size() > MAX_INTERVALS) {
-        m_frameIntervals.removeFirst();
+    // Follow auto exposure, unless a write is about to read it back anyway
+    if (m_exposureAuto && m_connected && m_camera && !m_syntheticSource && !m_controller->isBusy()) {
+        postReadBack(AUTO_EXPOSURE_KEY, true);
     }
-    
-    // Calculate average frame interval
-    double avgInterval = 0.0;
-    if (!m_frameIntervals.isEmpty()) {
-        for (double interval : m_frameIntervals) {
-            avgInterval += interval;
+}
+
+void BaslerCamera::updateStatisticsTimer()
+{
+    // The timer lives on the GUI thread, grabbing is also restarted from the control thread
+    QMetaObject::invokeMethod(m_statisticsTimer, [this]() {
+        if (m_grabFlag) {
+            m_statisticsTimer->start();
+        } else {
+            // Final figures of the session
+            m_statisticsTimer->stop();
+            publishStatistics();
         }
-        avgInterval /= m_frameIntervals.size();
+    });
+}
+
+// Grab buffer pool settings
+void BaslerCamera::setGrabBufferCount(int count)
+{
+    m_grabBufferCount = qMax(0, count);
+    qDebug() << "[BaslerCamera] Grab buffer count set to:" << count << "(0 = auto)";
+}
+
+int BaslerCamera::getGrabBufferCount() const
+{
+    return m_grabBufferCount;
+}
+
+void BaslerCamera::setGrabBufferSize(size_t size)
+{
+    m_grabBufferSize = size;
+    qDebug() << "[BaslerCamera] Grab buffer size set to:" << size << "(0 = auto)";
+}
+
+size_t BaslerCamera::getGrabBufferSize() const
+{
+    return m_grabBufferSize;
+}
+
+void BaslerCamera::setGrabBufferHugePages(bool enable)
+{
+    m_grabBufferHugePages = enable;
+    qDebug() << "[BaslerCamera] Grab buffer hugepages:" << enable;
+}
+
+bool BaslerCamera::getGrabBufferHugePages() const
+{
+    return m_grabBufferHugePages;
+}
+
+void BaslerCamera::setGrabBufferLockMemory(bool enable)
+{
+    m_grabBufferLockMemory = enable;
+    qDebug() << "[BaslerCamera] Grab buffer mlock:" << enable;
+}
+
+bool BaslerCamera::getGrabBufferLockMemory() const
+{
+    return m_grabBufferLockMemory;
+}
+
+QString BaslerCamera::getGrabBufferInfo() const
+{
+    if (!m_source) {
+        return "Not connected";
     }
     
-    // Calculate frame rate from average interval
-    if (avgInterval > 0) {
-        m_realTimeFrameRate = 1000.0 / avgInterval; // Convert to fps
+    QString info = m_source->getBufferInfo();
+    return info.isEmpty() ? QString("Not used by this source") : info;
+}
+
+bool BaslerCamera::setAcquisitionMode(IFrameSource::GrabStrategy strategy, int queueSize, bool eventDriven)
+{
+    if (!m_source || !m_source->isOpen()) {
+        qDebug() << "[BaslerCamera] Camera not open, cannot set acquisition mode";
+        return false;
     }
     
-    // Get camera's configured frame rate for comparison
-    double configuredFrameRate = 0.0;
-    try {
-        if (m_camera && m_camera->IsOpen()) {
-            CFloatParameter fpsParam(m_camera->GetNodeMap(), "AcquisitionFrameRate");
-            configuredFrameRate = fpsParam.GetValue();
-        }
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting configured frame rate:" << e.GetDescription();
+    // Stop grabbing if active, the mode is applied when grabbing starts
+    bool wasGrabbing = false;
+    if (m_grabFlag) {
+        stopGrabbing();
+        wasGrabbing = true;
     }
     
-    // Emit frame rate updated signal every few frames
-    if (m_frameCount % 3 == 0) { // Update every 3 frames for more responsive UI
-        emit frameRateUpdated(m_realTimeFrameRate);
-        
-        qDebug() << "[BaslerCamera] Real-time frame rate:" << m_realTimeFrameRate 
-                 << "fps (configured:" << configuredFrameRate 
-                 << "fps, avg interval:" << avgInterval << "ms, current interval:" << frameInterval << "ms)";
+    m_grabStrategy = strategy;
+    m_grabQueueSize = qMax(1, queueSize);
+    m_eventDriven = eventDriven;
+    
+    qDebug() << "[BaslerCamera] Acquisition mode set to:" << IFrameSource::grabStrategyName(strategy)
+             << "queue" << m_grabQueueSize << (eventDriven ? "event-driven" : "polling");
+    
+    // Restart grabbing if it was active
+    if (wasGrabbing) {
+        startGrabbing();
     }
+    
+    // Emit settings changed signal
+    emit settingsChanged();
+    
+    updateStatus(QString("Acquisition mode set to %1").arg(IFrameSource::grabStrategyName(strategy)));
+    return true;
+}
+
+IFrameSource::GrabStrategy BaslerCamera::getGrabStrategy() const
+{
+    return static_cast<IFrameSource::GrabStrategy>(m_grabStrategy.load());
+}
+
+int BaslerCamera::getGrabQueueSize() const
+{
+    return m_grabQueueSize;
+}
+
+bool BaslerCamera::isEventDrivenAcquisition() const
+{
+    return m_eventDriven;
+}
+
+bool BaslerCamera::isEventDrivenActive() const
+{
+    return m_eventDrivenActive;
+}
+
+quint64 BaslerCamera::getSkippedFrameCount() const
+{
+    return m_source ? m_source->getSkippedFrameCount() : 0;
 }
 
 double BaslerCamera::getRealTimeFrameRate() const
 {
-    std::lock_guard<std::mutex> lock(m_frameRateMutex);
     return m_realTimeFrameRate;
 }
 
+FrameStatistics::Snapshot BaslerCamera::getFrameStatistics() const
+{
+    return m_statistics.snapshot();
+}
+
+void BaslerCamera::setStatisticsWindowSize(int intervals)
+{
+    m_statistics.setWindowSize(intervals);
+}
+
+int BaslerCamera::getStatisticsWindowSize() const
+{
+    return m_statistics.getWindowSize();
+}
+
+FrameTimingMonitor::Snapshot BaslerCamera::getFrameTiming() const
+{
+    return m_frameTiming.snapshot();
+}
+
+quint64 BaslerCamera::getMissingFrameCount() const
+{
+    return m_frameTiming.missingFrameCount();
+}
+
+bool BaslerCamera::dumpFrameTiming(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "[BaslerCamera] Cannot open frame timing dump file:" << filePath;
+        return false;
+    }
+    
+    FrameTimingMonitor::Snapshot timing = m_frameTiming.snapshot();
+    QTextStream out(&file);
+    out << "# Frame timing of the newest frames, times in nanoseconds\n";
+    out << "# Written " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    out << "# Frames " << timing.frameCount << ", missing " << timing.missingFrames
+        << ", skipped " << timing.skippedFrames << ", block ID resets " << timing.blockIdResets
+        << ", latency " << (timing.latencyAbsolute ? "absolute" : "relative to the fastest frame") << "\n";
+    out << "block_id,host_ns,camera_ns,sensor_interval_ns,latency_ns,missing_before,skipped_before\n";
+    
+    for (const FrameTimingMonitor::Sample &sample : m_frameTiming.samples()) {
+        out << sample.blockId << ',' << sample.hostNs << ',' << sample.cameraNs << ','
+            << sample.sensorIntervalNs << ',' << sample.latencyNs << ','
+            << sample.missingBefore << ',' << sample.skippedBefore << "\n";
+    }
+    
+    qDebug() << "[BaslerCamera] Frame timing written to:" << filePath;
+    return true;
+}
+
 int BaslerCamera::getFrameCount() const
 {
-    std::lock_guard<std::mutex> lock(m_frameRateMutex);
-    return m_frameCount;
+    return static_cast<int>(m_statistics.frameCount());
 }
 
 void BaslerCamera::resetFrameRateMeasurement()
 {
-    std::lock_guard<std::mutex> lock(m_frameRateMutex);
-    m_frameCount = 0;
+    // Only while not grabbing, the grab thread is the statistics' single producer
+    if (m_grabFlag) {
+        return;
+    }
+    m_statistics.reset();
     m_realTimeFrameRate = 0.0;
-    m_lastFrameTime = 0.0;
-    m_frameIntervals.clear();
-    m_frameRateTimer.invalidate();
-    m_lastFrameTimer.invalidate();
+    m_frameMailbox.resetCounters();
 }
 
 int BaslerCamera::getCurrentFrameId() const
@@ -1165,57 +1338,10 @@ int BaslerCamera::getErrorsCount() const
     return m_errorsCount;
 }
 
-void BaslerCamera::convertBaslerImageToOpenCV(const CGrabResultPtr& grabResult, cv::Mat& image)
+quint64 BaslerCamera::getOverwrittenFrameCount() const
 {
-    if (!grabResult->GrabSucceeded()) {
-        image = cv::Mat();
-        return;
-    }
-    
-    // Get image buffer and properties
-    const uint8_t* pImageBuffer = (uint8_t*)grabResult->GetBuffer();
-    int width = grabResult->GetWidth();
-    int height = grabResult->GetHeight();
-
-    if (width <= 0 || height <= 0 || pImageBuffer == nullptr) {
-        image = cv::Mat();
-        return;
-    }
-    
-    // Handle different pixel formats
-    EPixelType pixelType = grabResult->GetPixelType();
-    
-    switch (pixelType) {
-        case PixelType_Mono8:
-            image = cv::Mat(height, width, CV_8UC1, (void*)pImageBuffer);
-            cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
-            break;
-            
-        case PixelType_RGB8packed:
-            image = cv::Mat(height, width, CV_8UC3, (void*)pImageBuffer);
-            cv::cvtColor(image, image, cv::COLOR_RGB2BGR);
-            break;
-            
-        case PixelType_BGR8packed:
-            image = cv::Mat(height, width, CV_8UC3, (void*)pImageBuffer);
-            break;
-            
-        case PixelType_Mono12:
-        case PixelType_Mono16:
-            // Convert to 8-bit for display
-            image = cv::Mat(height, width, CV_16UC1, (void*)pImageBuffer);
-            image.convertTo(image, CV_8UC1, 255.0 / 65535.0);
-            cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
-            break;
-            
-        default:
-            qDebug() << "[BaslerCamera] Unsupported pixel format:" << pixelType;
-            // Try to handle as RGB8
-            image = cv::Mat(height, width, CV_8UC3, (void*)pImageBuffer);
-            cv::cvtColor(image, image, cv::COLOR_RGB2BGR);
-            break;
-    }
-} 
+    return m_frameMailbox.overwrittenCount();
+}
 
 // Trigger control methods
 bool BaslerCamera::isTriggerEnabled() const
@@ -1237,8 +1363,7 @@ bool BaslerCamera::setTriggerEnabled(bool enable)
             stopGrabbing();
         }
         
-        CEnumParameter triggerModeParam(m_camera->GetNodeMap(), "TriggerMode");
-        triggerModeParam.SetValue(enable ? "On" : "Off");
+        m_parameters->setText(CameraParameterModel::TriggerMode, enable ? "On" : "Off");
         
         m_triggerEnabled = enable;
         m_triggerMode = enable ? "On" : "Off";
@@ -1278,8 +1403,7 @@ bool BaslerCamera::setTriggerMode(const QString &mode)
             stopGrabbing();
         }
         
-        CEnumParameter triggerModeParam(m_camera->GetNodeMap(), "TriggerMode");
-        triggerModeParam.SetValue(mode.toUtf8().constData());
+        m_parameters->setText(CameraParameterModel::TriggerMode, mode);
         
         m_triggerMode = mode;
         m_triggerEnabled = (mode != "Off");
@@ -1326,8 +1450,7 @@ bool BaslerCamera::setTriggerSource(const QString &source)
             stopGrabbing();
         }
         
-        CEnumParameter triggerSourceParam(m_camera->GetNodeMap(), "TriggerSource");
-        triggerSourceParam.SetValue(source.toUtf8().constData());
+        m_parameters->setText(CameraParameterModel::TriggerSource, source);
         
         m_triggerSource = source;
         
@@ -1373,8 +1496,7 @@ bool BaslerCamera::setTriggerDelay(double delay)
             stopGrabbing();
         }
         
-        CFloatParameter triggerDelayParam(m_camera->GetNodeMap(), "TriggerDelay");
-        triggerDelayParam.SetValue(delay);
+        m_parameters->setValue(CameraParameterModel::TriggerDelay, delay);
         
         m_triggerDelay = delay;
         
@@ -1396,50 +1518,20 @@ bool BaslerCamera::setTriggerDelay(double delay)
 
 double BaslerCamera::getMinTriggerDelay() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 0.0;
-    }
-    
-    try {
-        CFloatParameter triggerDelayParam(m_camera->GetNodeMap(), "TriggerDelay");
-        return triggerDelayParam.GetMin();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting min trigger delay:" << e.GetDescription();
-        return 0.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::TriggerDelay);
+    return entry.readable ? entry.min : 0.0;
 }
 
 double BaslerCamera::getMaxTriggerDelay() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1000000.0; // 1 second default
-    }
-    
-    try {
-        CFloatParameter triggerDelayParam(m_camera->GetNodeMap(), "TriggerDelay");
-        return triggerDelayParam.GetMax();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting max trigger delay:" << e.GetDescription();
-        return 1000000.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::TriggerDelay);
+    return entry.readable ? entry.max : 1000000.0;
 }
 
 double BaslerCamera::getTriggerDelayIncrement() const
 {
-    if (!m_camera || !m_camera->IsOpen()) {
-        return 1.0;
-    }
-    
-    try {
-        CFloatParameter triggerDelayParam(m_camera->GetNodeMap(), "TriggerDelay");
-        return triggerDelayParam.GetInc();
-    }
-    catch (const GenericException& e) {
-        qDebug() << "[BaslerCamera] Error getting trigger delay increment:" << e.GetDescription();
-        return 1.0;
-    }
+    CameraParameterModel::Entry entry = m_parameters->get(CameraParameterModel::TriggerDelay);
+    return entry.readable ? entry.inc : 1.0;
 } 
 
 bool BaslerCamera::executeSoftwareTrigger()
@@ -1453,6 +1545,10 @@ bool BaslerCamera::executeSoftwareTrigger()
         CCommandParameter triggerCommand(m_camera->GetNodeMap(), "TriggerSoftware");
         triggerCommand.Execute();
         qDebug() << "[BaslerCamera] Software trigger executed successfully";
+        
+        if (m_preTrigger->isEnabled() && m_preTrigger->getConfig().triggerOnSoftwareTrigger) {
+            m_preTrigger->trigger("Software trigger");
+        }
         return true;
     }
     catch (const GenericException& e) {
@@ -1461,44 +1557,536 @@ bool BaslerCamera::executeSoftwareTrigger()
     }
 } 
 
-// Image recording control methods
-bool BaslerCamera::isRecordingEnabled() const
+// Asynchronous parameter writes
+std::future<bool> BaslerCamera::setParameterAsync(CameraParameterModel::Parameter parameter, const QVariant &value)
 {
-    return m_recordingEnabled;
+    const QString name = QString::fromUtf8(CameraParameterModel::parameterName(parameter));
+    
+    // No node map, the synthetic source takes its settings on a restart
+    if (m_syntheticSource) {
+        switch (parameter) {
+            case CameraParameterModel::PixelFormat:
+                return finishedWrite(name, setPixelFormat(value.toString()), QString());
+            case CameraParameterModel::AcquisitionFrameRateEnable:
+                return finishedWrite(name, setFrameRateEnabled(value.toBool()), QString());
+            case CameraParameterModel::AcquisitionFrameRate:
+                return finishedWrite(name, setFrameRate(value.toDouble()), QString());
+            default:
+                return finishedWrite(name, false, "Not available on the synthetic source");
+        }
+    }
+    
+    if (m_playbackSource) {
+        if (parameter == CameraParameterModel::AcquisitionFrameRate) {
+            return finishedWrite(name, setFrameRate(value.toDouble()), QString());
+        }
+        return finishedWrite(name, false, "Not available during playback");
+    }
+    
+    if (!m_connected || !m_camera) {
+        return finishedWrite(name, false, "Camera not connected");
+    }
+    
+    if (parameter == CameraParameterModel::PixelFormat &&
+        !FrameHandle::isSupportedPixelType(CPixelTypeMapper::GetPylonPixelTypeByName(value.toString().toUtf8().constData()))) {
+        return finishedWrite(name, false, "Pixel format not supported by the pipeline");
+    }
+    
+    return m_controller->post(name, [this, parameter, value](QString &error) {
+        return writeParameters(1u << parameter, [this, parameter, value]() {
+            if (value.type() == QVariant::String) {
+                m_parameters->setText(parameter, value.toString());
+            } else {
+                m_parameters->setValue(parameter, value.toDouble());
+            }
+        }, error);
+    });
+}
+
+std::future<bool> BaslerCamera::setResolutionAsync(int width, int height)
+{
+    if (m_syntheticSource) {
+        return finishedWrite("Resolution", setResolution(width, height), QString());
+    }
+    
+    if (!m_connected || !m_camera) {
+        return finishedWrite("Resolution", false, "Camera not connected");
+    }
+    
+    // Width and height together, so grabbing restarts once
+    const quint32 mask = (1u << CameraParameterModel::Width) | (1u << CameraParameterModel::Height);
+    return m_controller->post("Resolution", [this, mask, width, height](QString &error) {
+        return writeParameters(mask, [this, width, height]() {
+            m_parameters->setValue(CameraParameterModel::Width, width);
+            m_parameters->setValue(CameraParameterModel::Height, height);
+        }, error);
+    });
+}
+
+CameraController* BaslerCamera::getController() const
+{
+    return m_controller;
+}
+
+bool BaslerCamera::writeParameters(quint32 mask, const std::function<void()> &write, QString &error)
+{
+    // Control thread; disconnect() waits for it before the camera goes away
+    if (!m_camera || !m_camera->IsOpen()) {
+        error = "Camera not open";
+        return false;
+    }
+    
+    // Only nodes that are locked during acquisition need grabbing stopped
+    bool restart = false;
+    if (m_grabFlag) {
+        for (int i = 0; i < CameraParameterModel::PARAMETER_COUNT; ++i) {
+            if (mask & (1u << i)) {
+                const CameraParameterModel::Parameter parameter = static_cast<CameraParameterModel::Parameter>(i);
+                m_parameters->invalidate(parameter);
+                CameraParameterModel::Entry entry = m_parameters->get(parameter);
+                restart = restart || (entry.available && !entry.writable);
+            }
+        }
+    }
+    
+    if (restart) {
+        stopGrabbing();
+    }
+    
+    bool success = true;
+    try {
+        write();
+    }
+    catch (const GenericException& e) {
+        error = QString::fromUtf8(e.GetDescription());
+        success = false;
+    }
+    
+    // Read back here, so the GUI thread finds the cache up to date
+    m_parameters->refresh();
+    
+    if (restart) {
+        startGrabbing();
+    }
+    return success;
+}
+
+std::future<bool> BaslerCamera::finishedWrite(const QString &name, bool success, const QString &error)
+{
+    std::promise<bool> promise;
+    promise.set_value(success);
+    emit parameterWriteFinished(name, success, error);
+    return promise.get_future();
+}
+
+void BaslerCamera::onControlCommandFinished(const QString &key, bool success, const QString &error, qint64 durationNs)
+{
+    // Read-backs are not writes, only pass on what changed
+    if (key == READ_BACK_KEY || key == AUTO_EXPOSURE_KEY) {
+        const double exposureTime = m_exposureTime;
+        if (success && m_connected) {
+            readSettingsFromModel();
+            if (key == READ_BACK_KEY || m_exposureTime != exposureTime) {
+                emit settingsChanged();
+            }
+        }
+        return;
+    }
+    
+    qDebug() << "[BaslerCamera]" << key << (success ? "written in" : "failed after") << durationNs / 1000 << "μs";
+    
+    if (success && m_connected) {
+        readSettingsFromModel();
+        emit settingsChanged();
+    }
+    
+    // applyConfiguration() reports its own summary
+    if (key != "Configuration") {
+        updateStatus(success ? QString("%1 changed").arg(key) : QString("Failed to set %1: %2").arg(key, error));
+    }
+    
+    emit parameterWriteFinished(key, success, error);
+}
+
+// Configuration transactions
+CameraConfiguration::Result BaslerCamera::applyConfiguration(const CameraConfiguration &configuration)
+{
+    CameraConfiguration::Result result;
+    const qint64 start = FrameHandle::currentTimestampNs();
+    
+    if (m_syntheticSource) {
+        applySyntheticConfiguration(configuration, result);
+    } else if (!m_camera || !m_camera->IsOpen()) {
+        result.error = "Camera not open";
+    } else if (configuration.validate(*m_parameters, result.error)) {
+        // Stop once for the whole transaction, and only for nodes locked during acquisition
+        bool restart = false;
+        if (m_grabFlag) {
+            for (const CameraConfiguration::Change &change : configuration.changes()) {
+                m_parameters->invalidate(change.parameter);
+                CameraParameterModel::Entry entry = m_parameters->get(change.parameter);
+                restart = restart || !entry.writable;
+            }
+            for (const CameraConfiguration::Feature &feature : configuration.features()) {
+                GenApi::INode *node = m_camera->GetNodeMap().GetNode(feature.name.toUtf8().constData());
+                restart = restart || (node && !CParameter(node).IsWritable());
+            }
+        }
+        
+        qint64 stoppedAt = 0;
+        if (restart) {
+            stoppedAt = FrameHandle::currentTimestampNs();
+            stopGrabbing();
+            result.restarted = true;
+        }
+        
+        applyConfigurationChanges(configuration, result);
+        if (result.success) {
+            applyConfigurationFeatures(configuration, result);
+        }
+        
+        // Read back here, so the GUI thread finds the cache up to date
+        m_parameters->refresh();
+        
+        if (restart) {
+            startGrabbing();
+            result.downtimeNs = FrameHandle::currentTimestampNs() - stoppedAt;
+        }
+    }
+    result.durationNs = FrameHandle::currentTimestampNs() - start;
+    
+    qDebug() << "[BaslerCamera]" << CameraConfiguration::describe(result);
+    updateStatus(CameraConfiguration::describe(result));
+    {
+        std::lock_guard<std::mutex> lock(m_configurationMutex);
+        m_lastConfigurationResult = result;
+    }
+    
+    // The control thread's caller refreshes in onControlCommandFinished()
+    if (!m_controller->isControlThread() && !m_syntheticSource && m_connected) {
+        readSettingsFromModel();
+        emit settingsChanged();
+    }
+    return result;
+}
+
+std::future<bool> BaslerCamera::applyConfigurationAsync(const CameraConfiguration &configuration)
+{
+    if (m_syntheticSource) {
+        CameraConfiguration::Result result = applyConfiguration(configuration);
+        return finishedWrite("Configuration", result.success, result.error);
+    }
+    
+    if (!m_connected || !m_camera) {
+        return finishedWrite("Configuration", false, "Camera not connected");
+    }
+    
+    return m_controller->post("Configuration", [this, configuration](QString &error) {
+        CameraConfiguration::Result result = applyConfiguration(configuration);
+        error = result.error;
+        return result.success;
+    });
+}
+
+CameraConfiguration::Result BaslerCamera::getLastConfigurationResult() const
+{
+    std::lock_guard<std::mutex> lock(m_configurationMutex);
+    return m_lastConfigurationResult;
+}
+
+void BaslerCamera::writeChange(const CameraConfiguration::Change &change)
+{
+    if (CameraParameterModel::isEnumeration(change.parameter)) {
+        m_parameters->setText(change.parameter, change.value.toString());
+    } else {
+        m_parameters->setValue(change.parameter, change.value.toDouble());
+    }
+}
+
+void BaslerCamera::applyConfigurationChanges(const CameraConfiguration &configuration, CameraConfiguration::Result &result)
+{
+    // Previous values, newest first, to undo the transaction if a write fails
+    QList<CameraConfiguration::Change> undo;
+    
+    for (const CameraConfiguration::Change &change : configuration.changes()) {
+        // Limits as they are after the changes before this one
+        m_parameters->invalidate(change.parameter);
+        CameraParameterModel::Entry entry = m_parameters->get(change.parameter);
+        
+        if (!entry.writable) {
+            result.error = QString("%1 is not writable").arg(CameraParameterModel::parameterName(change.parameter));
+        } else if (CameraConfiguration::checkValue(entry, change, true, result.error)) {
+            try {
+                writeChange(change);
+                undo.prepend(CameraConfiguration::Change{change.parameter,
+                    CameraParameterModel::isEnumeration(change.parameter) ? QVariant(entry.text) : QVariant(entry.value)});
+                ++result.changesApplied;
+                continue;
+            }
+            catch (const GenericException& e) {
+                result.error = QString("%1: %2").arg(CameraParameterModel::parameterName(change.parameter),
+                                                     QString::fromUtf8(e.GetDescription()));
+            }
+        }
+        
+        // Undo in reverse order, so dependent values go back before what they depend on
+        for (const CameraConfiguration::Change &previous : undo) {
+            try {
+                writeChange(previous);
+            }
+            catch (const GenericException& e) {
+                qDebug() << "[BaslerCamera] Error restoring" << CameraParameterModel::parameterName(previous.parameter)
+                         << ":" << e.GetDescription();
+            }
+        }
+        result.rolledBack = !undo.isEmpty();
+        return;
+    }
+    
+    result.success = true;
+}
+
+void BaslerCamera::applyConfigurationFeatures(const CameraConfiguration &configuration, CameraConfiguration::Result &result)
+{
+    if (configuration.features().isEmpty()) {
+        return;
+    }
+    
+    // Selectors are put back afterwards, the parameter model reads the selected instances
+    GenApi::INodeMap &nodeMap = m_camera->GetNodeMap();
+    QList<CameraConfiguration::Feature> selectors;
+    
+    for (const CameraConfiguration::Feature &feature : configuration.features()) {
+        GenApi::INode *node = nodeMap.GetNode(feature.name.toUtf8().constData());
+        CParameter parameter(node);
+        if (!node || !parameter.IsWritable()) {
+            ++result.featuresSkipped;
+            continue;
+        }
+        
+        try {
+            if (feature.name.endsWith("Selector")) {
+                bool saved = false;
+                for (const CameraConfiguration::Feature &selector : selectors) {
+                    saved = saved || selector.name == feature.name;
+                }
+                if (!saved) {
+                    selectors.append(CameraConfiguration::Feature{feature.name, QString::fromUtf8(parameter.ToString().c_str())});
+                }
+            }
+            parameter.FromString(feature.value.toUtf8().constData());
+            ++result.featuresApplied;
+        }
+        catch (const GenericException& e) {
+            qDebug() << "[BaslerCamera] Skipping feature" << feature.name << ":" << e.GetDescription();
+            ++result.featuresSkipped;
+        }
+    }
+    
+    for (const CameraConfiguration::Feature &selector : selectors) {
+        try {
+            CParameter(nodeMap.GetNode(selector.name.toUtf8().constData())).FromString(selector.value.toUtf8().constData());
+        }
+        catch (const GenericException& e) {
+            qDebug() << "[BaslerCamera] Error restoring" << selector.name << ":" << e.GetDescription();
+        }
+    }
+    
+    // Features may change anything the model caches
+    m_parameters->invalidateAll();
+}
+
+void BaslerCamera::applySyntheticConfiguration(const CameraConfiguration &configuration, CameraConfiguration::Result &result)
+{
+    // Check everything before touching the generator settings
+    int width = m_syntheticWidth;
+    int height = m_syntheticHeight;
+    EPixelType pixelType = m_syntheticPixelType;
+    double frameRate = m_syntheticFrameRate;
+    bool frameRateEnabled = m_syntheticFrameRateEnabled;
+    
+    for (const CameraConfiguration::Change &change : configuration.changes()) {
+        switch (change.parameter) {
+            case CameraParameterModel::Width:
+                width = change.value.toInt();
+                break;
+            case CameraParameterModel::Height:
+                height = change.value.toInt();
+                break;
+            case CameraParameterModel::PixelFormat:
+                pixelType = CPixelTypeMapper::GetPylonPixelTypeByName(change.value.toString().toUtf8().constData());
+                if (!FrameHandle::isSupportedPixelType(pixelType)) {
+                    result.error = "Unsupported pixel format: " + change.value.toString();
+                    return;
+                }
+                break;
+            case CameraParameterModel::AcquisitionFrameRate:
+                frameRate = change.value.toDouble();
+                break;
+            case CameraParameterModel::AcquisitionFrameRateEnable:
+                frameRateEnabled = change.value.toDouble() != 0.0;
+                break;
+            default:
+                result.error = QString("%1 is not available on the synthetic source")
+                               .arg(CameraParameterModel::parameterName(change.parameter));
+                return;
+        }
+    }
+    if (width <= 0 || height <= 0 || (frameRateEnabled && frameRate <= 0.0)) {
+        result.error = "Invalid synthetic source settings";
+        return;
+    }
+    
+    m_syntheticWidth = width;
+    m_syntheticHeight = height;
+    m_syntheticPixelType = pixelType;
+    m_syntheticFrameRate = frameRate;
+    m_syntheticFrameRateEnabled = frameRateEnabled;
+    
+    // One restart covers all of them
+    const bool wasGrabbing = m_grabFlag;
+    const qint64 stoppedAt = FrameHandle::currentTimestampNs();
+    applySyntheticSettings("Synthetic source reconfigured");
+    if (wasGrabbing) {
+        result.restarted = true;
+        result.downtimeNs = FrameHandle::currentTimestampNs() - stoppedAt;
+    }
+    
+    result.changesApplied = configuration.changes().size();
+    result.featuresSkipped = configuration.features().size();
+    result.success = true;
+}
+
+// Per-stage latency statistics
+void BaslerCamera::recordLatency(LatencyStage stage, qint64 latencyNs)
+{
+    if (stage >= 0 && stage < LATENCY_STAGE_COUNT) {
+        m_latencyHistograms[stage].record(latencyNs);
+    }
+}
+
+double BaslerCamera::getLatencyPercentile(LatencyStage stage, double percentile) const
+{
+    if (stage < 0 || stage >= LATENCY_STAGE_COUNT) {
+        return 0.0;
+    }
+    return m_latencyHistograms[stage].valueAtPercentile(percentile) / 1000.0;
+}
+
+quint64 BaslerCamera::getLatencySampleCount(LatencyStage stage) const
+{
+    if (stage < 0 || stage >= LATENCY_STAGE_COUNT) {
+        return 0;
+    }
+    return m_latencyHistograms[stage].count();
+}
+
+void BaslerCamera::resetLatencyStats()
+{
+    for (LatencyHistogram &histogram : m_latencyHistograms) {
+        histogram.reset();
+    }
+    qDebug() << "[BaslerCamera] Latency statistics reset";
+}
+
+bool BaslerCamera::dumpLatencyStats(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "[BaslerCamera] Cannot open latency dump file:" << filePath;
+        return false;
+    }
+    
+    QTextStream out(&file);
+    out << "# Pipeline latency per stage, values in microseconds\n";
+    out << "# Written " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    out << "stage count min mean p50 p99 p99.9 max\n";
+    
+    for (int i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const LatencyHistogram &histogram = m_latencyHistograms[i];
+        out << getLatencyStageName(static_cast<LatencyStage>(i))
+            << ' ' << histogram.count()
+            << ' ' << QString::number(histogram.minValue() / 1000.0, 'f', 1)
+            << ' ' << QString::number(histogram.mean() / 1000.0, 'f', 1)
+            << ' ' << QString::number(histogram.valueAtPercentile(50.0) / 1000.0, 'f', 1)
+            << ' ' << QString::number(histogram.valueAtPercentile(99.0) / 1000.0, 'f', 1)
+            << ' ' << QString::number(histogram.valueAtPercentile(99.9) / 1000.0, 'f', 1)
+            << ' ' << QString::number(histogram.maxValue() / 1000.0, 'f', 1) << "\n";
+    }
+    
+    // Raw buckets so the distributions can be plotted later
+    for (int i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        out << "\n# Buckets for " << getLatencyStageName(static_cast<LatencyStage>(i))
+            << " (upper edge ns, count)\n";
+        out << QString::fromStdString(m_latencyHistograms[i].bucketsToString());
+    }
+    
+    qDebug() << "[BaslerCamera] Latency statistics written to:" << filePath;
+    return true;
+}
+
+QString BaslerCamera::getLatencyStageName(LatencyStage stage)
+{
+    switch (stage) {
+        case LatencyRetrieve:     return "retrieve";
+        case LatencyConvert:      return "convert";
+        case LatencyPublish:      return "publish";
+        case LatencyDisplay:      return "display";
+        case LatencyRecordWrite:  return "record_write";
+        case LatencyRecordEncode: return "record_encode";
+        default:                  return "unknown";
+    }
+}
+
+// Image recording control methods
+bool BaslerCamera::isRecordingEnabled() const
+{
+    return m_recordingEnabled;
 }
 
 void BaslerCamera::setRecordingEnabled(bool enable)
 {
+    if (enable) {
+        // Video containers store a nominal rate, the frame rate setting of the source
+        m_recorder->setVideoFrameRate(m_frameRate);
+        m_recorder->start();
+    }
+    
     m_recordingEnabled = enable;
+    
+    if (!enable) {
+        m_recorder->stop();
+    }
+    
     qDebug() << "[BaslerCamera] Recording enabled:" << enable;
 }
 
 void BaslerCamera::setRecordingPath(const QString &path)
 {
-    m_recordingPath = path;
+    m_recorder->setRecordingPath(path);
     qDebug() << "[BaslerCamera] Recording path set to:" << path;
 }
 
 QString BaslerCamera::getRecordingPath() const
 {
-    return m_recordingPath;
+    return m_recorder->getRecordingPath();
 }
 
 int BaslerCamera::getRecordedImageCount() const
 {
-    return m_recordedImageCount;
+    return m_recorder->getRecordedImageCount();
 }
 
 void BaslerCamera::resetRecordingCount()
 {
-    m_recordedImageCount = 0;
+    m_recorder->resetRecordingCount();
     qDebug() << "[BaslerCamera] Recording count reset to 0";
 }
 
 void BaslerCamera::setMaxRecordedImages(int maxCount)
 {
     if (maxCount > 0) {
-        m_maxRecordedImages = maxCount;
+        m_recorder->setMaxRecordedImages(maxCount);
         qDebug() << "[BaslerCamera] Max recorded images set to:" << maxCount;
     } else {
         qDebug() << "[BaslerCamera] Invalid max count:" << maxCount << "must be > 0";
@@ -1507,7 +2095,142 @@ void BaslerCamera::setMaxRecordedImages(int maxCount)
 
 int BaslerCamera::getMaxRecordedImages() const
 {
-    return m_maxRecordedImages;
+    return m_recorder->getMaxRecordedImages();
+}
+
+void BaslerCamera::setRecordingQueueCapacity(int capacity)
+{
+    // The grab buffer count follows the queue capacity on the next start
+    m_recorder->setQueueCapacity(capacity);
+    qDebug() << "[BaslerCamera] Recording queue capacity set to:" << capacity;
+}
+
+int BaslerCamera::getRecordingQueueCapacity() const
+{
+    return m_recorder->getQueueCapacity();
+}
+
+void BaslerCamera::setRecordingOverflowPolicy(FrameRecorder::OverflowPolicy policy)
+{
+    m_recorder->setOverflowPolicy(policy);
+    qDebug() << "[BaslerCamera] Recording overflow policy set to:" << policy;
+}
+
+FrameRecorder::OverflowPolicy BaslerCamera::getRecordingOverflowPolicy() const
+{
+    return m_recorder->getOverflowPolicy();
+}
+
+void BaslerCamera::setWhiteBalance(const BayerDemosaic::WhiteBalance &whiteBalance)
+{
+    m_recorder->setWhiteBalance(whiteBalance);
+    qDebug() << "[BaslerCamera] White balance set to R" << whiteBalance.red
+             << "G" << whiteBalance.green << "B" << whiteBalance.blue;
+}
+
+BayerDemosaic::WhiteBalance BaslerCamera::getWhiteBalance() const
+{
+    return m_recorder->getWhiteBalance();
+}
+
+void BaslerCamera::setRecordingWriterThreads(int count)
+{
+    m_recorder->setWriterThreadCount(count);
+    qDebug() << "[BaslerCamera] Recording writer threads set to:" << count;
+}
+
+int BaslerCamera::getRecordingWriterThreads() const
+{
+    return m_recorder->getWriterThreadCount();
+}
+
+void BaslerCamera::setRecordingFormat(FrameRecorder::RecordingFormat format)
+{
+    m_recorder->setRecordingFormat(format);
+    qDebug() << "[BaslerCamera] Recording format set to:" << FrameRecorder::formatName(format);
+}
+
+FrameRecorder::RecordingFormat BaslerCamera::getRecordingFormat() const
+{
+    return m_recorder->getRecordingFormat();
+}
+
+QString BaslerCamera::getRecordingSequenceInfo() const
+{
+    return m_recorder->getSequenceInfo();
+}
+
+QString BaslerCamera::getRecordingCompressionInfo() const
+{
+    return m_recorder->getCompressionInfo();
+}
+
+void BaslerCamera::setRecordingVideoSegmentFrames(int frames)
+{
+    m_recorder->setVideoSegmentFrames(frames);
+    qDebug() << "[BaslerCamera] Recording video segment frames set to:" << frames;
+}
+
+int BaslerCamera::getRecordingVideoSegmentFrames() const
+{
+    return m_recorder->getVideoSegmentFrames();
+}
+
+QString BaslerCamera::getRecordingVideoInfo() const
+{
+    return m_recorder->getVideoInfo();
+}
+
+// Pre-trigger ring
+void BaslerCamera::setPreTriggerConfig(const PreTriggerBuffer::Config &config)
+{
+    m_preTrigger->setConfig(config);
+}
+
+PreTriggerBuffer::Config BaslerCamera::getPreTriggerConfig() const
+{
+    return m_preTrigger->getConfig();
+}
+
+void BaslerCamera::setPreTriggerEnabled(bool enable)
+{
+    m_preTrigger->setEnabled(enable);
+    qDebug() << "[BaslerCamera] Pre-trigger buffer enabled:" << enable;
+}
+
+bool BaslerCamera::isPreTriggerEnabled() const
+{
+    return m_preTrigger->isEnabled();
+}
+
+bool BaslerCamera::triggerPreTrigger(const QString &reason)
+{
+    return m_preTrigger->trigger(reason);
+}
+
+PreTriggerBuffer::Stats BaslerCamera::getPreTriggerStats() const
+{
+    return m_preTrigger->getStats();
+}
+
+quint64 BaslerCamera::getRecordingQueuedCount() const
+{
+    return m_recorder->getQueuedCount();
+}
+
+quint64 BaslerCamera::getRecordingWrittenCount() const
+{
+    return m_recorder->getWrittenCount();
+}
+
+quint64 BaslerCamera::getRecordingDroppedCount() const
+{
+    return m_recorder->getDroppedCount();
+}
+
+int BaslerCamera::getRecordingQueueDepth() const
+{
+    return m_recorder->getQueueDepth();
 }
 
 // Camera IP address methods
@@ -1521,3 +2244,216 @@ QString BaslerCamera::getCameraIP() const
 {
     return m_cameraIP;
 } 
+
+// Frame source selection
+void BaslerCamera::setSourceType(SourceType type)
+{
+    m_sourceType = type;
+    qDebug() << "[BaslerCamera] Frame source set to:" << type;
+}
+
+BaslerCamera::SourceType BaslerCamera::getSourceType() const
+{
+    return m_sourceType;
+}
+
+void BaslerCamera::setDeviceSerial(const QString &serial)
+{
+    m_deviceSerial = serial;
+    qDebug() << "[BaslerCamera] Device serial set to:" << serial;
+}
+
+QString BaslerCamera::getDeviceSerial() const
+{
+    return m_deviceSerial;
+}
+
+void BaslerCamera::setGrabThreadPolicy(const ThreadPolicy::Config &config)
+{
+    std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+    m_grabThreadPolicy = config;
+    qDebug() << "[BaslerCamera] Grab thread policy set to:" << ThreadPolicy::schedulingName(config.scheduling)
+             << config.priority << "cores" << config.cores << "node" << config.memoryNode;
+}
+
+ThreadPolicy::Config BaslerCamera::getGrabThreadPolicy() const
+{
+    std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+    return m_grabThreadPolicy;
+}
+
+void BaslerCamera::setGrabThreadCore(int core)
+{
+    std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+    m_grabThreadPolicy.cores.clear();
+    if (core >= 0) {
+        m_grabThreadPolicy.cores.append(core);
+    }
+    qDebug() << "[BaslerCamera] Grab thread core set to:" << core << "(-1 = not pinned)";
+}
+
+int BaslerCamera::getGrabThreadCore() const
+{
+    std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+    return m_grabThreadPolicy.cores.size() == 1 ? m_grabThreadPolicy.cores.first() : -1;
+}
+
+int BaslerCamera::getAppliedGrabThreadCore() const
+{
+    return m_appliedGrabThreadCore;
+}
+
+QString BaslerCamera::getGrabThreadPolicyReport() const
+{
+    std::lock_guard<std::mutex> lock(m_threadPolicyMutex);
+    return m_grabThreadPolicyReport.isEmpty() ? QString("Not started") : m_grabThreadPolicyReport;
+}
+
+void BaslerCamera::setRecorderThreadPolicy(const ThreadPolicy::Config &config)
+{
+    m_recorder->setThreadPolicy(config);
+}
+
+ThreadPolicy::Config BaslerCamera::getRecorderThreadPolicy() const
+{
+    return m_recorder->getThreadPolicy();
+}
+
+QString BaslerCamera::getRecorderThreadPolicyReport() const
+{
+    return m_recorder->getThreadPolicyReport();
+}
+
+CameraParameterModel* BaslerCamera::getParameterModel() const
+{
+    return m_parameters;
+}
+
+qint64 BaslerCamera::getPayloadSize() const
+{
+    return m_payloadSize;
+}
+
+bool BaslerCamera::setSyntheticPixelType(EPixelType pixelType)
+{
+    if (!SyntheticFrameSource::isSupportedPixelType(pixelType)) {
+        qDebug() << "[BaslerCamera] Unsupported synthetic pixel type:" << pixelType;
+        return false;
+    }
+    
+    m_syntheticPixelType = pixelType;
+    
+    if (m_syntheticSource) {
+        return applySyntheticSettings("Synthetic pixel format changed");
+    }
+    return true;
+}
+
+EPixelType BaslerCamera::getSyntheticPixelType() const
+{
+    return m_syntheticPixelType;
+}
+
+void BaslerCamera::setPlaybackPath(const QString &path)
+{
+    m_playbackPath = path;
+    qDebug() << "[BaslerCamera] Playback path set to:" << path;
+}
+
+QString BaslerCamera::getPlaybackPath() const
+{
+    return m_playbackPath;
+}
+
+void BaslerCamera::setPlaybackPacing(PlaybackFrameSource::Pacing pacing)
+{
+    m_playbackPacing = pacing;
+    if (m_playbackSource) {
+        m_playbackSource->setPacing(pacing);
+        updateCameraSettings();
+    }
+}
+
+PlaybackFrameSource::Pacing BaslerCamera::getPlaybackPacing() const
+{
+    return m_playbackPacing;
+}
+
+void BaslerCamera::setPlaybackLoop(bool loop)
+{
+    m_playbackLoop = loop;
+    if (m_playbackSource) {
+        m_playbackSource->setLoop(loop);
+    }
+}
+
+bool BaslerCamera::getPlaybackLoop() const
+{
+    return m_playbackLoop;
+}
+
+bool BaslerCamera::seekPlayback(int frameIndex)
+{
+    if (!m_playbackSource) {
+        qDebug() << "[BaslerCamera] Not playing back, cannot seek";
+        return false;
+    }
+    
+    m_playbackSource->seek(frameIndex);
+    updateStatus(QString("Playback seeks to frame %1").arg(frameIndex));
+    return true;
+}
+
+int BaslerCamera::getPlaybackFrameCount() const
+{
+    return m_playbackSource ? m_playbackSource->getFrameCount() : 0;
+}
+
+int BaslerCamera::getPlaybackPosition() const
+{
+    return m_playbackSource ? m_playbackSource->getPosition() : -1;
+}
+
+QString BaslerCamera::getPlaybackInfo() const
+{
+    if (!m_playbackSource) {
+        return "Not playing back";
+    }
+    
+    QString info = QString("Frame %1 / %2").arg(m_playbackSource->getPosition() + 1)
+                   .arg(m_playbackSource->getFrameCount());
+    if (m_playbackSource->getLoopCount() > 0) {
+        info += QString(", pass %1").arg(m_playbackSource->getLoopCount() + 1);
+    }
+    if (m_playbackSource->isFinished()) {
+        info += ", finished";
+    }
+    return info;
+}
+
+bool BaslerCamera::applySyntheticSettings(const QString &status)
+{
+    // Stop grabbing if active, the source picks up new settings on start
+    bool wasGrabbing = false;
+    if (m_grabFlag) {
+        stopGrabbing();
+        wasGrabbing = true;
+    }
+    
+    m_syntheticSource->setResolution(m_syntheticWidth, m_syntheticHeight);
+    m_syntheticSource->setPixelType(m_syntheticPixelType);
+    m_syntheticSource->setFrameRate(m_syntheticFrameRateEnabled ? m_syntheticFrameRate : 0.0);
+    
+    updateCameraSettings();
+    
+    // Restart grabbing if it was active
+    if (wasGrabbing) {
+        startGrabbing();
+    }
+    
+    // Emit settings changed signal
+    emit settingsChanged();
+    
+    updateStatus(status);
+    return true;
+}
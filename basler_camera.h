@@ -4,10 +4,29 @@
 #include <QObject>
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QTimer>
+#include <QVariant>
+#include <functional>
+#include <future>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <opencv2/opencv.hpp>
+#include "camera_configuration.h"
+#include "camera_controller.h"
+#include "camera_parameter_model.h"
+#include "frame_handle.h"
+#include "frame_mailbox.h"
+#include "frame_recorder.h"
+#include "frame_source.h"
+#include "frame_statistics.h"
+#include "frame_timing_monitor.h"
+#include "latency_histogram.h"
+#include "playback_frame_source.h"
+#include "pre_trigger_buffer.h"
+#include "synthetic_frame_source.h"
+#include "thread_policy.h"
 
 // Basler Pylon includes
 #include <pylon/PylonIncludes.h>
@@ -19,6 +38,25 @@ class BaslerCamera : public QObject
     Q_OBJECT
 
 public:
+    // Backend the frames come from
+    enum SourceType {
+        SourceGigE,       // Basler GigE camera at the configured IP address
+        SourceEmulator,   // Pylon camera emulator device
+        SourceSynthetic,  // Software test pattern generator
+        SourcePlayback    // Recorded .bseq file or BMP directory
+    };
+
+    // Pipeline stages with latency histograms
+    enum LatencyStage {
+        LatencyRetrieve,     // Time spent in the frame source's retrieve call
+        LatencyConvert,      // Display conversion of a frame to an image
+        LatencyPublish,      // Hand-off to the mailbox and recorder queue
+        LatencyDisplay,      // Frame age when it is first painted
+        LatencyRecordWrite,  // Frame age when its file has been written
+        LatencyRecordEncode, // Time to compress a recorded frame (PNG/TIFF)
+        LATENCY_STAGE_COUNT
+    };
+
     explicit BaslerCamera(QObject *parent = nullptr);
     ~BaslerCamera();
 
@@ -26,9 +64,11 @@ public:
     void disconnect();
     bool isConnected() const { return m_connected; }
     
+    FrameHandle getFrame();
     cv::Mat getImage();
     void startGrabbing();
     void stopGrabbing();
+    bool isGrabbing() const { return m_grabFlag; }
     
     // Camera information
     QString getCameraInfo() const;
@@ -43,6 +83,19 @@ public:
     bool setResolution(int width, int height);
     QStringList getAvailableResolutions() const;
     
+    // Pixel format control, packed formats cut the link bandwidth per frame
+    QString getPixelFormat() const;
+    bool setPixelFormat(const QString &format);
+    QStringList getAvailablePixelFormats() const;
+    
+    // Payload per frame, link throughput and the frame rate the link allows
+    QString getBandwidthInfo() const;
+    
+    // White-balance gains applied while demosaicing Bayer frames
+    // (getImage() and recording; the display passes its own)
+    void setWhiteBalance(const BayerDemosaic::WhiteBalance &whiteBalance);
+    BayerDemosaic::WhiteBalance getWhiteBalance() const;
+    
     // Scaling control
     double getScalingFactor() const;
     bool setScalingFactor(double factor);
@@ -86,6 +139,29 @@ public:
     // Software trigger execution
     bool executeSoftwareTrigger();
     
+    // Asynchronous parameter writes on the camera-control thread, the caller
+    // never waits for register access or a grab restart. A write to a
+    // parameter that is still queued replaces the queued value, so only the
+    // newest position of a dragged slider is applied. Grabbing is restarted
+    // only for nodes that are locked during acquisition. The result arrives
+    // through the future and parameterWriteFinished(). Values are numbers,
+    // or the entry name for enumerations; the synthetic source applies
+    // its settings immediately.
+    std::future<bool> setParameterAsync(CameraParameterModel::Parameter parameter, const QVariant &value);
+    std::future<bool> setResolutionAsync(int width, int height);
+    CameraController* getController() const;
+    
+    // Configuration transaction: all changes are checked against the cached
+    // limits first, then written in dependency order with grabbing stopped
+    // and restarted at most once (only if a node is locked during
+    // acquisition). A failed write undoes the changes made so far; features
+    // from a .pfs file are written best-effort afterwards. The async
+    // variant runs on the control thread and reports through
+    // parameterWriteFinished("Configuration", ...).
+    CameraConfiguration::Result applyConfiguration(const CameraConfiguration &configuration);
+    std::future<bool> applyConfigurationAsync(const CameraConfiguration &configuration);
+    CameraConfiguration::Result getLastConfigurationResult() const;
+    
     // Image recording control
     bool isRecordingEnabled() const;
     void setRecordingEnabled(bool enable);
@@ -96,37 +172,169 @@ public:
     void setMaxRecordedImages(int maxCount);
     int getMaxRecordedImages() const;
     
-    // Real-time frame rate measurement
+    // Asynchronous recorder queue
+    void setRecordingQueueCapacity(int capacity);
+    int getRecordingQueueCapacity() const;
+    void setRecordingOverflowPolicy(FrameRecorder::OverflowPolicy policy);
+    FrameRecorder::OverflowPolicy getRecordingOverflowPolicy() const;
+    void setRecordingWriterThreads(int count);
+    int getRecordingWriterThreads() const;
+    void setRecordingFormat(FrameRecorder::RecordingFormat format);  // Applied when recording starts
+    FrameRecorder::RecordingFormat getRecordingFormat() const;
+    QString getRecordingSequenceInfo() const;
+    QString getRecordingCompressionInfo() const;
+    void setRecordingVideoSegmentFrames(int frames);                  // Applied when recording starts
+    int getRecordingVideoSegmentFrames() const;
+    QString getRecordingVideoInfo() const;
+    
+    // Pre-trigger ring: keeps the latest frames in memory and writes the ones
+    // around an event to disk while grabbing goes on. Fired by the software
+    // trigger if the config asks for it, or by triggerPreTrigger() from any
+    // thread (e.g. an analysis result).
+    void setPreTriggerConfig(const PreTriggerBuffer::Config &config);
+    PreTriggerBuffer::Config getPreTriggerConfig() const;
+    void setPreTriggerEnabled(bool enable);
+    bool isPreTriggerEnabled() const;
+    bool triggerPreTrigger(const QString &reason);
+    PreTriggerBuffer::Stats getPreTriggerStats() const;
+    quint64 getRecordingQueuedCount() const;
+    quint64 getRecordingWrittenCount() const;
+    quint64 getRecordingDroppedCount() const;
+    int getRecordingQueueDepth() const;
+    
+    // Grab buffer pool, applied when grabbing starts
+    void setGrabBufferCount(int count);        // 0 = default plus recorder queue capacity
+    int getGrabBufferCount() const;
+    void setGrabBufferSize(size_t size);       // 0 = derived from Width/Height/PixelFormat
+    size_t getGrabBufferSize() const;
+    void setGrabBufferHugePages(bool enable);
+    bool getGrabBufferHugePages() const;
+    void setGrabBufferLockMemory(bool enable);
+    bool getGrabBufferLockMemory() const;
+    QString getGrabBufferInfo() const;
+    
+    // Acquisition mode: which frames the grab strategy keeps when the
+    // pipeline falls behind, and whether frames are pushed from Pylon's grab
+    // thread instead of polled. Restarts grabbing if active.
+    bool setAcquisitionMode(IFrameSource::GrabStrategy strategy, int queueSize, bool eventDriven);
+    IFrameSource::GrabStrategy getGrabStrategy() const;
+    int getGrabQueueSize() const;
+    bool isEventDrivenAcquisition() const;  // Requested
+    bool isEventDrivenActive() const;       // In use, false when the source fell back to polling
+    quint64 getSkippedFrameCount() const;
+    
+    // Real-time frame rate measurement. Frames are only counted on the grab
+    // thread, the figures are derived and published on a timer.
     double getRealTimeFrameRate() const;
+    FrameStatistics::Snapshot getFrameStatistics() const;
+    void setStatisticsWindowSize(int intervals);
+    int getStatisticsWindowSize() const;
+    
+    // Sensor-side timing from the camera timestamp and block ID: intervals
+    // on the camera clock, frames lost between camera and grab loop, and
+    // delivery latency. Reset when grabbing starts.
+    FrameTimingMonitor::Snapshot getFrameTiming() const;
+    quint64 getMissingFrameCount() const;
+    bool dumpFrameTiming(const QString &filePath) const;  // Newest frames as CSV
     
     // Camera IP address setting
     void setCameraIP(const QString &ipAddress);
     QString getCameraIP() const;
+    
+    // Frame source selection, takes effect on the next connect
+    void setSourceType(SourceType type);
+    SourceType getSourceType() const;
+    
+    // Open the GigE or emulated device with this serial number instead of
+    // the one at the camera IP / the first emulator, takes effect on the next connect
+    void setDeviceSerial(const QString &serial);
+    QString getDeviceSerial() const;
+    
+    // Scheduling, cores and memory node of the grab thread, applied when
+    // grabbing starts (grab buffers are allocated on that thread afterwards).
+    // setGrabThreadCore() only changes the cores, -1 = not pinned.
+    void setGrabThreadPolicy(const ThreadPolicy::Config &config);
+    ThreadPolicy::Config getGrabThreadPolicy() const;
+    void setGrabThreadCore(int core);
+    int getGrabThreadCore() const;
+    int getAppliedGrabThreadCore() const;  // -1 unless pinned to exactly one core
+    QString getGrabThreadPolicyReport() const;
+    
+    // Same for the recorder's writer threads, applied when recording starts
+    void setRecorderThreadPolicy(const ThreadPolicy::Config &config);
+    ThreadPolicy::Config getRecorderThreadPolicy() const;
+    QString getRecorderThreadPolicyReport() const;
+    
+    // Bytes per frame on the link, 0 if unknown
+    qint64 getPayloadSize() const;
+    
+    // Cached GenApi parameters of the connected camera (detached otherwise)
+    CameraParameterModel* getParameterModel() const;
+    
+    // Synthetic source pixel format (resolution and frame rate use the regular setters)
+    bool setSyntheticPixelType(EPixelType pixelType);
+    EPixelType getSyntheticPixelType() const;
+    
+    // Playback source: the file or directory takes effect on the next connect,
+    // pacing, looping and seeking apply while grabbing. The frame rate setters
+    // pace recordings without timestamps.
+    void setPlaybackPath(const QString &path);
+    QString getPlaybackPath() const;
+    void setPlaybackPacing(PlaybackFrameSource::Pacing pacing);
+    PlaybackFrameSource::Pacing getPlaybackPacing() const;
+    void setPlaybackLoop(bool loop);
+    bool getPlaybackLoop() const;
+    bool seekPlayback(int frameIndex);
+    int getPlaybackFrameCount() const;
+    int getPlaybackPosition() const;     // -1 before the first frame or without playback
+    QString getPlaybackInfo() const;
     int getFrameCount() const;
     void resetFrameRateMeasurement();
     
     // Frame tracking
     int getCurrentFrameId() const;
     int getErrorsCount() const;
+    quint64 getOverwrittenFrameCount() const;
+    
+    // Per-stage latency statistics, percentiles in microseconds
+    void recordLatency(LatencyStage stage, qint64 latencyNs);
+    double getLatencyPercentile(LatencyStage stage, double percentile) const;
+    quint64 getLatencySampleCount(LatencyStage stage) const;
+    void resetLatencyStats();
+    bool dumpLatencyStats(const QString &filePath) const;
+    static QString getLatencyStageName(LatencyStage stage);
 
 signals:
+    // Emitted from the grab thread for every frame, connect with Qt::DirectConnection
+    // to a thread-safe receiver (see DisplayScheduler) rather than queueing one call per frame
     void imageUpdated();
     void statusChanged(const QString &status);
     void settingsChanged();
+    // Emitted on the statistics timer, not per frame
     void frameRateUpdated(double frameRate);
     void frameIdUpdated(int frameId);
     void errorsCountUpdated(int errorsCount);
+    void recordingStatsUpdated(quint64 queued, quint64 written, quint64 dropped);
+    // After an asynchronous write, on the object's thread with the settings already read back
+    void parameterWriteFinished(const QString &name, bool success, const QString &error);
+    void preTriggerDumpFinished(const QString &filePath, int frames, bool success, const QString &message);
+    // Right before disconnect() closes the source, frames kept elsewhere must be dropped.
+    // Emitted from the disconnecting thread, connect with Qt::DirectConnection.
+    void sourceClosing();
 
 private:
-    CInstantCamera* m_camera;
-    CGrabResultPtr m_grabResult;
+    IFrameSource* m_source;
+    SyntheticFrameSource* m_syntheticSource; // Same object as m_source when the synthetic backend is active
+    PlaybackFrameSource* m_playbackSource;   // Same object as m_source during playback
+    CInstantCamera* m_camera;                // Pylon camera of m_source for parameter access, nullptr if none
+    SourceType m_sourceType;
     
     std::thread* m_grabThread;
     std::atomic<bool> m_grabFlag;
+    std::mutex m_grabControlMutex;   // startGrabbing()/stopGrabbing() from the GUI and control threads
     std::atomic<bool> m_connected;
     
-    cv::Mat m_currentImage;
-    std::mutex m_imageMutex;
+    FrameMailbox<FrameHandle> m_frameMailbox;
     
     // Camera info
     QString m_cameraName;
@@ -143,6 +351,9 @@ private:
     bool m_exposureAuto;
     bool m_frameRateEnabled;
     double m_frameRate;
+    QString m_pixelFormat;
+    qint64 m_payloadSize;     // Bytes per frame on the link
+    qint64 m_linkThroughput;  // Bytes per second, 0 if the device does not report it
     
     // Trigger settings
     bool m_triggerEnabled;
@@ -150,32 +361,83 @@ private:
     QString m_triggerSource;
     double m_triggerDelay;
     
+    // Synthetic source settings, kept across reconnects
+    int m_syntheticWidth;
+    int m_syntheticHeight;
+    EPixelType m_syntheticPixelType;
+    double m_syntheticFrameRate;
+    bool m_syntheticFrameRateEnabled;
+    
+    // Playback source settings, kept across reconnects
+    QString m_playbackPath;
+    PlaybackFrameSource::Pacing m_playbackPacing;
+    bool m_playbackLoop;
+    double m_playbackFrameRate;
+    
     // Image recording settings
-    bool m_recordingEnabled;
-    QString m_recordingPath;
-    int m_recordedImageCount;
-    int m_maxRecordedImages;
+    std::atomic<bool> m_recordingEnabled;
+    FrameRecorder* m_recorder;
+    PreTriggerBuffer* m_preTrigger;
+    CameraParameterModel* m_parameters;
+    CameraController* m_controller;  // Camera-control thread for asynchronous writes
+    mutable std::mutex m_configurationMutex;
+    CameraConfiguration::Result m_lastConfigurationResult;  // Guarded by m_configurationMutex
+    
+    // Grab buffer pool settings
+    std::atomic<int> m_grabBufferCount;
+    std::atomic<size_t> m_grabBufferSize;
+    std::atomic<bool> m_grabBufferHugePages;
+    std::atomic<bool> m_grabBufferLockMemory;
+    static const int DEFAULT_NUM_GRAB_BUFFERS = 10; // Pylon's MaxNumBuffer default
+    
+    // Acquisition mode
+    std::atomic<int> m_grabStrategy;        // IFrameSource::GrabStrategy
+    std::atomic<int> m_grabQueueSize;
+    std::atomic<bool> m_eventDriven;
+    std::atomic<bool> m_eventDrivenActive;
+    std::mutex m_grabWaitMutex;             // The event-driven grab loop waits for stopGrabbing()
+    std::condition_variable m_grabWait;
+    
+    // Grab thread placement
+    mutable std::mutex m_threadPolicyMutex;
+    ThreadPolicy::Config m_grabThreadPolicy;      // Guarded by m_threadPolicyMutex
+    QString m_grabThreadPolicyReport;             // Guarded by m_threadPolicyMutex
+    std::atomic<int> m_appliedGrabThreadCore;
+    std::atomic<bool> m_grabThreadPolicyApplied;  // Event-driven callbacks set up Pylon's thread once
+    QString m_deviceSerial;
     
     // Real-time frame rate measurement
-    mutable std::mutex m_frameRateMutex;
-    QElapsedTimer m_frameRateTimer;
-    int m_frameCount;
-    double m_realTimeFrameRate;
-    static const int FRAME_RATE_WINDOW_SIZE = 5; // Reduced from 30 to 5 for more frequent updates
-    QElapsedTimer m_lastFrameTimer; // For more accurate frame rate calculation
-    double m_lastFrameTime; // Store last frame time for rolling average
-    QVector<double> m_frameIntervals; // Store recent frame intervals for moving average
-    static const int MAX_INTERVALS = 10; // Number of intervals to keep for moving average
+    FrameStatistics m_statistics;
+    QTimer *m_statisticsTimer;                 // Publishes snapshots while grabbing
+    std::atomic<double> m_realTimeFrameRate;   // Windowed rate of the last snapshot
+    static const int STATISTICS_PUBLISH_INTERVAL_MS = 250;
+    FrameTimingMonitor m_frameTiming;
+    
+    // Per-stage latency histograms
+    LatencyHistogram m_latencyHistograms[LATENCY_STAGE_COUNT];
     
     // Frame tracking
-    int m_currentFrameId;
+    std::atomic<int> m_currentFrameId;
     int m_errorsCount;
     
     void grabLoop();
+    void handleFrame(IFrameSource::RetrieveStatus status, const FrameHandle &frame, const QString &error);
+    void applyGrabThreadPolicy();
     void updateStatus(const QString &status);
     void updateCameraSettings();
-    void updateRealTimeFrameRate();
-    void convertBaslerImageToOpenCV(const CGrabResultPtr& grabResult, cv::Mat& image);
+    void readSettingsFromModel();
+    void onParametersChanged(quint32 mask);
+    void postReadBack(const QString &key, bool exposureOnly);
+    void publishStatistics();
+    void updateStatisticsTimer();
+    bool applySyntheticSettings(const QString &status);
+    bool writeParameters(quint32 mask, const std::function<void()> &write, QString &error);
+    void writeChange(const CameraConfiguration::Change &change);
+    void applyConfigurationChanges(const CameraConfiguration &configuration, CameraConfiguration::Result &result);
+    void applyConfigurationFeatures(const CameraConfiguration &configuration, CameraConfiguration::Result &result);
+    void applySyntheticConfiguration(const CameraConfiguration &configuration, CameraConfiguration::Result &result);
+    std::future<bool> finishedWrite(const QString &name, bool success, const QString &error);
+    void onControlCommandFinished(const QString &key, bool success, const QString &error, qint64 durationNs);
 };
 
 #endif // BASLER_CAMERA_H 
\ No newline at end of file
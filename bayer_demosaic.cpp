@@ -0,0 +1,391 @@
+#include "bayer_demosaic.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BAYER_DEMOSAIC_X86 1
+#endif
+
+namespace {
+
+// Channel indices in the interleaved BGR output
+enum Channel {
+    ChannelB = 0,
+    ChannelG = 1,
+    ChannelR = 2
+};
+
+// Interpolation candidates of the bilinear kernel
+enum Source {
+    SourceCenter,      // The sample itself
+    SourceHorizontal,  // Left and right neighbours
+    SourceVertical,    // Upper and lower neighbours
+    SourceDiagonal,    // Four diagonal neighbours
+    SourceCross,       // Four direct neighbours
+    SOURCE_COUNT
+};
+
+const int ROWS_PER_STRIP = 32;
+const double MAX_GAIN = 8.0;
+
+// Channel at (x & 1, y & 1) for each pattern
+const Channel PATTERN_CHANNELS[4][2][2] = {
+    { { ChannelR, ChannelG }, { ChannelG, ChannelB } },  // RGGB
+    { { ChannelB, ChannelG }, { ChannelG, ChannelR } },  // BGGR
+    { { ChannelG, ChannelR }, { ChannelB, ChannelG } },  // GRBG
+    { { ChannelG, ChannelB }, { ChannelR, ChannelG } },  // GBRG
+};
+
+struct Gains
+{
+    uint16_t q8[3]; // Per output channel, 8.8 fixed point
+};
+
+Gains toGains(const BayerDemosaic::WhiteBalance& wb)
+{
+    auto q8 = [](double gain) {
+        gain = std::min(MAX_GAIN, std::max(0.0, gain));
+        return static_cast<uint16_t>(std::lround(gain * 256.0));
+    };
+
+    Gains gains;
+    gains.q8[ChannelB] = q8(wb.blue);
+    gains.q8[ChannelG] = q8(wb.green);
+    gains.q8[ChannelR] = q8(wb.red);
+    return gains;
+}
+
+inline uint8_t applyGain(unsigned value, uint16_t gainQ8)
+{
+    return static_cast<uint8_t>(std::min(255u, (value * gainQ8) >> 8));
+}
+
+inline unsigned avg(unsigned a, unsigned b)
+{
+    return (a + b + 1) >> 1;
+}
+
+inline int reflect101(int i, int size)
+{
+    if (i < 0) {
+        i = -i;
+    } else if (i >= size) {
+        i = 2 * size - 2 - i;
+    }
+    return std::min(size - 1, std::max(0, i));
+}
+
+// Which candidate gives each output channel at an even and an odd column of a row
+struct RowSources
+{
+    Source source[3][2]; // [channel][column parity]
+};
+
+RowSources rowSources(BayerDemosaic::Pattern pattern, int rowParity)
+{
+    const Channel* row = PATTERN_CHANNELS[pattern][rowParity];
+    const bool rowHasRed = (row[0] == ChannelR || row[1] == ChannelR);
+
+    RowSources sources;
+    for (int parity = 0; parity < 2; ++parity) {
+        const Channel site = row[parity];
+        for (int ch = 0; ch < 3; ++ch) {
+            Source source;
+            if (ch == site) {
+                source = SourceCenter;
+            } else if (site != ChannelG) {
+                // Red or blue site: green is all around, the other colour on the diagonals
+                source = (ch == ChannelG) ? SourceCross : SourceDiagonal;
+            } else if (ch == ChannelR) {
+                source = rowHasRed ? SourceHorizontal : SourceVertical;
+            } else {
+                source = rowHasRed ? SourceVertical : SourceHorizontal;
+            }
+            sources.source[ch][parity] = source;
+        }
+    }
+    return sources;
+}
+
+void bilinearPixelScalar(const uint8_t* up, const uint8_t* center, const uint8_t* down, int x, int width,
+                         const RowSources& sources, const Gains& gains, uint8_t* out)
+{
+    const int left = reflect101(x - 1, width);
+    const int right = reflect101(x + 1, width);
+
+    unsigned candidates[SOURCE_COUNT];
+    candidates[SourceCenter] = center[x];
+    candidates[SourceHorizontal] = avg(center[left], center[right]);
+    candidates[SourceVertical] = avg(up[x], down[x]);
+    candidates[SourceDiagonal] = avg(avg(up[left], up[right]), avg(down[left], down[right]));
+    candidates[SourceCross] = avg(candidates[SourceHorizontal], candidates[SourceVertical]);
+
+    for (int ch = 0; ch < 3; ++ch) {
+        out[ch] = applyGain(candidates[sources.source[ch][x & 1]], gains.q8[ch]);
+    }
+}
+
+void superpixelRowScalar(const uint8_t* row0, const uint8_t* row1, int x, int outWidth,
+                         BayerDemosaic::Pattern pattern, const Gains& gains, uint8_t* out)
+{
+    const Channel (&cell)[2][2] = PATTERN_CHANNELS[pattern];
+
+    for (; x < outWidth; ++x) {
+        const uint8_t samples[2][2] = { { row0[2 * x], row0[2 * x + 1] }, { row1[2 * x], row1[2 * x + 1] } };
+        unsigned values[3] = { 0, 0, 0 };
+        unsigned green[2];
+        int greenCount = 0;
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                if (cell[dy][dx] == ChannelG) {
+                    green[greenCount++] = samples[dy][dx];
+                } else {
+                    values[cell[dy][dx]] = samples[dy][dx];
+                }
+            }
+        }
+        values[ChannelG] = avg(green[0], green[1]);
+
+        for (int ch = 0; ch < 3; ++ch) {
+            out[3 * x + ch] = applyGain(values[ch], gains.q8[ch]);
+        }
+    }
+}
+
+#ifdef BAYER_DEMOSAIC_X86
+
+// pshufb masks that interleave 16 B, G and R bytes into 48 bytes of BGR:
+// output chunk c takes byte k from channel (16c + k) % 3 of pixel (16c + k) / 3
+struct InterleaveMasks
+{
+    int8_t mask[3][3][16]; // [chunk][channel][byte]
+
+    InterleaveMasks()
+    {
+        for (int chunk = 0; chunk < 3; ++chunk) {
+            for (int k = 0; k < 16; ++k) {
+                const int byte = 16 * chunk + k;
+                for (int ch = 0; ch < 3; ++ch) {
+                    mask[chunk][ch][k] = (byte % 3 == ch) ? static_cast<int8_t>(byte / 3) : static_cast<int8_t>(0x80);
+                }
+            }
+        }
+    }
+};
+
+const InterleaveMasks INTERLEAVE_MASKS;
+
+__attribute__((target("sse4.1")))
+inline __m128i gainSse41(__m128i v, __m128i gain)
+{
+    // Unpacking under a zero byte gives v << 8, mulhi then yields (v * gain) >> 8
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(zero, v), gain);
+    __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(zero, v), gain);
+    return _mm_packus_epi16(lo, hi);
+}
+
+__attribute__((target("sse4.1")))
+inline void storeBGRSse41(uint8_t* out, const __m128i channels[3])
+{
+    for (int chunk = 0; chunk < 3; ++chunk) {
+        __m128i bytes = _mm_setzero_si128();
+        for (int ch = 0; ch < 3; ++ch) {
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(INTERLEAVE_MASKS.mask[chunk][ch]));
+            bytes = _mm_or_si128(bytes, _mm_shuffle_epi8(channels[ch], mask));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * chunk), bytes);
+    }
+}
+
+__attribute__((target("sse4.1")))
+void superpixelRowSse41(const uint8_t* row0, const uint8_t* row1, int outWidth,
+                        BayerDemosaic::Pattern pattern, const Gains& gains, uint8_t* out)
+{
+    const Channel (&cell)[2][2] = PATTERN_CHANNELS[pattern];
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    __m128i gain[3];
+    for (int ch = 0; ch < 3; ++ch) {
+        gain[ch] = _mm_set1_epi16(static_cast<short>(gains.q8[ch]));
+    }
+
+    int x = 0;
+    for (; x + 16 <= outWidth; x += 16) {
+        // Split both rows into even and odd columns: planes[dy][dx]
+        __m128i planes[2][2];
+        const uint8_t* rows[2] = { row0, row1 };
+        for (int dy = 0; dy < 2; ++dy) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[dy] + 2 * x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[dy] + 2 * x + 16));
+            planes[dy][0] = _mm_packus_epi16(_mm_and_si128(a, lowBytes), _mm_and_si128(b, lowBytes));
+            planes[dy][1] = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        }
+
+        __m128i channels[3];
+        __m128i green[2];
+        int greenCount = 0;
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                if (cell[dy][dx] == ChannelG) {
+                    green[greenCount++] = planes[dy][dx];
+                } else {
+                    channels[cell[dy][dx]] = planes[dy][dx];
+                }
+            }
+        }
+        channels[ChannelG] = _mm_avg_epu8(green[0], green[1]);
+
+        for (int ch = 0; ch < 3; ++ch) {
+            channels[ch] = gainSse41(channels[ch], gain[ch]);
+        }
+        storeBGRSse41(out + 3 * x, channels);
+    }
+
+    superpixelRowScalar(row0, row1, x, outWidth, pattern, gains, out);
+}
+
+__attribute__((target("sse4.1")))
+void bilinearRowSse41(const uint8_t* up, const uint8_t* center, const uint8_t* down, int width,
+                      const RowSources& sources, const Gains& gains, uint8_t* out)
+{
+    // Lane i holds column x + i with x odd, so even lanes are odd columns
+    const __m128i oddColumnLanes = _mm_set1_epi16(0x00FF);
+    __m128i gain[3];
+    for (int ch = 0; ch < 3; ++ch) {
+        gain[ch] = _mm_set1_epi16(static_cast<short>(gains.q8[ch]));
+    }
+
+    bilinearPixelScalar(up, center, down, 0, width, sources, gains, out);
+
+    // Loads reach one column past the 16 pixels on either side
+    int x = 1;
+    for (; x + 17 <= width; x += 16) {
+        const __m128i ul = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x - 1));
+        const __m128i uc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x));
+        const __m128i ur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + x + 1));
+        const __m128i cl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x - 1));
+        const __m128i cc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x));
+        const __m128i cr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x + 1));
+        const __m128i dl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x - 1));
+        const __m128i dc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x));
+        const __m128i dr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + x + 1));
+
+        __m128i candidates[SOURCE_COUNT];
+        candidates[SourceCenter] = cc;
+        candidates[SourceHorizontal] = _mm_avg_epu8(cl, cr);
+        candidates[SourceVertical] = _mm_avg_epu8(uc, dc);
+        candidates[SourceDiagonal] = _mm_avg_epu8(_mm_avg_epu8(ul, ur), _mm_avg_epu8(dl, dr));
+        candidates[SourceCross] = _mm_avg_epu8(candidates[SourceHorizontal], candidates[SourceVertical]);
+
+        __m128i channels[3];
+        for (int ch = 0; ch < 3; ++ch) {
+            __m128i even = candidates[sources.source[ch][0]];
+            __m128i odd = candidates[sources.source[ch][1]];
+            channels[ch] = gainSse41(_mm_blendv_epi8(even, odd, oddColumnLanes), gain[ch]);
+        }
+        storeBGRSse41(out + 3 * x, channels);
+    }
+
+    for (; x < width; ++x) {
+        bilinearPixelScalar(up, center, down, x, width, sources, gains, out + 3 * x);
+    }
+}
+
+#endif
+
+void bilinearRows(const uint8_t* src, size_t srcStride, int width, int height, BayerDemosaic::Pattern pattern,
+                  const Gains& gains, uint8_t* dst, size_t dstStride, int yBegin, int yEnd,
+                  MonoDisplayMapper::SimdLevel level)
+{
+    const RowSources sources[2] = { rowSources(pattern, 0), rowSources(pattern, 1) };
+
+    for (int y = yBegin; y < yEnd; ++y) {
+        const uint8_t* up = src + srcStride * reflect101(y - 1, height);
+        const uint8_t* center = src + srcStride * y;
+        const uint8_t* down = src + srcStride * reflect101(y + 1, height);
+        uint8_t* out = dst + dstStride * y;
+
+#ifdef BAYER_DEMOSAIC_X86
+        if (level != MonoDisplayMapper::SimdScalar) {
+            bilinearRowSse41(up, center, down, width, sources[y & 1], gains, out);
+            continue;
+        }
+#else
+        (void)level;
+#endif
+        for (int x = 0; x < width; ++x) {
+            bilinearPixelScalar(up, center, down, x, width, sources[y & 1], gains, out + 3 * x);
+        }
+    }
+}
+
+} // namespace
+
+void BayerDemosaic::superpixel(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                               const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride)
+{
+    static const MonoDisplayMapper::SimdLevel level = MonoDisplayMapper::detectSimdLevel();
+    superpixel(src, srcStride, width, height, pattern, whiteBalance, dst, dstStride, level);
+}
+
+void BayerDemosaic::superpixel(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                               const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride,
+                               MonoDisplayMapper::SimdLevel level)
+{
+    const int outWidth = width / 2;
+    const int outHeight = height / 2;
+    if (outWidth <= 0 || outHeight <= 0) {
+        return;
+    }
+
+    const Gains gains = toGains(whiteBalance);
+
+    cv::parallel_for_(cv::Range(0, outHeight), [&](const cv::Range& rows) {
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uint8_t* row0 = src + srcStride * (2 * y);
+            const uint8_t* row1 = row0 + srcStride;
+            uint8_t* out = dst + dstStride * y;
+#ifdef BAYER_DEMOSAIC_X86
+            if (level != MonoDisplayMapper::SimdScalar) {
+                superpixelRowSse41(row0, row1, outWidth, pattern, gains, out);
+                continue;
+            }
+#endif
+            superpixelRowScalar(row0, row1, 0, outWidth, pattern, gains, out);
+        }
+    }, std::max(1.0, static_cast<double>(outHeight) / ROWS_PER_STRIP));
+}
+
+void BayerDemosaic::bilinear(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                             const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride)
+{
+    static const MonoDisplayMapper::SimdLevel level = MonoDisplayMapper::detectSimdLevel();
+    bilinear(src, srcStride, width, height, pattern, whiteBalance, dst, dstStride, level);
+}
+
+void BayerDemosaic::bilinear(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                             const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride,
+                             MonoDisplayMapper::SimdLevel level)
+{
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    const Gains gains = toGains(whiteBalance);
+
+    cv::parallel_for_(cv::Range(0, height), [&](const cv::Range& rows) {
+        bilinearRows(src, srcStride, width, height, pattern, gains, dst, dstStride, rows.start, rows.end, level);
+    }, std::max(1.0, static_cast<double>(height) / ROWS_PER_STRIP));
+}
+
+const char* BayerDemosaic::patternName(Pattern pattern)
+{
+    switch (pattern) {
+        case PatternRGGB: return "RGGB";
+        case PatternBGGR: return "BGGR";
+        case PatternGRBG: return "GRBG";
+        default:          return "GBRG";
+    }
+}
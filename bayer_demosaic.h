@@ -0,0 +1,55 @@
+#ifndef BAYER_DEMOSAIC_H
+#define BAYER_DEMOSAIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include "mono_display_mapper.h"
+
+// Demosaicing of 8-bit Bayer frames to interleaved BGR8, with white-balance
+// gains applied in the same pass.
+//
+// superpixel(): every 2x2 cell becomes one pixel (R, mean of both G, B), so
+//     the output is half the width and height. Cheap enough for live preview.
+// bilinear(): full resolution; missing channels are averaged from the 2 or 4
+//     nearest samples of that colour, borders are mirrored (reflect-101, which
+//     keeps the Bayer phase).
+//
+// Averages use the rounding of _mm_avg_epu8 ((a + b + 1) >> 1), gains are
+// 8.8 fixed point clamped to [0, 8], so the scalar and SSE4.1 kernels give
+// identical output. Rows are split into strips run by cv::parallel_for_.
+class BayerDemosaic
+{
+public:
+    // Colour of the top-left 2x2 cell, row by row
+    enum Pattern {
+        PatternRGGB,
+        PatternBGGR,
+        PatternGRBG,
+        PatternGBRG
+    };
+
+    struct WhiteBalance
+    {
+        double red = 1.0;
+        double green = 1.0;
+        double blue = 1.0;
+    };
+
+    // Output is (width / 2) x (height / 2), an odd last row/column is dropped
+    static void superpixel(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                           const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride);
+    static void superpixel(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                           const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride,
+                           MonoDisplayMapper::SimdLevel level);
+
+    // Output is width x height
+    static void bilinear(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                         const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride);
+    static void bilinear(const uint8_t* src, size_t srcStride, int width, int height, Pattern pattern,
+                         const WhiteBalance& whiteBalance, uint8_t* dst, size_t dstStride,
+                         MonoDisplayMapper::SimdLevel level);
+
+    static const char* patternName(Pattern pattern);
+};
+
+#endif // BAYER_DEMOSAIC_H
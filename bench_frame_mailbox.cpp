@@ -0,0 +1,197 @@
+// Contention microbenchmark: one frame producer against N readers.
+//
+// Compares the old "mutex + full-frame clone" hand-off with FrameMailbox
+// carrying shared frame handles. Reports the producer's publish latency
+// (the time the grab thread is held up) and the readers' throughput.
+//
+// Build: g++ -O2 -std=c++17 -pthread bench_frame_mailbox.cpp -o bench_frame_mailbox
+// Usage: ./bench_frame_mailbox [seconds per run] [frame bytes] [reader poll us]
+
+#include "frame_mailbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using Buffer = std::vector<uint8_t>;
+using SharedBuffer = std::shared_ptr<const Buffer>;
+
+struct RunResult
+{
+    uint64_t published = 0;
+    uint64_t reads = 0;
+    uint64_t overwritten = 0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+static void summarize(std::vector<double>& latencies, RunResult& result)
+{
+    if (latencies.empty()) {
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Us = latencies[latencies.size() / 2];
+    result.p99Us = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+}
+
+static double elapsedUs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Keep the sample buffer bounded on fast runs, the maximum is tracked separately
+static const size_t MAX_SAMPLES = 4 * 1024 * 1024;
+
+static void addSample(std::vector<double>& latencies, double us, RunResult& result)
+{
+    if (latencies.size() < MAX_SAMPLES) {
+        latencies.push_back(us);
+    }
+    result.maxUs = std::max(result.maxUs, us);
+}
+
+// Old path: the producer clones the frame into a shared cv::Mat under a mutex
+// and every reader clones it back out under the same mutex.
+static RunResult runMutexClone(int readers, double seconds, size_t frameBytes, int pollUs)
+{
+    std::mutex mutex;
+    Buffer current(frameBytes);
+    Buffer source(frameBytes, 0x5a);
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> reads(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&]() {
+            Buffer copy(frameBytes);
+            while (running.load(std::memory_order_relaxed)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::memcpy(copy.data(), current.data(), frameBytes);
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+                if (pollUs > 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(pollUs));
+                }
+            }
+        });
+    }
+
+    RunResult result;
+    std::vector<double> latencies;
+    const Clock::time_point end = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    while (Clock::now() < end) {
+        const Clock::time_point start = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::memcpy(current.data(), source.data(), frameBytes);
+        }
+        addSample(latencies, elapsedUs(start), result);
+        ++result.published;
+    }
+
+    running = false;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    result.reads = reads.load();
+    summarize(latencies, result);
+    return result;
+}
+
+// New path: the producer publishes a shared handle into the mailbox, readers
+// take a reference to the newest one.
+static RunResult runMailbox(int readers, double seconds, size_t frameBytes, int pollUs)
+{
+    FrameMailbox<SharedBuffer> mailbox(readers);
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> reads(0);
+
+    // Stand-in for the Pylon buffer pool: a fixed set of preallocated frames
+    std::vector<SharedBuffer> pool;
+    for (int i = 0; i < readers + 8; ++i) {
+        pool.push_back(std::make_shared<const Buffer>(frameBytes, 0x5a));
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&]() {
+            SharedBuffer frame;
+            uint64_t checksum = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                if (mailbox.read(frame)) {
+                    checksum += (*frame)[0];
+                    reads.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (pollUs > 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(pollUs));
+                }
+            }
+            if (checksum == 1) {
+                std::printf(" ");
+            }
+        });
+    }
+
+    RunResult result;
+    std::vector<double> latencies;
+    size_t next = 0;
+    const Clock::time_point end = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    while (Clock::now() < end) {
+        const SharedBuffer& frame = pool[next++ % pool.size()];
+        const Clock::time_point start = Clock::now();
+        mailbox.publish(frame);
+        addSample(latencies, elapsedUs(start), result);
+        ++result.published;
+    }
+
+    running = false;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    result.reads = reads.load();
+    result.overwritten = mailbox.overwrittenCount();
+    summarize(latencies, result);
+    return result;
+}
+
+static void printRow(const char* name, int readers, double seconds, const RunResult& r)
+{
+    std::printf("%-13s %7d %12.0f %12.0f %12llu %9.2f %9.2f %10.2f\n",
+                name, readers, r.published / seconds, r.reads / seconds,
+                static_cast<unsigned long long>(r.overwritten), r.p50Us, r.p99Us, r.maxUs);
+}
+
+int main(int argc, char* argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    const size_t frameBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1920 * 1200;
+    const int pollUs = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    std::printf("Frame size: %zu bytes, %.1f s per run, reader poll interval: %d us\n\n",
+                frameBytes, seconds, pollUs);
+    std::printf("%-13s %7s %12s %12s %12s %9s %9s %10s\n",
+                "method", "readers", "publish/s", "reads/s", "overwritten",
+                "p50 us", "p99 us", "max us");
+
+    for (int readers : {1, 2, 4, 8}) {
+        printRow("mutex+clone", readers, seconds, runMutexClone(readers, seconds, frameBytes, pollUs));
+        printRow("mailbox", readers, seconds, runMailbox(readers, seconds, frameBytes, pollUs));
+    }
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+// Grab strategy benchmark: delivery latency and frame drops per acquisition mode.
+//
+// Runs the Pylon camera emulator in software-trigger mode through
+// PylonFrameSource. A trigger thread fires frames at a fixed rate and notes
+// the host time of every trigger; a consumer that takes a fixed time per
+// frame (slower than the trigger rate, like a busy pipeline) receives them
+// either by polling retrieveFrame() or from the event-driven callback. For
+// every grab strategy and delivery mode it reports how many triggered frames
+// were delivered, skipped by the strategy or lost (no buffer was free, block
+// IDs missing), the trigger-to-consumer latency percentiles, and how long
+// stopping takes. Latency is matched through the stream block ID, counted
+// from a warm-up frame sent before the timed run.
+//
+// Build: g++ -O2 -std=c++17 -fPIC bench_grab_strategy.cpp pylon_frame_source.cpp pooled_buffer_factory.cpp frame_handle.cpp mono_display_mapper.cpp packed_mono_unpacker.cpp bayer_demosaic.cpp $(pkg-config --cflags --libs Qt5Gui opencv4) $(pylon-config --cflags --libs) -o bench_grab_strategy
+// Usage: ./bench_grab_strategy [frames] [trigger fps] [processing ms] [buffers]
+
+#include "pylon_frame_source.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Pylon;
+using Clock = std::chrono::steady_clock;
+
+struct RunResult
+{
+    uint64_t delivered = 0;
+    uint64_t skipped = 0;
+    uint64_t lost = 0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double stopMs = 0.0;
+};
+
+static int64_t nowNs()
+{
+    return FrameHandle::currentTimestampNs();
+}
+
+// Shared between the trigger thread and the consumer
+class Consumer
+{
+public:
+    Consumer(int frames, int processingMs)
+        : m_triggerNs(new std::atomic<int64_t>[frames])
+        , m_frames(frames)
+        , m_processingMs(processingMs)
+        , m_lastBlockId(0)
+        , m_seen(false)
+        , m_measuring(false)
+        , m_baseBlockId(0)
+        , m_delivered(0)
+    {
+        for (int i = 0; i < frames; ++i) {
+            m_triggerNs[i] = 0;
+        }
+    }
+
+    void consume(const FrameHandle &frame)
+    {
+        const int64_t now = nowNs();
+        const uint64_t blockId = frame.blockId();
+        m_lastBlockId = blockId;
+        m_seen = true;
+
+        if (m_measuring && blockId > m_baseBlockId && blockId - m_baseBlockId <= static_cast<uint64_t>(m_frames)) {
+            const int64_t triggerNs = m_triggerNs[blockId - m_baseBlockId - 1];
+            if (triggerNs > 0) {
+                m_latenciesMs.push_back((now - triggerNs) / 1e6);
+            }
+            m_delivered++;
+        }
+
+        // The pipeline stage that falls behind
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_processingMs));
+    }
+
+    // Trigger thread: warm up until a frame got through, then fire the timed run
+    void trigger(CInstantCamera *camera, double fps)
+    {
+        for (int attempt = 0; attempt < 20 && !m_seen; ++attempt) {
+            camera->ExecuteSoftwareTrigger();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200 + m_processingMs));
+        m_baseBlockId = m_lastBlockId.load();
+        m_measuring = true;
+
+        const Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        Clock::time_point next = Clock::now();
+        for (int i = 0; i < m_frames; ++i) {
+            std::this_thread::sleep_until(next);
+            next += period;
+            m_triggerNs[i] = nowNs();
+            camera->ExecuteSoftwareTrigger();
+        }
+
+        // Let the consumer drain what is still queued
+        std::this_thread::sleep_for(std::chrono::milliseconds(500 + 20 * m_processingMs));
+    }
+
+    uint64_t delivered() const { return m_delivered; }
+    std::vector<double>& latencies() { return m_latenciesMs; }
+
+private:
+    std::unique_ptr<std::atomic<int64_t>[]> m_triggerNs;
+    const int m_frames;
+    const int m_processingMs;
+    std::atomic<uint64_t> m_lastBlockId;
+    std::atomic<bool> m_seen;
+    std::atomic<bool> m_measuring;
+    std::atomic<uint64_t> m_baseBlockId;
+
+    // Consumer thread only
+    uint64_t m_delivered;
+    std::vector<double> m_latenciesMs;
+};
+
+static bool configureTrigger(CInstantCamera *camera)
+{
+    try {
+        CEnumParameter(camera->GetNodeMap(), "TriggerSelector").TrySetValue("FrameStart");
+        CEnumParameter(camera->GetNodeMap(), "TriggerMode").SetValue("On");
+        CEnumParameter(camera->GetNodeMap(), "TriggerSource").SetValue("Software");
+        return true;
+    }
+    catch (const GenericException& e) {
+        std::fprintf(stderr, "Cannot configure software trigger: %s\n", e.GetDescription());
+        return false;
+    }
+}
+
+static bool runOnce(IFrameSource::GrabStrategy strategy, bool eventDriven, int frames, double fps,
+                    int processingMs, int buffers, RunResult &result)
+{
+    PylonFrameSource source(PylonFrameSource::DeviceEmulator, QString());
+    QString error;
+    if (!source.open(error)) {
+        std::fprintf(stderr, "Cannot open the camera emulator: %s\n", error.toUtf8().constData());
+        return false;
+    }
+    if (!configureTrigger(source.getCamera())) {
+        return false;
+    }
+
+    IFrameSource::BufferConfig bufferConfig;
+    bufferConfig.count = buffers;
+    IFrameSource::AcquisitionConfig acquisition;
+    acquisition.strategy = strategy;
+    acquisition.queueSize = 2;
+
+    Consumer consumer(frames, processingMs);
+    std::atomic<bool> running(true);
+    std::thread poller;
+
+    if (eventDriven) {
+        auto callback = [&consumer](IFrameSource::RetrieveStatus status, const FrameHandle &frame, const QString &) {
+            if (status == IFrameSource::RetrieveOk) {
+                consumer.consume(frame);
+            }
+        };
+        if (!source.startGrabbingEventDriven(bufferConfig, acquisition, callback)) {
+            return false;
+        }
+    } else {
+        source.startGrabbing(bufferConfig, acquisition);
+        poller = std::thread([&]() {
+            while (running) {
+                FrameHandle frame;
+                QString retrieveError;
+                if (source.retrieveFrame(100, frame, retrieveError) == IFrameSource::RetrieveOk) {
+                    consumer.consume(frame);
+                }
+            }
+        });
+    }
+
+    consumer.trigger(source.getCamera(), fps);
+
+    const Clock::time_point stopStart = Clock::now();
+    running = false;
+    source.interruptRetrieve();
+    if (poller.joinable()) {
+        poller.join();
+    }
+    source.stopGrabbing();
+    result.stopMs = std::chrono::duration<double, std::milli>(Clock::now() - stopStart).count();
+
+    result.delivered = consumer.delivered();
+    result.skipped = source.getSkippedFrameCount();
+    result.lost = frames > static_cast<int>(result.delivered + result.skipped)
+                ? frames - result.delivered - result.skipped : 0;
+
+    std::vector<double> &latencies = consumer.latencies();
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.p50Ms = latencies[latencies.size() / 2];
+        result.p99Ms = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        result.maxMs = latencies.back();
+    }
+
+    source.close();
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const int frames = argc > 1 ? std::max(10, std::atoi(argv[1])) : 300;
+    const double fps = argc > 2 ? std::max(1.0, std::atof(argv[2])) : 100.0;
+    const int processingMs = argc > 3 ? std::max(0, std::atoi(argv[3])) : 20;
+    const int buffers = argc > 4 ? std::max(2, std::atoi(argv[4])) : 10;
+
+    // The emulator transport layer is only enumerated with PYLON_CAMEMU set
+    setenv("PYLON_CAMEMU", "1", 0);
+    PylonInitialize();
+
+    std::printf("%d frames triggered at %.0f fps, consumer takes %d ms per frame, %d buffers\n\n",
+                frames, fps, processingMs, buffers);
+    std::printf("%-16s %-8s %9s %8s %6s %9s %9s %9s %8s\n",
+                "strategy", "mode", "delivered", "skipped", "lost", "p50 ms", "p99 ms", "max ms", "stop ms");
+
+    const IFrameSource::GrabStrategy strategies[] = {
+        IFrameSource::GrabOneByOne, IFrameSource::GrabLatestImageOnly,
+        IFrameSource::GrabLatestImages, IFrameSource::GrabUpcomingImage
+    };
+
+    for (IFrameSource::GrabStrategy strategy : strategies) {
+        for (int eventDriven = 0; eventDriven < 2; ++eventDriven) {
+            RunResult result;
+            const char *mode = eventDriven ? "event" : "polling";
+            if (!runOnce(strategy, eventDriven != 0, frames, fps, processingMs, buffers, result)) {
+                std::printf("%-16s %-8s %9s\n", IFrameSource::grabStrategyName(strategy), mode, "n/a");
+                continue;
+            }
+            std::printf("%-16s %-8s %9llu %8llu %6llu %9.2f %9.2f %9.2f %8.1f\n",
+                        IFrameSource::grabStrategyName(strategy), mode,
+                        static_cast<unsigned long long>(result.delivered),
+                        static_cast<unsigned long long>(result.skipped),
+                        static_cast<unsigned long long>(result.lost),
+                        result.p50Ms, result.p99Ms, result.maxMs, result.stopMs);
+        }
+    }
+
+    PylonTerminate();
+    return 0;
+}
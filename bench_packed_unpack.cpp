@@ -0,0 +1,105 @@
+// Packed mono unpack benchmark and link bandwidth table.
+//
+// For each packed layout prints the bytes one frame takes on the link, the
+// saving against the unpacked 16-bit format of the same depth, and the frame
+// rate a link of the given throughput can carry (GigE: 125 MB/s line rate,
+// roughly 118 MB/s of image payload with jumbo frames). Then times the
+// scalar, SSE4.1 and AVX2 unpack kernels and checks them against each other.
+//
+// Build: g++ -O2 -std=c++17 bench_packed_unpack.cpp packed_mono_unpacker.cpp mono_display_mapper.cpp -o bench_packed_unpack
+// Usage: ./bench_packed_unpack [width] [height] [link MB/s] [iterations]
+
+#include "packed_mono_unpacker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv)
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 2448;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 2048;
+    const double linkMBps = argc > 3 ? std::atof(argv[3]) : 118.0;
+    const int iterations = argc > 4 ? std::atoi(argv[4]) : 20;
+
+    if (width <= 0 || height <= 0 || linkMBps <= 0.0 || iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [width] [height] [link MB/s] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const MonoDisplayMapper::SimdLevel best = MonoDisplayMapper::detectSimdLevel();
+    std::printf("%d x %d, link %.0f MB/s, best kernel on this CPU: %s\n\n",
+                width, height, linkMBps, MonoDisplayMapper::simdLevelName(best));
+
+    const double pixels = static_cast<double>(width) * height;
+    const double unpackedBytes = pixels * 2.0;
+
+    std::printf("%-14s %10s %8s %9s\n", "format", "MB/frame", "saving", "max fps");
+    std::printf("%-14s %10.2f %7.0f%% %9.1f\n", "Mono8", pixels / 1e6, 50.0, linkMBps * 1e6 / pixels);
+    std::printf("%-14s %10.2f %7.0f%% %9.1f\n", "Mono10/12/16", unpackedBytes / 1e6, 0.0,
+                linkMBps * 1e6 / unpackedBytes);
+
+    const PackedMonoUnpacker::Layout layouts[] = {
+        PackedMonoUnpacker::Mono10p, PackedMonoUnpacker::Mono12p,
+        PackedMonoUnpacker::Mono10packed, PackedMonoUnpacker::Mono12packed
+    };
+    for (PackedMonoUnpacker::Layout layout : layouts) {
+        const double bytes = static_cast<double>(PackedMonoUnpacker::rowBytes(layout, width)) * height;
+        std::printf("%-14s %10.2f %7.0f%% %9.1f\n", PackedMonoUnpacker::layoutName(layout),
+                    bytes / 1e6, 100.0 * (1.0 - bytes / unpackedBytes), linkMBps * 1e6 / bytes);
+    }
+
+    std::printf("\n%-14s %-8s %9s %10s %12s\n", "unpack", "kernel", "ms", "MPix/s", "max fps");
+
+    std::mt19937 rng(7);
+    std::vector<uint16_t> out(static_cast<size_t>(width) * height);
+    std::vector<uint16_t> reference(out.size());
+    bool exact = true;
+
+    for (PackedMonoUnpacker::Layout layout : layouts) {
+        const size_t rowBytes = PackedMonoUnpacker::rowBytes(layout, width);
+        std::vector<uint8_t> packed(rowBytes * height);
+        for (uint8_t& b : packed) {
+            b = static_cast<uint8_t>(rng());
+        }
+
+        const MonoDisplayMapper::SimdLevel levels[] = {
+            MonoDisplayMapper::SimdScalar, MonoDisplayMapper::SimdSse41, MonoDisplayMapper::SimdAvx2
+        };
+        for (MonoDisplayMapper::SimdLevel level : levels) {
+            if (level > best) {
+                continue;
+            }
+
+            // Best of five runs
+            double bestMs = 1e30;
+            for (int run = 0; run < 5; ++run) {
+                Clock::time_point start = Clock::now();
+                for (int i = 0; i < iterations; ++i) {
+                    PackedMonoUnpacker::unpack(layout, packed.data(), rowBytes, out.data(),
+                                               width * sizeof(uint16_t), width, height, level);
+                }
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+                bestMs = std::min(bestMs, ms);
+            }
+
+            std::printf("%-14s %-8s %9.3f %10.1f %12.1f\n", PackedMonoUnpacker::layoutName(layout),
+                        MonoDisplayMapper::simdLevelName(level), bestMs, pixels / bestMs / 1e3, 1e3 / bestMs);
+
+            if (level == MonoDisplayMapper::SimdScalar) {
+                reference = out;
+            } else if (out != reference) {
+                std::printf("  !! %s differs from the scalar kernel\n", MonoDisplayMapper::simdLevelName(level));
+                exact = false;
+            }
+        }
+    }
+
+    std::printf(exact ? "\nSIMD kernels match the scalar kernel\n" : "\nSIMD kernel mismatch\n");
+    return exact ? 0 : 1;
+}
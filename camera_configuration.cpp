@@ -0,0 +1,272 @@
+#include "camera_configuration.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QJsonValue>
+#include <cmath>
+
+typedef CameraParameterModel Model;
+
+void CameraConfiguration::set(Model::Parameter parameter, const QVariant &value)
+{
+    for (int i = 0; i < m_changes.size(); ++i) {
+        if (m_changes[i].parameter == parameter) {
+            m_changes.removeAt(i);
+            break;
+        }
+    }
+
+    // Behind every change it depends on, keeping the order of equal ranks
+    const int rank = dependencyRank(parameter);
+    int position = 0;
+    while (position < m_changes.size() && dependencyRank(m_changes[position].parameter) <= rank) {
+        ++position;
+    }
+    m_changes.insert(position, Change{parameter, value});
+}
+
+bool CameraConfiguration::contains(Model::Parameter parameter) const
+{
+    for (const Change &change : m_changes) {
+        if (change.parameter == parameter) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CameraConfiguration::addFeature(const QString &name, const QString &value)
+{
+    m_features.append(Feature{name, value});
+}
+
+void CameraConfiguration::clear()
+{
+    m_changes.clear();
+    m_features.clear();
+}
+
+void CameraConfiguration::addValue(const QString &name, const QString &value)
+{
+    Model::Parameter parameter;
+    if (!Model::findParameter(name, parameter)) {
+        addFeature(name, value);
+        return;
+    }
+
+    if (Model::isEnumeration(parameter)) {
+        set(parameter, value);
+        return;
+    }
+
+    bool ok = false;
+    const double number = value.toDouble(&ok);
+    if (ok) {
+        set(parameter, number);
+    } else if (value == "true" || value == "false") {
+        set(parameter, value == "true" ? 1.0 : 0.0);
+    } else {
+        // Kept as text, validate() reports it
+        set(parameter, value);
+    }
+}
+
+bool CameraConfiguration::loadJson(const QString &filePath, QString &error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull() || !document.isObject()) {
+        error = QString("%1 is not a JSON object: %2").arg(filePath, parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject object = document.object();
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        const QJsonValue value = it.value();
+        if (value.isString()) {
+            addValue(it.key(), value.toString());
+        } else if (value.isBool()) {
+            addValue(it.key(), value.toBool() ? "true" : "false");
+        } else if (value.isDouble()) {
+            addValue(it.key(), QString::number(value.toDouble(), 'g', 17));
+        } else {
+            error = QString("%1: unsupported value for %2").arg(filePath, it.key());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CameraConfiguration::loadFeatureFile(const QString &filePath, QString &error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        return false;
+    }
+
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    bool selected = false;
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString line = lines[i].trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const int separator = line.indexOf('\t');
+        if (separator <= 0) {
+            error = QString("%1:%2: expected <feature><tab><value>").arg(filePath).arg(i + 1);
+            return false;
+        }
+        const QString name = line.left(separator).trimmed();
+        const QString value = line.mid(separator + 1).trimmed();
+
+        // Once a selector shows up, features refer to the selected instance
+        // (TriggerMode per TriggerSelector, ...) and are written in file order
+        if (name.endsWith("Selector")) {
+            selected = true;
+        }
+        if (selected) {
+            addFeature(name, value);
+        } else {
+            addValue(name, value);
+        }
+    }
+    return true;
+}
+
+bool CameraConfiguration::load(const QString &filePath, QString &error)
+{
+    clear();
+    if (QFileInfo(filePath).suffix().toLower() == "json") {
+        return loadJson(filePath, error);
+    }
+    return loadFeatureFile(filePath, error);
+}
+
+bool CameraConfiguration::validate(const Model &model, QString &error) const
+{
+    for (int i = 0; i < m_changes.size(); ++i) {
+        const Change &change = m_changes[i];
+        const QString name = Model::parameterName(change.parameter);
+
+        if (change.parameter == Model::PayloadSize || change.parameter == Model::DeviceLinkSpeed) {
+            error = QString("%1 is read-only").arg(name);
+            return false;
+        }
+
+        const Model::Entry entry = model.get(change.parameter);
+        if (!entry.available) {
+            error = QString("%1 is not available on this camera").arg(name);
+            return false;
+        }
+
+        // The cached limits are stale only if a change applied before this one moves them
+        bool dependent = false;
+        for (int j = 0; j < i && !dependent; ++j) {
+            dependent = limitsDependOn(change.parameter, m_changes[j].parameter);
+        }
+        if (!checkValue(entry, change, !dependent, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CameraConfiguration::checkValue(const Model::Entry &entry, const Change &change, bool checkRange, QString &error)
+{
+    const QString name = Model::parameterName(change.parameter);
+
+    if (Model::isEnumeration(change.parameter)) {
+        // Settable entries are only known while the node is writable
+        const QString text = change.value.toString();
+        if (checkRange && !entry.entries.isEmpty() && !entry.entries.contains(text)) {
+            error = QString("%1: %2 is not one of %3").arg(name, text, entry.entries.join(", "));
+            return false;
+        }
+        return true;
+    }
+
+    bool ok = false;
+    const double value = change.value.toDouble(&ok);
+    if (!ok) {
+        error = QString("%1: %2 is not a number").arg(name, change.value.toString());
+        return false;
+    }
+
+    if (!checkRange || !entry.readable || entry.max < entry.min) {
+        return true;
+    }
+    if (value < entry.min || value > entry.max) {
+        error = QString("%1: %2 is outside %3..%4").arg(name).arg(value).arg(entry.min).arg(entry.max);
+        return false;
+    }
+    // Integer nodes only take values on their increment grid
+    if ((change.parameter == Model::Width || change.parameter == Model::Height) && entry.inc > 1.0 &&
+        std::fmod(value - entry.min, entry.inc) != 0.0) {
+        error = QString("%1: %2 is not a multiple of %3 from %4").arg(name).arg(value).arg(entry.inc).arg(entry.min);
+        return false;
+    }
+    return true;
+}
+
+bool CameraConfiguration::limitsDependOn(Model::Parameter parameter, Model::Parameter earlier)
+{
+    switch (parameter) {
+        case Model::Width:
+        case Model::Height:
+            return earlier == Model::PixelFormat || earlier == Model::ScalingFactor;
+        case Model::AcquisitionFrameRate:
+            return earlier == Model::PixelFormat || earlier == Model::ScalingFactor ||
+                   earlier == Model::Width || earlier == Model::Height || earlier == Model::ExposureTime;
+        case Model::TriggerMode:
+            return earlier == Model::TriggerSource;
+        default:
+            return false;
+    }
+}
+
+int CameraConfiguration::dependencyRank(Model::Parameter parameter)
+{
+    switch (parameter) {
+        case Model::PixelFormat:                return 0;  // Width increment, payload, frame rate limit
+        case Model::ScalingFactor:              return 1;  // Width/Height range
+        case Model::Width:
+        case Model::Height:                     return 2;  // Frame rate limit
+        case Model::ExposureAuto:               return 3;  // ExposureTime writable
+        case Model::ExposureTime:               return 4;  // Frame rate limit
+        case Model::AcquisitionFrameRateEnable: return 5;  // AcquisitionFrameRate writable
+        case Model::AcquisitionFrameRate:       return 6;
+        case Model::TriggerSource:              return 7;
+        case Model::TriggerDelay:               return 8;
+        case Model::TriggerMode:                return 9;  // Enabled once the source is set
+        default:                                return 10;
+    }
+}
+
+QString CameraConfiguration::describe(const Result &result)
+{
+    if (!result.success) {
+        return QString("Configuration failed: %1%2").arg(result.error, result.rolledBack ? " (rolled back)" : "");
+    }
+
+    QString text = QString("Configuration applied: %1 parameters").arg(result.changesApplied);
+    if (result.featuresApplied > 0 || result.featuresSkipped > 0) {
+        text += QString(", %1 features (%2 skipped)").arg(result.featuresApplied).arg(result.featuresSkipped);
+    }
+    if (result.restarted) {
+        text += QString(", acquisition down %1 ms").arg(result.downtimeNs / 1e6, 0, 'f', 1);
+    } else {
+        text += ", no restart";
+    }
+    text += QString(", %1 ms total").arg(result.durationNs / 1e6, 0, 'f', 1);
+    return text;
+}
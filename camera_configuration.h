@@ -0,0 +1,88 @@
+#ifndef CAMERA_CONFIGURATION_H
+#define CAMERA_CONFIGURATION_H
+
+#include <QList>
+#include <QString>
+#include <QVariant>
+#include "camera_parameter_model.h"
+
+// A set of parameter changes applied as one transaction by
+// BaslerCamera::applyConfiguration().
+//
+// Changes to parameters the model knows are kept in dependency order:
+// pixel format and scaling before the resolution, the resolution and
+// exposure before the frame rate they limit, enable switches before the
+// values they unlock, the trigger mode after its source and delay.
+// Other features from a Pylon .pfs file are kept as name/value strings
+// in file order (selectors included) and written after them.
+class CameraConfiguration
+{
+public:
+    struct Change
+    {
+        CameraParameterModel::Parameter parameter;
+        QVariant value;  // Number, or the entry name for enumerations
+    };
+
+    struct Feature
+    {
+        QString name;
+        QString value;
+    };
+
+    // Outcome of applyConfiguration()
+    struct Result
+    {
+        bool success = false;
+        QString error;
+        int changesApplied = 0;
+        int featuresApplied = 0;
+        int featuresSkipped = 0;     // Not present or not writable on this camera
+        bool restarted = false;      // Acquisition was stopped for the transaction
+        bool rolledBack = false;     // A write failed and earlier changes were undone
+        qint64 downtimeNs = 0;       // Acquisition stopped until it was started again
+        qint64 durationNs = 0;       // Whole transaction
+    };
+
+    // Replaces an earlier change of the same parameter
+    void set(CameraParameterModel::Parameter parameter, const QVariant &value);
+    bool contains(CameraParameterModel::Parameter parameter) const;
+    void addFeature(const QString &name, const QString &value);
+    void clear();
+
+    bool isEmpty() const { return m_changes.isEmpty() && m_features.isEmpty(); }
+    const QList<Change>& changes() const { return m_changes; }    // Dependency order
+    const QList<Feature>& features() const { return m_features; } // File order
+
+    // Flat JSON object of GenApi names to values, e.g.
+    // {"PixelFormat": "Mono12p", "Width": 1920, "AcquisitionFrameRate": 60}
+    bool loadJson(const QString &filePath, QString &error);
+    // Pylon feature file as written by CFeaturePersistence::Save()
+    bool loadFeatureFile(const QString &filePath, QString &error);
+    // By extension: .json, anything else is read as a .pfs file
+    bool load(const QString &filePath, QString &error);
+
+    // Checks every change against the cached entries before anything is
+    // written. Only ranges that an earlier change in the same transaction
+    // moves (see limitsDependOn()) wait until that change has been applied.
+    bool validate(const CameraParameterModel &model, QString &error) const;
+
+    // Checks one value against an entry read right before writing it
+    static bool checkValue(const CameraParameterModel::Entry &entry, const Change &change, bool checkRange, QString &error);
+
+    // Position in the write order, lower ranks are applied first
+    static int dependencyRank(CameraParameterModel::Parameter parameter);
+
+    // Writing earlier may change the limits or settable entries of parameter
+    static bool limitsDependOn(CameraParameterModel::Parameter parameter, CameraParameterModel::Parameter earlier);
+
+    static QString describe(const Result &result);
+
+private:
+    void addValue(const QString &name, const QString &value);
+
+    QList<Change> m_changes;
+    QList<Feature> m_features;
+};
+
+#endif // CAMERA_CONFIGURATION_H
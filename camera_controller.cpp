@@ -0,0 +1,131 @@
+#include "camera_controller.h"
+#include "frame_handle.h"
+#include <QDebug>
+
+CameraController::CameraController(QObject *parent)
+    : QObject(parent)
+    , m_busy(false)
+    , m_stop(false)
+    , m_executed(0)
+    , m_coalesced(0)
+{
+    m_thread = std::thread(&CameraController::run, this);
+}
+
+CameraController::~CameraController()
+{
+    cancelPending();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::future<bool> CameraController::post(const QString &key, Command command)
+{
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+
+    Pending pending;
+    pending.key = key;
+    pending.command = std::move(command);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Take over the promises of a command for the same key that has not run yet
+        for (auto it = m_queue.begin(); it != m_queue.end(); ++it) {
+            if (it->key == key) {
+                pending.promises = std::move(it->promises);
+                m_queue.erase(it);
+                m_coalesced.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        pending.promises.push_back(std::move(promise));
+        m_queue.push_back(std::move(pending));
+    }
+    m_wake.notify_one();
+    return future;
+}
+
+void CameraController::cancelPending()
+{
+    std::deque<Pending> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cancelled.swap(m_queue);
+    }
+
+    for (Pending &pending : cancelled) {
+        for (std::promise<bool> &promise : pending.promises) {
+            promise.set_value(false);
+        }
+        emit commandFinished(pending.key, false, "Cancelled", 0);
+    }
+    m_idle.notify_all();
+}
+
+void CameraController::waitForIdle()
+{
+    // The control thread would wait for itself
+    if (isControlThread()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+}
+
+bool CameraController::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_busy || !m_queue.empty();
+}
+
+void CameraController::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_stop) {
+            break;
+        }
+
+        Pending pending = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        const qint64 start = FrameHandle::currentTimestampNs();
+        QString error;
+        bool success = false;
+        try {
+            success = pending.command(error);
+        }
+        catch (const std::exception &e) {
+            error = QString::fromUtf8(e.what());
+            success = false;
+        }
+        const qint64 duration = FrameHandle::currentTimestampNs() - start;
+
+        m_executed.fetch_add(1, std::memory_order_relaxed);
+        for (std::promise<bool> &promise : pending.promises) {
+            promise.set_value(success);
+        }
+        if (!success) {
+            qDebug() << "[CameraController]" << pending.key << "failed:" << error;
+        }
+        emit commandFinished(pending.key, success, error, duration);
+
+        lock.lock();
+        m_busy = false;
+        if (m_queue.empty()) {
+            m_idle.notify_all();
+        }
+    }
+}
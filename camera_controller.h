@@ -0,0 +1,75 @@
+#ifndef CAMERA_CONTROLLER_H
+#define CAMERA_CONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Command queue serviced by a dedicated camera-control thread.
+//
+// Camera parameter writes (GigE register access, acquisition restarts)
+// are posted here instead of running on the GUI thread. Commands are keyed
+// by what they change: posting a key that is still waiting replaces the
+// queued command, so dragging a slider applies only the newest value. The
+// replaced commands' futures resolve with the result of the one that
+// replaced them. Commands run one at a time in the order their key was
+// last posted.
+class CameraController : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Runs on the control thread, returns false and sets error on failure
+    typedef std::function<bool(QString &error)> Command;
+
+    explicit CameraController(QObject *parent = nullptr);
+    ~CameraController();
+
+    std::future<bool> post(const QString &key, Command command);
+
+    // Queued commands fail with "Cancelled", a running one completes
+    void cancelPending();
+
+    // Blocks until nothing is queued or running
+    void waitForIdle();
+
+    // Something is queued or running
+    bool isBusy() const;
+
+    bool isControlThread() const { return std::this_thread::get_id() == m_thread.get_id(); }
+    quint64 getExecutedCount() const { return m_executed.load(std::memory_order_relaxed); }
+    quint64 getCoalescedCount() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+signals:
+    // Emitted from the control thread after every executed command
+    void commandFinished(const QString &key, bool success, const QString &error, qint64 durationNs);
+
+private:
+    struct Pending
+    {
+        QString key;
+        Command command;
+        std::vector<std::promise<bool>> promises;  // This post and the ones it replaced
+    };
+
+    void run();
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<Pending> m_queue;   // Guarded by m_mutex
+    bool m_busy;                   // Guarded by m_mutex, a command is running
+    bool m_stop;                   // Guarded by m_mutex
+    std::atomic<quint64> m_executed;
+    std::atomic<quint64> m_coalesced;
+};
+
+#endif // CAMERA_CONTROLLER_H
@@ -0,0 +1,249 @@
+#include "camera_manager.h"
+#include "pylon_frame_source.h"
+#include "thread_affinity.h"
+#include <QDir>
+
+CameraManager::CameraManager(QObject *parent)
+    : QObject(parent)
+    , m_statsTimer(new QTimer(this))
+    , m_firstCore(-1)
+{
+    m_statsTimer->setInterval(1000);
+    connect(m_statsTimer, &QTimer::timeout, this, &CameraManager::statsUpdated);
+
+    // Device enumeration needs Pylon before the first camera exists
+    if (qEnvironmentVariableIsEmpty("PYLON_CAMEMU")) {
+        qputenv("PYLON_CAMEMU", "1");
+    }
+    try {
+        PylonInitialize();
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[CameraManager] Error initializing Pylon:" << e.GetDescription();
+    }
+}
+
+CameraManager::~CameraManager()
+{
+    closeAll();
+
+    try {
+        PylonTerminate();
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[CameraManager] Error terminating Pylon:" << e.GetDescription();
+    }
+}
+
+int CameraManager::openAll(BaslerCamera::SourceType type, int maxCount)
+{
+    closeAll();
+
+    // A recording replays into one camera only
+    if (type == BaslerCamera::SourcePlayback) {
+        qDebug() << "[CameraManager] Playback is not available for multiple cameras";
+        return 0;
+    }
+
+    // Serial numbers to open, empty entries for synthetic sources
+    QStringList serials;
+    if (type == BaslerCamera::SourceSynthetic) {
+        for (int i = 0; i < qMax(1, maxCount); ++i) {
+            serials.append(QString());
+        }
+    } else {
+        const QList<PylonFrameSource::DeviceEntry> devices = PylonFrameSource::enumerateDevices(
+            type == BaslerCamera::SourceEmulator ? PylonFrameSource::DeviceEmulator : PylonFrameSource::DeviceGigE);
+        for (const PylonFrameSource::DeviceEntry &device : devices) {
+            if (maxCount > 0 && serials.size() >= maxCount) {
+                break;
+            }
+            serials.append(device.serial);
+        }
+    }
+
+    for (const QString &serial : serials) {
+        BaslerCamera *camera = new BaslerCamera(this);
+        camera->setSourceType(type);
+        camera->setDeviceSerial(serial);
+        camera->setRecorderThreadPolicy(m_recorderThreadPolicy);
+
+        if (!camera->connect()) {
+            qDebug() << "[CameraManager] Cannot open camera" << serial;
+            delete camera;
+            continue;
+        }
+
+        const int index = m_cameras.size();
+        m_cameras.append(camera);
+        m_cameraCores.append(-1);
+        connect(camera, &BaslerCamera::statusChanged, this, [this, index](const QString &status) {
+            emit statusChanged(cameraLabel(index) + ": " + status);
+        });
+    }
+
+    applyCorePlacement();
+    if (!m_recordingBasePath.isEmpty()) {
+        setRecordingPath(m_recordingBasePath);
+    }
+
+    qDebug() << "[CameraManager] Opened" << m_cameras.size() << "of" << serials.size() << "camera(s)";
+    emit statusChanged(QString("Opened %1 of %2 camera(s)").arg(m_cameras.size()).arg(serials.size()));
+    return m_cameras.size();
+}
+
+void CameraManager::closeAll()
+{
+    m_statsTimer->stop();
+
+    // Each camera stops its own grab thread and recorder on disconnect
+    for (BaslerCamera *camera : m_cameras) {
+        camera->disconnect();
+        delete camera;
+    }
+    m_cameras.clear();
+    m_cameraCores.clear();
+}
+
+void CameraManager::startAll()
+{
+    applyCorePlacement();
+    for (BaslerCamera *camera : m_cameras) {
+        camera->startGrabbing();
+    }
+    if (!m_cameras.isEmpty()) {
+        m_statsTimer->start();
+    }
+}
+
+void CameraManager::stopAll()
+{
+    for (BaslerCamera *camera : m_cameras) {
+        camera->stopGrabbing();
+    }
+    m_statsTimer->stop();
+    emit statsUpdated();
+}
+
+BaslerCamera* CameraManager::getCamera(int index) const
+{
+    return (index >= 0 && index < m_cameras.size()) ? m_cameras[index] : nullptr;
+}
+
+void CameraManager::setFirstCore(int core)
+{
+    m_firstCore = qMax(-1, core);
+    applyCorePlacement();
+}
+
+void CameraManager::setCameraCore(int index, int core)
+{
+    if (index < 0 || index >= m_cameraCores.size()) {
+        return;
+    }
+    m_cameraCores[index] = qMax(-1, core);
+    applyCorePlacement();
+}
+
+void CameraManager::setThreadPolicy(const ThreadPolicy::Config &config)
+{
+    m_threadPolicy = config;
+    applyCorePlacement();
+}
+
+void CameraManager::setRecorderThreadPolicy(const ThreadPolicy::Config &config)
+{
+    m_recorderThreadPolicy = config;
+    for (BaslerCamera *camera : m_cameras) {
+        camera->setRecorderThreadPolicy(config);
+    }
+}
+
+void CameraManager::applyCorePlacement()
+{
+    for (int i = 0; i < m_cameras.size(); ++i) {
+        int core = m_cameraCores[i];
+        if (core < 0 && m_firstCore >= 0) {
+            core = ThreadAffinity::coreForIndex(i, m_firstCore);
+        }
+
+        ThreadPolicy::Config config = m_threadPolicy;
+        if (core >= 0) {
+            config.cores = QVector<int>{core};
+        }
+        m_cameras[i]->setGrabThreadPolicy(config);
+    }
+}
+
+void CameraManager::setRecordingPath(const QString &basePath)
+{
+    m_recordingBasePath = basePath;
+    for (int i = 0; i < m_cameras.size(); ++i) {
+        QString serial = m_cameras[i]->getDeviceSerial();
+        QString subdirectory = serial.isEmpty() ? QString("camera%1").arg(i) : serial;
+        m_cameras[i]->setRecordingPath(QDir(basePath).filePath(subdirectory));
+    }
+}
+
+void CameraManager::setRecordingEnabled(bool enable)
+{
+    for (BaslerCamera *camera : m_cameras) {
+        camera->setRecordingEnabled(enable);
+    }
+}
+
+CameraManager::AggregateStats CameraManager::getAggregateStats() const
+{
+    AggregateStats stats;
+    stats.cameraCount = m_cameras.size();
+
+    for (BaslerCamera *camera : m_cameras) {
+        const double frameRate = camera->getRealTimeFrameRate();
+        if (camera->isGrabbing()) {
+            stats.grabbingCount++;
+        }
+        stats.frameRate += frameRate;
+        stats.throughput += frameRate * camera->getPayloadSize();
+        stats.frameCount += static_cast<quint64>(qMax(0, camera->getFrameCount()));
+        stats.errorCount += static_cast<quint64>(qMax(0, camera->getErrorsCount()));
+        stats.overwrittenCount += camera->getOverwrittenFrameCount();
+        stats.skippedCount += camera->getSkippedFrameCount();
+        stats.missingCount += camera->getMissingFrameCount();
+    }
+
+    return stats;
+}
+
+QString CameraManager::getSummary() const
+{
+    QStringList lines;
+    for (int i = 0; i < m_cameras.size(); ++i) {
+        BaslerCamera *camera = m_cameras[i];
+        lines.append(QString("%1: %2 fps, %3 frames, %4 errors, %5")
+                     .arg(cameraLabel(i))
+                     .arg(camera->getRealTimeFrameRate(), 0, 'f', 1)
+                     .arg(camera->getFrameCount())
+                     .arg(camera->getErrorsCount())
+                     .arg(camera->getGrabThreadPolicyReport()));
+    }
+
+    AggregateStats stats = getAggregateStats();
+    lines.append(QString("Total: %1 camera(s) (%8 grabbing), %2 fps, %3 MB/s, %4 frames, %5 errors, %6 overwritten, %7 skipped, %9 missing")
+                 .arg(stats.cameraCount)
+                 .arg(stats.frameRate, 0, 'f', 1)
+                 .arg(stats.throughput / 1e6, 0, 'f', 1)
+                 .arg(stats.frameCount)
+                 .arg(stats.errorCount)
+                 .arg(stats.overwrittenCount)
+                 .arg(stats.skippedCount)
+                 .arg(stats.grabbingCount)
+                 .arg(stats.missingCount));
+    return lines.join("\n");
+}
+
+QString CameraManager::cameraLabel(int index) const
+{
+    BaslerCamera *camera = getCamera(index);
+    QString serial = camera ? camera->getDeviceSerial() : QString();
+    return serial.isEmpty() ? QString("Camera %1").arg(index) : serial;
+}
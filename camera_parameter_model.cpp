@@ -0,0 +1,296 @@
+#include "camera_parameter_model.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <cmath>
+
+using namespace Pylon;
+
+const CameraParameterModel::Definition CameraParameterModel::s_definitions[PARAMETER_COUNT] = {
+    { "Width",                      nullptr,                   KindInteger },
+    { "Height",                     nullptr,                   KindInteger },
+    { "PixelFormat",                nullptr,                   KindEnumeration },
+    { "PayloadSize",                nullptr,                   KindInteger },
+    { "DeviceLinkSpeed",            nullptr,                   KindInteger },
+    { "ExposureTime",               "ExposureTimeAbs",         KindFloat },
+    { "ExposureAuto",               nullptr,                   KindEnumeration },
+    { "AcquisitionFrameRateEnable", nullptr,                   KindBoolean },
+    { "AcquisitionFrameRate",       "AcquisitionFrameRateAbs", KindFloat },
+    { "ScalingFactor",              nullptr,                   KindFloat },
+    { "TriggerMode",                nullptr,                   KindEnumeration },
+    { "TriggerSource",              nullptr,                   KindEnumeration },
+    { "TriggerDelay",               "TriggerDelayAbs",         KindFloat }
+};
+
+CameraParameterModel::CameraParameterModel(QObject *parent)
+    : QObject(parent)
+    , m_attached(false)
+    , m_pendingChanges(0)
+    , m_nodeReads(0)
+{
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        m_nodes[i] = nullptr;
+        m_callbacks[i] = GenApi::CallbackHandleType();
+        m_stale[i] = true;
+    }
+}
+
+CameraParameterModel::~CameraParameterModel()
+{
+    detach();
+}
+
+void CameraParameterModel::attach(CInstantCamera *camera)
+{
+    detach();
+    if (!camera || !camera->IsOpen()) {
+        return;
+    }
+
+    GenApi::INodeMap &nodeMap = camera->GetNodeMap();
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        GenApi::INode *node = nodeMap.GetNode(s_definitions[i].name);
+        if (!node && s_definitions[i].legacyName) {
+            node = nodeMap.GetNode(s_definitions[i].legacyName);
+        }
+        m_nodes[i] = node;
+
+        // Outside GenApi's lock, the callback only touches atomics anyway
+        if (node) {
+            m_callbacks[i] = GenApi::Register(node, *this, &CameraParameterModel::onNodeChanged,
+                                              GenApi::cbPostOutsideLock);
+        }
+    }
+
+    m_nodeReads = 0;
+    m_attached = true;
+    invalidateAll();
+    qDebug() << "[CameraParameterModel] Attached";
+}
+
+void CameraParameterModel::detach()
+{
+    if (!m_attached) {
+        return;
+    }
+
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        if (m_nodes[i] && m_callbacks[i]) {
+            try {
+                GenApi::Deregister(m_callbacks[i]);
+            }
+            catch (const GenericException& e) {
+                qDebug() << "[CameraParameterModel] Error deregistering callback:" << e.GetDescription();
+            }
+        }
+        m_nodes[i] = nullptr;
+        m_callbacks[i] = GenApi::CallbackHandleType();
+    }
+
+    m_attached = false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        m_entries[i] = Entry();
+        m_stale[i] = false;
+    }
+}
+
+CameraParameterModel::Entry CameraParameterModel::get(Parameter parameter) const
+{
+    // Claim the refresh before reading, an invalidation meanwhile marks it stale again
+    if (m_stale[parameter].exchange(false)) {
+        Entry entry = readNode(parameter);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[parameter] = entry;
+        return entry;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries[parameter];
+}
+
+double CameraParameterModel::value(Parameter parameter, double fallback) const
+{
+    Entry entry = get(parameter);
+    return entry.readable ? entry.value : fallback;
+}
+
+QString CameraParameterModel::text(Parameter parameter, const QString &fallback) const
+{
+    Entry entry = get(parameter);
+    return entry.readable ? entry.text : fallback;
+}
+
+CameraParameterModel::Entry CameraParameterModel::readNode(Parameter parameter) const
+{
+    Entry entry;
+    GenApi::INode *node = m_nodes[parameter];
+    if (!node) {
+        return entry;
+    }
+
+    entry.available = true;
+    m_nodeReads.fetch_add(1, std::memory_order_relaxed);
+    try {
+        switch (s_definitions[parameter].kind) {
+            case KindInteger: {
+                CIntegerParameter integer(node);
+                entry.readable = integer.IsReadable();
+                entry.writable = integer.IsWritable();
+                if (entry.readable) {
+                    entry.value = static_cast<double>(integer.GetValue());
+                    entry.min = static_cast<double>(integer.GetMin());
+                    entry.max = static_cast<double>(integer.GetMax());
+                    entry.inc = static_cast<double>(integer.GetInc());
+                }
+                break;
+            }
+            case KindFloat: {
+                CFloatParameter floating(node);
+                entry.readable = floating.IsReadable();
+                entry.writable = floating.IsWritable();
+                if (entry.readable) {
+                    entry.value = floating.GetValue();
+                    entry.min = floating.GetMin();
+                    entry.max = floating.GetMax();
+                    entry.inc = floating.HasInc() ? floating.GetInc() : 0.0;
+                }
+                break;
+            }
+            case KindBoolean: {
+                CBooleanParameter boolean(node);
+                entry.readable = boolean.IsReadable();
+                entry.writable = boolean.IsWritable();
+                if (entry.readable) {
+                    entry.value = boolean.GetValue() ? 1.0 : 0.0;
+                    entry.max = 1.0;
+                    entry.inc = 1.0;
+                }
+                break;
+            }
+            case KindEnumeration: {
+                CEnumParameter enumeration(node);
+                entry.readable = enumeration.IsReadable();
+                entry.writable = enumeration.IsWritable();
+                if (entry.readable) {
+                    entry.text = QString::fromUtf8(enumeration.GetValue().c_str());
+                }
+                if (entry.writable) {
+                    StringList_t settable;
+                    enumeration.GetSettableValues(settable);
+                    for (const auto &name : settable) {
+                        entry.entries.append(QString::fromUtf8(name.c_str()));
+                    }
+                }
+                break;
+            }
+        }
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[CameraParameterModel] Error reading" << parameterName(parameter) << ":" << e.GetDescription();
+        entry.readable = false;
+    }
+    return entry;
+}
+
+void CameraParameterModel::setValue(Parameter parameter, double value)
+{
+    GenApi::INode *node = m_nodes[parameter];
+    switch (s_definitions[parameter].kind) {
+        case KindInteger:
+            CIntegerParameter(node).SetValue(static_cast<int64_t>(std::llround(value)));
+            break;
+        case KindFloat:
+            CFloatParameter(node).SetValue(value);
+            break;
+        case KindBoolean:
+            CBooleanParameter(node).SetValue(value != 0.0);
+            break;
+        case KindEnumeration:
+            CEnumParameter(node).SetIntValue(static_cast<int64_t>(value));
+            break;
+    }
+
+    // The node callback does the same, this covers transports that do not fire it
+    invalidate(parameter);
+}
+
+void CameraParameterModel::setText(Parameter parameter, const QString &value)
+{
+    CEnumParameter(m_nodes[parameter]).SetValue(value.toUtf8().constData());
+    invalidate(parameter);
+}
+
+void CameraParameterModel::invalidate(Parameter parameter)
+{
+    m_stale[parameter] = true;
+    markChanged(1u << parameter);
+}
+
+void CameraParameterModel::markStale(Parameter parameter)
+{
+    m_stale[parameter] = true;
+}
+
+void CameraParameterModel::invalidateAll()
+{
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        m_stale[i] = true;
+    }
+    markChanged((1u << PARAMETER_COUNT) - 1);
+}
+
+void CameraParameterModel::refresh()
+{
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        if (m_stale[i].load() && m_nodes[i]) {
+            get(static_cast<Parameter>(i));
+        }
+    }
+}
+
+void CameraParameterModel::markChanged(quint32 mask)
+{
+    // Only the first change since the last signal schedules one
+    if (m_pendingChanges.fetch_or(mask) != 0) {
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this]() {
+        const quint32 changed = m_pendingChanges.exchange(0);
+        if (changed != 0) {
+            emit parametersChanged(changed);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void CameraParameterModel::onNodeChanged(GenApi::INode *node)
+{
+    // Any thread that wrote to the node map
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        if (m_nodes[i] == node) {
+            invalidate(static_cast<Parameter>(i));
+            return;
+        }
+    }
+}
+
+const char* CameraParameterModel::parameterName(Parameter parameter)
+{
+    return (parameter >= 0 && parameter < PARAMETER_COUNT) ? s_definitions[parameter].name : "Unknown";
+}
+
+bool CameraParameterModel::findParameter(const QString &name, Parameter &parameter)
+{
+    for (int i = 0; i < PARAMETER_COUNT; ++i) {
+        const Definition &definition = s_definitions[i];
+        if (name == definition.name || (definition.legacyName && name == definition.legacyName)) {
+            parameter = static_cast<Parameter>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CameraParameterModel::isEnumeration(Parameter parameter)
+{
+    return parameter >= 0 && parameter < PARAMETER_COUNT && s_definitions[parameter].kind == KindEnumeration;
+}
@@ -0,0 +1,137 @@
+#ifndef CAMERA_PARAMETER_MODEL_H
+#define CAMERA_PARAMETER_MODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <mutex>
+
+// Basler Pylon includes
+#include <pylon/PylonIncludes.h>
+
+// Cached view of the GenApi parameters BaslerCamera works with.
+//
+// attach() resolves every node once and registers a GenApi callback on it.
+// Values, limits and settable enumeration entries are read from the camera
+// the first time they are asked for and then served from the cache until
+// GenApi invalidates the node: a write, or a write to a node it depends on
+// (Width changing the PayloadSize, PixelFormat changing the frame rate
+// limits, ...). Refreshing the UI then costs no register access at all.
+// Values the camera changes on its own (auto functions) are not
+// invalidated by GenApi; call markStale() before reading those.
+//
+// Callbacks only mark entries stale and are coalesced into one
+// parametersChanged() signal, delivered on the model's thread. The cache
+// lock is never held while a node is accessed, so GenApi's own lock and
+// ours cannot deadlock.
+class CameraParameterModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Parameter {
+        Width,
+        Height,
+        PixelFormat,
+        PayloadSize,
+        DeviceLinkSpeed,
+        ExposureTime,
+        ExposureAuto,
+        AcquisitionFrameRateEnable,
+        AcquisitionFrameRate,
+        ScalingFactor,
+        TriggerMode,
+        TriggerSource,
+        TriggerDelay,
+        PARAMETER_COUNT
+    };
+
+    struct Entry
+    {
+        bool available = false;  // The camera has this node
+        bool readable = false;
+        bool writable = false;
+        double value = 0.0;      // Integer, float and boolean nodes
+        double min = 0.0;
+        double max = 0.0;
+        double inc = 0.0;
+        QString text;            // Enumeration nodes: current entry
+        QStringList entries;     // Enumeration nodes: entries settable right now
+    };
+
+    explicit CameraParameterModel(QObject *parent = nullptr);
+    ~CameraParameterModel();
+
+    // Resolve the nodes of an open camera, nullptr detaches
+    void attach(Pylon::CInstantCamera *camera);
+    void detach();
+    bool isAttached() const { return m_attached; }
+
+    // Cached entry, read from the node only if it was invalidated.
+    // An entry that cannot be read comes back with readable = false.
+    Entry get(Parameter parameter) const;
+    double value(Parameter parameter, double fallback) const;
+    QString text(Parameter parameter, const QString &fallback) const;
+
+    // Write through the resolved node. Throws GenericException like the
+    // Pylon parameter classes (also when the node does not exist).
+    void setValue(Parameter parameter, double value);
+    void setText(Parameter parameter, const QString &value);
+
+    void invalidate(Parameter parameter);
+    void invalidateAll();
+
+    // Like invalidate() without parametersChanged(), for a reader that
+    // polls a value the camera changes on its own
+    void markStale(Parameter parameter);
+
+    // Read every invalidated entry now, so the thread that wrote pays for
+    // the register access instead of the next reader
+    void refresh();
+
+    // Node reads since attach(), to see what the cache saves
+    quint64 getNodeReadCount() const { return m_nodeReads.load(std::memory_order_relaxed); }
+
+    static const char* parameterName(Parameter parameter);
+    // Accepts the legacy GigE names as well (ExposureTimeAbs, ...)
+    static bool findParameter(const QString &name, Parameter &parameter);
+    static bool isEnumeration(Parameter parameter);
+
+signals:
+    // One bit per Parameter whose entry was invalidated
+    void parametersChanged(quint32 mask);
+
+private:
+    enum Kind {
+        KindInteger,
+        KindFloat,
+        KindBoolean,
+        KindEnumeration
+    };
+
+    struct Definition
+    {
+        const char *name;
+        const char *legacyName;  // Pre-SFNC GigE name, nullptr if none
+        Kind kind;
+    };
+
+    static const Definition s_definitions[PARAMETER_COUNT];
+
+    Entry readNode(Parameter parameter) const;
+    void markChanged(quint32 mask);
+    void onNodeChanged(GenApi::INode *node);
+
+    GenApi::INode *m_nodes[PARAMETER_COUNT];
+    GenApi::CallbackHandleType m_callbacks[PARAMETER_COUNT];
+    bool m_attached;
+
+    mutable std::mutex m_mutex;                        // Guards m_entries only
+    mutable Entry m_entries[PARAMETER_COUNT];
+    mutable std::atomic<bool> m_stale[PARAMETER_COUNT];
+    std::atomic<quint32> m_pendingChanges;             // Not yet signalled
+    mutable std::atomic<quint64> m_nodeReads;
+};
+
+#endif // CAMERA_PARAMETER_MODEL_H
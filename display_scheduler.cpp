@@ -0,0 +1,100 @@
+#include "display_scheduler.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <QScreen>
+
+DisplayScheduler::DisplayScheduler(BaslerCamera *camera, QWidget *window, QObject *parent)
+    : QObject(parent)
+    , m_camera(camera)
+    , m_window(window)
+    , m_timer(new QTimer(this))
+    , m_active(true)
+    , m_pending(false)
+    , m_lastRenderNs(0)
+    , m_lastFrameId(-1)
+    , m_lastTimestampNs(0)
+    , m_renderedCount(0)
+    , m_coalescedCount(0)
+    , m_skippedCount(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &DisplayScheduler::render);
+
+    // Runs on the grab thread, must not touch anything but atomics
+    connect(m_camera, &BaslerCamera::imageUpdated, this, &DisplayScheduler::notifyFrameReady, Qt::DirectConnection);
+}
+
+void DisplayScheduler::notifyFrameReady()
+{
+    // Only the first frame since the last render posts to the GUI thread
+    if (m_pending.exchange(true)) {
+        m_coalescedCount++;
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this]() { scheduleRender(); }, Qt::QueuedConnection);
+}
+
+void DisplayScheduler::setActive(bool active)
+{
+    if (active == m_active) {
+        return;
+    }
+    m_active = active;
+    qDebug() << "[DisplayScheduler]" << (active ? "Resumed" : "Paused, window not visible");
+
+    if (active) {
+        if (m_pending) {
+            scheduleRender();
+        }
+    } else {
+        m_timer->stop();
+    }
+}
+
+double DisplayScheduler::getRefreshRate() const
+{
+    QScreen *screen = m_window ? m_window->screen() : nullptr;
+    double rate = screen ? screen->refreshRate() : 0.0;
+    return rate > 1.0 ? rate : DEFAULT_REFRESH_RATE;
+}
+
+void DisplayScheduler::resetCounters()
+{
+    m_renderedCount = 0;
+    m_coalescedCount = 0;
+    m_skippedCount = 0;
+}
+
+void DisplayScheduler::scheduleRender()
+{
+    if (!m_active || m_timer->isActive()) {
+        return;
+    }
+
+    // Render in the next refresh slot after the previous render
+    const qint64 intervalNs = static_cast<qint64>(1e9 / getRefreshRate());
+    const qint64 waitNs = m_lastRenderNs + intervalNs - FrameHandle::currentTimestampNs();
+    m_timer->start(waitNs > 0 ? static_cast<int>((waitNs + 999999) / 1000000) : 0);
+}
+
+void DisplayScheduler::render()
+{
+    // setActive(true) schedules the pending frame again
+    if (!m_active || !m_pending.exchange(false)) {
+        return;
+    }
+
+    FrameHandle frame = m_camera->getFrame();
+    if (frame.isEmpty() || (frame.frameId() == m_lastFrameId && frame.timestampNs() == m_lastTimestampNs)) {
+        m_skippedCount++;
+        return;
+    }
+
+    m_lastFrameId = frame.frameId();
+    m_lastTimestampNs = frame.timestampNs();
+    m_lastRenderNs = FrameHandle::currentTimestampNs();
+    m_renderedCount++;
+
+    emit frameReady(frame);
+}
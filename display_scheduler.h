@@ -0,0 +1,68 @@
+#ifndef DISPLAY_SCHEDULER_H
+#define DISPLAY_SCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QWidget>
+#include <atomic>
+#include "basler_camera.h"
+
+// Paces the display to the screen refresh rate.
+//
+// BaslerCamera::imageUpdated is connected directly, so every new frame only
+// sets a flag on the grab thread; the first frame after a render also queues
+// one call to the GUI thread, which arms a single-shot timer for the next
+// refresh slot. When it fires the newest frame is taken from the camera and
+// frameReady() is emitted, at most once per refresh interval. Frames that
+// arrive meanwhile are coalesced into that render, a frame that was already
+// rendered is skipped, and nothing is rendered while the window is
+// minimized or hidden (setActive(false)).
+class DisplayScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    DisplayScheduler(BaslerCamera *camera, QWidget *window, QObject *parent = nullptr);
+
+    // Called from the grab thread for every new frame
+    void notifyFrameReady();
+
+    // Inactive while the window cannot be seen, a pending frame is rendered on reactivation
+    void setActive(bool active);
+    bool isActive() const { return m_active; }
+
+    // Refresh rate of the window's screen, 60 Hz if unknown
+    double getRefreshRate() const;
+
+    // Counters
+    quint64 getRenderedCount() const { return m_renderedCount; }
+    quint64 getCoalescedCount() const { return m_coalescedCount; }
+    quint64 getSkippedCount() const { return m_skippedCount; }
+    void resetCounters();
+
+signals:
+    // Emitted on the GUI thread with the frame to display
+    void frameReady(const FrameHandle &frame);
+
+private:
+    void scheduleRender();
+    void render();
+
+    BaslerCamera *m_camera;
+    QWidget *m_window;
+    QTimer *m_timer;
+    bool m_active;
+
+    std::atomic<bool> m_pending;      // A frame arrived since the last render
+    qint64 m_lastRenderNs;
+    int64_t m_lastFrameId;
+    int64_t m_lastTimestampNs;
+
+    std::atomic<quint64> m_renderedCount;
+    std::atomic<quint64> m_coalescedCount;  // Notifications folded into a later render
+    std::atomic<quint64> m_skippedCount;    // Renders dropped because the frame had not changed
+
+    static constexpr double DEFAULT_REFRESH_RATE = 60.0;
+};
+
+#endif // DISPLAY_SCHEDULER_H
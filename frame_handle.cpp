@@ -0,0 +1,458 @@
+#include "frame_handle.h"
+#include "packed_mono_unpacker.h"
+#include <QDebug>
+#include <chrono>
+
+using namespace Pylon;
+
+// Unpacker layout of a packed mono format
+static bool packedLayout(EPixelType pixelType, PackedMonoUnpacker::Layout &layout)
+{
+    switch (pixelType) {
+        case PixelType_Mono10p:
+            layout = PackedMonoUnpacker::Mono10p;
+            return true;
+        case PixelType_Mono12p:
+            layout = PackedMonoUnpacker::Mono12p;
+            return true;
+        case PixelType_Mono10packed:
+            layout = PackedMonoUnpacker::Mono10packed;
+            return true;
+        case PixelType_Mono12packed:
+            layout = PackedMonoUnpacker::Mono12packed;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Demosaic pattern of a Bayer format
+static bool bayerPattern(EPixelType pixelType, BayerDemosaic::Pattern &pattern)
+{
+    switch (pixelType) {
+        case PixelType_BayerRG8:
+            pattern = BayerDemosaic::PatternRGGB;
+            return true;
+        case PixelType_BayerBG8:
+            pattern = BayerDemosaic::PatternBGGR;
+            return true;
+        case PixelType_BayerGR8:
+            pattern = BayerDemosaic::PatternGRBG;
+            return true;
+        case PixelType_BayerGB8:
+            pattern = BayerDemosaic::PatternGBRG;
+            return true;
+        default:
+            return false;
+    }
+}
+
+FrameHandle FrameHandle::fromGrabResult(const CGrabResultPtr& grabResult)
+{
+    FrameHandle frame;
+
+    if (!grabResult->GrabSucceeded()) {
+        return frame;
+    }
+
+    // Get image buffer and properties
+    uint8_t* pImageBuffer = static_cast<uint8_t*>(grabResult->GetBuffer());
+    int width = grabResult->GetWidth();
+    int height = grabResult->GetHeight();
+
+    if (width <= 0 || height <= 0 || pImageBuffer == nullptr) {
+        return frame;
+    }
+
+    auto data = std::make_shared<FrameData>();
+    data->grabResult = grabResult;
+    data->pixelType = grabResult->GetPixelType();
+    data->frameId = grabResult->GetID();
+    data->blockId = grabResult->GetBlockID();
+    data->cameraTimestamp = grabResult->GetTimeStamp();
+    data->skippedImages = static_cast<uint32_t>(grabResult->GetNumberOfSkippedImages());
+    data->timestampNs = currentTimestampNs();
+
+    if (grabResult->IsChunkDataAvailable()) {
+        // Transport layers without a timestamp in the stream leader can send it as chunk
+        if (data->cameraTimestamp == 0) {
+            CIntegerParameter chunkTimestamp(grabResult->GetChunkDataNodeMap(), "ChunkTimestamp");
+            if (chunkTimestamp.IsReadable()) {
+                data->cameraTimestamp = static_cast<uint64_t>(chunkTimestamp.GetValue());
+            }
+        }
+        CFloatParameter chunkExposureTime(grabResult->GetChunkDataNodeMap(), "ChunkExposureTime");
+        if (chunkExposureTime.IsReadable()) {
+            data->exposureTime = chunkExposureTime.GetValue();
+        }
+    }
+
+    // Packed rows cannot be wrapped, unpack them to one 16-bit word per pixel.
+    // The frame owns the result, so the grab buffer is not held any longer.
+    PackedMonoUnpacker::Layout layout;
+    if (packedLayout(data->pixelType, layout)) {
+        data->grabResult.Release();
+        data->pixelType = (PackedMonoUnpacker::bitDepth(layout) == 10) ? PixelType_Mono10 : PixelType_Mono12;
+        data->image.create(height, width, CV_16UC1);
+        PackedMonoUnpacker::unpack(layout, pImageBuffer,
+                                   PackedMonoUnpacker::rowBytes(layout, width) + grabResult->GetPaddingX(),
+                                   data->image.ptr<uint16_t>(), data->image.step, width, height);
+        frame.m_data = std::move(data);
+        return frame;
+    }
+
+    // Wrap the buffer in its native format, rows may carry padding bytes
+    switch (data->pixelType) {
+        case PixelType_Mono8:
+        case PixelType_BayerRG8:
+        case PixelType_BayerBG8:
+        case PixelType_BayerGR8:
+        case PixelType_BayerGB8:
+            data->image = cv::Mat(height, width, CV_8UC1, pImageBuffer,
+                                  width + grabResult->GetPaddingX());
+            break;
+
+        case PixelType_RGB8packed:
+        case PixelType_BGR8packed:
+            data->image = cv::Mat(height, width, CV_8UC3, pImageBuffer,
+                                  width * 3 + grabResult->GetPaddingX());
+            break;
+
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16:
+            data->image = cv::Mat(height, width, CV_16UC1, pImageBuffer,
+                                  width * 2 + grabResult->GetPaddingX());
+            break;
+
+        default:
+            // Reading an unknown layout as RGB8 shows garbage or overruns the buffer
+            qDebug() << "[FrameHandle] Unsupported pixel format:" << data->pixelType;
+            return frame;
+    }
+
+    frame.m_data = std::move(data);
+    return frame;
+}
+
+FrameHandle FrameHandle::fromImage(const cv::Mat& image, EPixelType pixelType, int64_t frameId,
+                                   uint64_t cameraTimestamp)
+{
+    FrameHandle frame;
+
+    if (image.empty()) {
+        return frame;
+    }
+
+    auto data = std::make_shared<FrameData>();
+    data->image = image;
+    data->pixelType = pixelType;
+    data->frameId = frameId;
+    data->blockId = static_cast<uint64_t>(frameId);
+    data->cameraTimestamp = cameraTimestamp;
+    data->timestampNs = currentTimestampNs();
+
+    frame.m_data = std::move(data);
+    return frame;
+}
+
+FrameHandle FrameHandle::fromRecording(const cv::Mat& image, EPixelType pixelType, int64_t frameId,
+                                       uint64_t blockId, uint64_t cameraTimestamp, uint32_t skippedImages,
+                                       double exposureTime, std::shared_ptr<const void> owner)
+{
+    FrameHandle frame;
+
+    if (image.empty()) {
+        return frame;
+    }
+
+    auto data = std::make_shared<FrameData>();
+    data->owner = std::move(owner);
+    data->image = image;
+    data->pixelType = pixelType;
+    data->frameId = frameId;
+    data->blockId = blockId;
+    data->cameraTimestamp = cameraTimestamp;
+    data->skippedImages = skippedImages;
+    data->exposureTime = exposureTime;
+    data->timestampNs = currentTimestampNs();
+
+    frame.m_data = std::move(data);
+    return frame;
+}
+
+FrameHandle FrameHandle::withImage(const cv::Mat& image) const
+{
+    FrameHandle frame;
+
+    if (!m_data || image.empty()) {
+        return frame;
+    }
+
+    auto data = std::make_shared<FrameData>(*m_data);
+    data->grabResult.Release();
+    data->owner.reset();
+    data->image = image;
+
+    frame.m_data = std::move(data);
+    return frame;
+}
+
+bool FrameHandle::isSupportedPixelType(EPixelType pixelType)
+{
+    PackedMonoUnpacker::Layout layout;
+    BayerDemosaic::Pattern pattern;
+    switch (pixelType) {
+        case PixelType_Mono8:
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16:
+        case PixelType_RGB8packed:
+        case PixelType_BGR8packed:
+            return true;
+        default:
+            return packedLayout(pixelType, layout) || bayerPattern(pixelType, pattern);
+    }
+}
+
+const cv::Mat& FrameHandle::image() const
+{
+    static const cv::Mat empty;
+    return m_data ? m_data->image : empty;
+}
+
+EPixelType FrameHandle::pixelType() const
+{
+    return m_data ? m_data->pixelType : PixelType_Undefined;
+}
+
+int64_t FrameHandle::frameId() const
+{
+    return m_data ? m_data->frameId : 0;
+}
+
+uint64_t FrameHandle::blockId() const
+{
+    return m_data ? m_data->blockId : 0;
+}
+
+uint64_t FrameHandle::cameraTimestamp() const
+{
+    return m_data ? m_data->cameraTimestamp : 0;
+}
+
+uint32_t FrameHandle::skippedImages() const
+{
+    return m_data ? m_data->skippedImages : 0;
+}
+
+double FrameHandle::exposureTime() const
+{
+    return m_data ? m_data->exposureTime : 0.0;
+}
+
+int64_t FrameHandle::timestampNs() const
+{
+    return m_data ? m_data->timestampNs : 0;
+}
+
+int64_t FrameHandle::currentTimestampNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int FrameHandle::width() const
+{
+    return m_data ? m_data->image.cols : 0;
+}
+
+int FrameHandle::height() const
+{
+    return m_data ? m_data->image.rows : 0;
+}
+
+int FrameHandle::bitDepth() const
+{
+    switch (pixelType()) {
+        case PixelType_Mono10:
+            return 10;
+        case PixelType_Mono12:
+            return 12;
+        case PixelType_Mono16:
+            return 16;
+        default:
+            return 8;
+    }
+}
+
+bool FrameHandle::isBayer() const
+{
+    BayerDemosaic::Pattern pattern;
+    return bayerPattern(pixelType(), pattern);
+}
+
+cv::Mat FrameHandle::toBGR8(const BayerDemosaic::WhiteBalance& whiteBalance) const
+{
+    cv::Mat bgr;
+
+    if (isEmpty()) {
+        return bgr;
+    }
+
+    const cv::Mat& image = m_data->image;
+
+    BayerDemosaic::Pattern pattern;
+    if (bayerPattern(m_data->pixelType, pattern)) {
+        bgr.create(image.rows, image.cols, CV_8UC3);
+        BayerDemosaic::bilinear(image.data, image.step, image.cols, image.rows, pattern, whiteBalance,
+                                bgr.data, bgr.step);
+        return bgr;
+    }
+
+    switch (m_data->pixelType) {
+        case PixelType_Mono8:
+            cv::cvtColor(image, bgr, cv::COLOR_GRAY2BGR);
+            break;
+
+        case PixelType_BGR8packed:
+            // Already in the requested format, share the buffer
+            bgr = image;
+            break;
+
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16:
+            // Convert to 8-bit first
+            cv::cvtColor(to8Bit(), bgr, cv::COLOR_GRAY2BGR);
+            break;
+
+        case PixelType_RGB8packed:
+        default:
+            cv::cvtColor(image, bgr, cv::COLOR_RGB2BGR);
+            break;
+    }
+
+    return bgr;
+}
+
+cv::Mat FrameHandle::to8Bit(const BayerDemosaic::WhiteBalance& whiteBalance) const
+{
+    cv::Mat out;
+
+    if (isEmpty()) {
+        return out;
+    }
+
+    if (isBayer()) {
+        return toBGR8(whiteBalance);
+    }
+
+    const cv::Mat& image = m_data->image;
+
+    switch (m_data->pixelType) {
+        case PixelType_Mono8:
+        case PixelType_BGR8packed:
+            // Already 8-bit, share the buffer
+            out = image;
+            break;
+
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16: {
+            // N significant bits in a 16-bit container, linear over the full range
+            MonoDisplayMapper mapper;
+            mapper.configure(bitDepth());
+            out.create(image.rows, image.cols, CV_8UC1);
+            mapper.map(image.ptr<uint16_t>(), image.step, out.data, out.step, image.cols, image.rows);
+            break;
+        }
+
+        case PixelType_RGB8packed:
+        default:
+            cv::cvtColor(image, out, cv::COLOR_RGB2BGR);
+            break;
+    }
+
+    return out;
+}
+
+QImage FrameHandle::toQImage() const
+{
+    if (isEmpty()) {
+        return QImage();
+    }
+
+    const cv::Mat& image = m_data->image;
+    const int step = static_cast<int>(image.step);
+
+    BayerDemosaic::Pattern pattern;
+    if (bayerPattern(m_data->pixelType, pattern)) {
+        // One pixel per 2x2 cell is plenty for a preview scaled to the window
+        QImage qimg(image.cols / 2, image.rows / 2, QImage::Format_BGR888);
+        BayerDemosaic::superpixel(image.data, image.step, image.cols, image.rows, pattern,
+                                  BayerDemosaic::WhiteBalance(), qimg.bits(), qimg.bytesPerLine());
+        return qimg;
+    }
+
+    switch (m_data->pixelType) {
+        case PixelType_Mono8:
+            return QImage(image.data, image.cols, image.rows, step, QImage::Format_Grayscale8);
+
+        case PixelType_Mono16:
+            return QImage(image.data, image.cols, image.rows, step, QImage::Format_Grayscale16);
+
+        case PixelType_Mono10:
+        case PixelType_Mono12: {
+            // Stretch to the 16-bit range, converting straight into the QImage
+            QImage qimg(image.cols, image.rows, QImage::Format_Grayscale16);
+            cv::Mat target(image.rows, image.cols, CV_16UC1, qimg.bits(), qimg.bytesPerLine());
+            image.convertTo(target, CV_16UC1, 65535.0 / ((1 << bitDepth()) - 1));
+            return qimg;
+        }
+
+        case PixelType_RGB8packed:
+            return QImage(image.data, image.cols, image.rows, step, QImage::Format_RGB888);
+
+        case PixelType_BGR8packed:
+            return QImage(image.data, image.cols, image.rows, step, QImage::Format_BGR888);
+
+        default: {
+            // Unknown layouts go through the BGR8 conversion
+            QImage qimg(image.cols, image.rows, QImage::Format_BGR888);
+            cv::Mat target(image.rows, image.cols, CV_8UC3, qimg.bits(), qimg.bytesPerLine());
+            toBGR8().copyTo(target);
+            return qimg;
+        }
+    }
+}
+
+QImage FrameHandle::toQImage(const MonoDisplayMapper& mapper, const BayerDemosaic::WhiteBalance& whiteBalance,
+                             bool fullResolution) const
+{
+    BayerDemosaic::Pattern pattern;
+    if (!isEmpty() && bayerPattern(m_data->pixelType, pattern)) {
+        const cv::Mat& image = m_data->image;
+        const int width = fullResolution ? image.cols : image.cols / 2;
+        const int height = fullResolution ? image.rows : image.rows / 2;
+        QImage qimg(width, height, QImage::Format_BGR888);
+        if (fullResolution) {
+            BayerDemosaic::bilinear(image.data, image.step, image.cols, image.rows, pattern, whiteBalance,
+                                    qimg.bits(), qimg.bytesPerLine());
+        } else {
+            BayerDemosaic::superpixel(image.data, image.step, image.cols, image.rows, pattern, whiteBalance,
+                                      qimg.bits(), qimg.bytesPerLine());
+        }
+        return qimg;
+    }
+
+    if (bitDepth() <= 8 || isEmpty()) {
+        return toQImage();
+    }
+
+    // Map straight into the QImage, no intermediate 8-bit Mat
+    const cv::Mat& image = m_data->image;
+    QImage qimg(image.cols, image.rows, QImage::Format_Grayscale8);
+    mapper.map(image.ptr<uint16_t>(), image.step, qimg.bits(), qimg.bytesPerLine(), image.cols, image.rows);
+    return qimg;
+}
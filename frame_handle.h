@@ -0,0 +1,134 @@
+#ifndef FRAME_HANDLE_H
+#define FRAME_HANDLE_H
+
+#include <memory>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+#include <QImage>
+#include "mono_display_mapper.h"
+#include "bayer_demosaic.h"
+
+// Basler Pylon includes
+#include <pylon/PylonIncludes.h>
+
+// Reference-counted handle to one grabbed frame.
+//
+// Copying a FrameHandle is cheap: all copies share the same frame data.
+// A frame built from a grab result keeps the CGrabResultPtr alive, so the
+// Pylon buffer is only handed back to the stream grabber when the last
+// handle referring to it is destroyed. image() is a view into that buffer
+// in the camera's native pixel format and must be treated as read-only.
+// Frames that do not come from Pylon share their cv::Mat data instead.
+class FrameHandle
+{
+public:
+    FrameHandle() = default;
+
+    // Wrap a successful grab result without copying the pixel data. Packed
+    // mono formats are unpacked into a Mono10/Mono12 image of their own and
+    // release the grab buffer right away; unsupported formats give an empty
+    // handle.
+    static FrameHandle fromGrabResult(const Pylon::CGrabResultPtr& grabResult);
+
+    // Wrap an image owned by the caller (e.g. a synthetic frame). The cv::Mat
+    // reference count keeps its pixel data alive, nothing is copied.
+    // cameraTimestamp is in the source's ticks, 0 if it has none.
+    static FrameHandle fromImage(const cv::Mat& image, Pylon::EPixelType pixelType, int64_t frameId,
+                                 uint64_t cameraTimestamp = 0);
+
+    // Replayed frame around pixel data that belongs to owner, e.g. a memory
+    // mapped sequence file. The handle keeps owner alive instead of a grab
+    // result; IDs, camera timestamp and exposure come from the recording.
+    static FrameHandle fromRecording(const cv::Mat& image, Pylon::EPixelType pixelType, int64_t frameId,
+                                     uint64_t blockId, uint64_t cameraTimestamp, uint32_t skippedImages,
+                                     double exposureTime, std::shared_ptr<const void> owner);
+
+    // Same frame (IDs, timestamps, pixel format) around other pixel data of
+    // the same size and type, e.g. a copy that must not hold on to the grab
+    // buffer. The caller keeps that data alive.
+    FrameHandle withImage(const cv::Mat& image) const;
+
+    bool isEmpty() const { return !m_data || m_data->image.empty(); }
+
+    // Formats fromGrabResult() can handle, including the packed ones
+    static bool isSupportedPixelType(Pylon::EPixelType pixelType);
+
+    // Native-format view of the frame (read-only)
+    const cv::Mat& image() const;
+    Pylon::EPixelType pixelType() const;
+    int64_t frameId() const;
+
+    // Stream block ID from the camera, consecutive unless frames were lost or
+    // skipped on the way. Frames from fromImage() use the frame ID.
+    uint64_t blockId() const;
+
+    // Camera clock when the frame was captured, in the camera's timestamp
+    // ticks (see IFrameSource::getTimestampTickFrequency()), 0 if unknown.
+    // From the grab result, or the ChunkTimestamp chunk when that is empty.
+    uint64_t cameraTimestamp() const;
+
+    // Frames the grab strategy dropped right before this one
+    uint32_t skippedImages() const;
+
+    // Exposure in microseconds from the ChunkExposureTime chunk, 0 if the
+    // camera does not send it
+    double exposureTime() const;
+
+    // Host steady-clock time in nanoseconds when the frame entered the pipeline
+    int64_t timestampNs() const;
+
+    // Current time on the clock used by timestampNs()
+    static int64_t currentTimestampNs();
+    int width() const;
+    int height() const;
+
+    // Significant bits per channel (8 for colour and Mono8, 10/12/16 for deep mono)
+    int bitDepth() const;
+
+    // BayerRG8/BG8/GR8/GB8, image() is the raw one-channel mosaic
+    bool isBayer() const;
+
+    // Explicit conversion for consumers that need 8-bit BGR.
+    // Returns a view of the shared buffer when the frame already is BGR8.
+    // Bayer frames are demosaiced at full resolution with the given gains.
+    cv::Mat toBGR8(const BayerDemosaic::WhiteBalance& whiteBalance = BayerDemosaic::WhiteBalance()) const;
+
+    // 8 bits per channel in the native layout: Mono8 and BGR8 are returned as
+    // views, Mono10/12/16 are scaled over their full range to one 8-bit
+    // channel, RGB8 is swapped to BGR, Bayer is demosaiced as in toBGR8().
+    cv::Mat to8Bit(const BayerDemosaic::WhiteBalance& whiteBalance = BayerDemosaic::WhiteBalance()) const;
+
+    // Display image in the closest QImage format (Grayscale8, Grayscale16,
+    // RGB888, BGR888). Mono8, Mono16, RGB8 and BGR8 wrap the frame buffer
+    // without copying, so the QImage must not outlive this handle; Mono10/12 are
+    // scaled into Grayscale16 images of their own, Bayer frames are demosaiced
+    // at half resolution into BGR888.
+    QImage toQImage() const;
+
+    // Same as toQImage(), except that Mono10/12/16 frames go through the
+    // mapper's window/level into a Grayscale8 image of their own, and Bayer
+    // frames get the white balance and, if asked for, the full-resolution
+    // demosaic instead of the half-resolution preview
+    QImage toQImage(const MonoDisplayMapper& mapper,
+                    const BayerDemosaic::WhiteBalance& whiteBalance = BayerDemosaic::WhiteBalance(),
+                    bool fullResolution = false) const;
+
+private:
+    struct FrameData
+    {
+        Pylon::CGrabResultPtr grabResult; // Keeps the Pylon buffer alive
+        std::shared_ptr<const void> owner; // Keeps other external pixel data alive
+        cv::Mat image;                    // View into the grab buffer or owned image
+        Pylon::EPixelType pixelType = Pylon::PixelType_Undefined;
+        int64_t frameId = 0;
+        uint64_t blockId = 0;
+        uint64_t cameraTimestamp = 0;
+        uint32_t skippedImages = 0;
+        double exposureTime = 0.0;
+        int64_t timestampNs = 0;
+    };
+
+    std::shared_ptr<const FrameData> m_data;
+};
+
+#endif // FRAME_HANDLE_H
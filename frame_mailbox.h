@@ -0,0 +1,173 @@
+#ifndef FRAME_MAILBOX_H
+#define FRAME_MAILBOX_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Lock-free "latest value" mailbox with one producer and several readers.
+//
+// This is a triple buffer generalised to N readers: there are maxReaders + 2
+// slots, so the producer always finds a slot that is neither the published
+// one nor pinned by a reader and never has to wait. A reader pins the
+// published slot, checks it is still the published one and copies the value
+// out. Values are meant to be cheap to copy (FrameHandle is a shared_ptr).
+//
+// publish() must only be called from a single thread. read() may be called
+// from any number of threads, but at most maxReaders of them concurrently,
+// otherwise publish() can run out of free slots and drops the value.
+template <typename T>
+class FrameMailbox
+{
+public:
+    explicit FrameMailbox(int maxReaders = 4)
+        : m_slotCount(maxReaders + 2)
+        , m_slots(new Slot[maxReaders + 2])
+        , m_latest(EMPTY_STATE)
+        , m_lastReadSequence(0)
+        , m_publishedCount(0)
+        , m_overwrittenCount(0)
+        , m_droppedCount(0)
+    {
+    }
+
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    // Producer: store a new value, never blocks.
+    // Returns false if every spare slot was pinned and the value was dropped.
+    bool publish(T value)
+    {
+        const uint64_t previous = m_latest.load();
+        const int latestSlot = slotOf(previous);
+
+        int target = -1;
+        for (int i = 0; i < m_slotCount; ++i) {
+            if (i != latestSlot && m_slots[i].readers.load() == 0) {
+                target = i;
+                break;
+            }
+        }
+
+        if (target < 0) {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_slots[target].value = std::move(value);
+
+        const uint64_t sequence = m_publishedCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        m_latest.store((sequence << SLOT_BITS) | static_cast<uint64_t>(target));
+
+        // The previous value is gone for good if no reader picked it up
+        if (previous != EMPTY_STATE && m_lastReadSequence.load() < sequenceOf(previous)) {
+            m_overwrittenCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    // Reader: copy the newest value. Returns false if nothing is published.
+    bool read(T& out, uint64_t* sequence = nullptr)
+    {
+        for (;;) {
+            const uint64_t state = m_latest.load();
+            if (state == EMPTY_STATE) {
+                return false;
+            }
+
+            Slot& slot = m_slots[slotOf(state)];
+            slot.readers.fetch_add(1);
+
+            // The producer may have moved on between the load and the pin
+            if (m_latest.load() != state) {
+                slot.readers.fetch_sub(1);
+                std::this_thread::yield();
+                continue;
+            }
+
+            out = slot.value;
+            slot.readers.fetch_sub(1);
+
+            const uint64_t readSequence = sequenceOf(state);
+            uint64_t lastRead = m_lastReadSequence.load(std::memory_order_relaxed);
+            while (lastRead < readSequence &&
+                   !m_lastReadSequence.compare_exchange_weak(lastRead, readSequence)) {
+            }
+
+            if (sequence) {
+                *sequence = readSequence;
+            }
+            return true;
+        }
+    }
+
+    // Reader: copy the newest value only if it is newer than lastSequence
+    bool readIfNewer(T& out, uint64_t& lastSequence)
+    {
+        if (sequence() <= lastSequence) {
+            return false;
+        }
+        return read(out, &lastSequence);
+    }
+
+    // Drop every stored value, e.g. to release camera buffers on disconnect.
+    // Must not run concurrently with publish().
+    void clear()
+    {
+        m_latest.store(EMPTY_STATE);
+        for (int i = 0; i < m_slotCount; ++i) {
+            while (m_slots[i].readers.load() != 0) {
+                std::this_thread::yield();
+            }
+            m_slots[i].value = T();
+        }
+    }
+
+    // Sequence number of the newest value, 0 if empty
+    uint64_t sequence() const { return sequenceOf(m_latest.load()); }
+
+    uint64_t publishedCount() const { return m_publishedCount.load(std::memory_order_relaxed); }
+    uint64_t overwrittenCount() const { return m_overwrittenCount.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+    void resetCounters()
+    {
+        m_overwrittenCount.store(0, std::memory_order_relaxed);
+        m_droppedCount.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // State word: sequence number in the high bits, slot index in the low byte
+    static const int SLOT_BITS = 8;
+    static const uint64_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+    static const uint64_t EMPTY_STATE = SLOT_MASK;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<int> readers{0};
+        T value;
+    };
+
+    static int slotOf(uint64_t state)
+    {
+        return state == EMPTY_STATE ? -1 : static_cast<int>(state & SLOT_MASK);
+    }
+
+    static uint64_t sequenceOf(uint64_t state)
+    {
+        return state == EMPTY_STATE ? 0 : state >> SLOT_BITS;
+    }
+
+    const int m_slotCount;
+    std::unique_ptr<Slot[]> m_slots;
+
+    alignas(64) std::atomic<uint64_t> m_latest;
+    alignas(64) std::atomic<uint64_t> m_lastReadSequence;
+    std::atomic<uint64_t> m_publishedCount;
+    std::atomic<uint64_t> m_overwrittenCount;
+    std::atomic<uint64_t> m_droppedCount;
+};
+
+#endif // FRAME_MAILBOX_H
@@ -0,0 +1,869 @@
+#include "frame_recorder.h"
+#include "raw_sequence.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <chrono>
+#include <opencv2/videoio.hpp>
+
+static qint64 steadyMsecs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FrameRecorder::FrameRecorder(QObject *parent)
+    : QObject(parent)
+    , m_running(false)
+    , m_recordingPath("./recorded_images")
+    , m_maxRecordedImages(100)
+    , m_nextImageIndex(0)
+    , m_queueCapacity(DEFAULT_QUEUE_CAPACITY)
+    , m_overflowPolicy(OverflowDropOldest)
+    , m_writerThreadCount(1)
+    , m_recordingFormat(FormatBmp)
+    , m_activeFormat(FormatBmp)
+    , m_videoSegmentFrames(DEFAULT_VIDEO_SEGMENT_FRAMES)
+    , m_nextTicket(0)
+    , m_nextToWrite(0)
+    , m_activeEncoders(0)
+    , m_encodeWindow(0)
+    , m_offeredCount(0)
+    , m_queuedCount(0)
+    , m_writtenCount(0)
+    , m_droppedCount(0)
+    , m_lastStatsTime(0)
+    , m_exposureTime(0.0)
+    , m_timestampTickFrequency(0.0)
+    , m_encodedCount(0)
+    , m_rawBytes(0)
+    , m_compressedBytes(0)
+    , m_encodeNs(0)
+    , m_videoFrameRate(0.0)
+    , m_writeLatency(nullptr)
+    , m_encodeTime(nullptr)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    stop();
+    waitForFinished();
+}
+
+void FrameRecorder::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    // Writers from a previous run may still be draining their queue
+    waitForFinished();
+
+    int writerCount;
+    bool compressed;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        // Create directory once instead of checking it for every frame
+        QDir dir(m_recordingPath);
+        if (!dir.exists()) {
+            dir.mkpath(".");
+        }
+
+        // A sequence or video file has one writer appending in order
+        m_activeFormat = m_recordingFormat;
+        writerCount = (m_activeFormat == FormatRawSequence || isVideoFormat(m_activeFormat)) ? 1 : m_writerThreadCount;
+        m_sequenceInfo.clear();
+        m_videoInfo.clear();
+
+        // Compressed formats: the writer threads encode, one more writes in queue order
+        compressed = isCompressedFormat(m_activeFormat);
+        m_encoded.clear();
+        m_nextTicket = 0;
+        m_nextToWrite = 0;
+        m_activeEncoders = compressed ? writerCount : 0;
+        m_encodeWindow = 2 * writerCount;
+        m_running = true;
+    }
+
+    for (int i = 0; i < writerCount; ++i) {
+        m_writers.emplace_back(&FrameRecorder::writerLoop, this);
+    }
+    if (compressed) {
+        m_writers.emplace_back(&FrameRecorder::orderedWriterLoop, this);
+    }
+
+    qDebug() << "[FrameRecorder] Started with" << writerCount << (compressed ? "encoder thread(s)" : "writer thread(s)");
+}
+
+void FrameRecorder::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+
+    // Writers finish the frames already queued, then exit
+    m_queueNotEmpty.notify_all();
+    m_queueNotFull.notify_all();
+
+    qDebug() << "[FrameRecorder] Stopped, draining" << getQueueDepth() << "queued frame(s)";
+}
+
+void FrameRecorder::waitForFinished()
+{
+    for (std::thread &writer : m_writers) {
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+    m_writers.clear();
+}
+
+bool FrameRecorder::enqueue(const FrameHandle &frame)
+{
+    if (!m_running || frame.isEmpty()) {
+        return false;
+    }
+
+    m_offeredCount++;
+
+    bool accepted = true;
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+
+        if (static_cast<int>(m_queue.size()) >= m_queueCapacity) {
+            switch (m_overflowPolicy) {
+                case OverflowBlock:
+                    m_queueNotFull.wait(lock, [this]() {
+                        return static_cast<int>(m_queue.size()) < m_queueCapacity || !m_running;
+                    });
+                    accepted = m_running;
+                    break;
+
+                case OverflowDropNewest:
+                    accepted = false;
+                    break;
+
+                case OverflowDropOldest:
+                    m_queue.pop_front();
+                    m_droppedCount++;
+                    break;
+            }
+        }
+
+        if (accepted) {
+            m_queue.push_back({frame, m_nextImageIndex});
+            m_queuedCount++;
+
+            // Wrap the file counter like the pattern_XX naming expects
+            m_nextImageIndex++;
+            if (m_nextImageIndex >= m_maxRecordedImages) {
+                m_nextImageIndex = 0;
+            }
+        } else {
+            m_droppedCount++;
+        }
+    }
+
+    if (accepted) {
+        m_queueNotEmpty.notify_one();
+    }
+
+    publishStats(false);
+    return accepted;
+}
+
+void FrameRecorder::applyThreadPolicy()
+{
+    ThreadPolicy::Applied applied = ThreadPolicy::applyToCurrentThread(getThreadPolicy());
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_threadPolicyReport = applied.description;
+    }
+    qDebug() << "[FrameRecorder] Writer thread policy:" << applied.description;
+}
+
+void FrameRecorder::writerLoop()
+{
+    applyThreadPolicy();
+
+    RecordingFormat format;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        format = m_activeFormat;
+    }
+    if (format == FormatRawSequence) {
+        writeSequence();
+        publishStats(true);
+        return;
+    }
+    if (isCompressedFormat(format)) {
+        encodeFrames();
+        return;
+    }
+    if (isVideoFormat(format)) {
+        writeVideo(format);
+        publishStats(true);
+        return;
+    }
+
+    for (;;) {
+        QueuedFrame item;
+        QString path;
+        BayerDemosaic::WhiteBalance whiteBalance;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueNotEmpty.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+
+            if (m_queue.empty()) {
+                break;
+            }
+
+            item = std::move(m_queue.front());
+            m_queue.pop_front();
+            path = m_recordingPath;
+            whiteBalance = m_whiteBalance;
+        }
+        m_queueNotFull.notify_one();
+
+        if (writeFrame(item, path, whiteBalance)) {
+            m_writtenCount++;
+            if (m_writeLatency) {
+                m_writeLatency->record(FrameHandle::currentTimestampNs() - item.frame.timestampNs());
+            }
+        } else {
+            m_droppedCount++;
+        }
+
+        publishStats(false);
+    }
+
+    publishStats(true);
+}
+
+void FrameRecorder::writeSequence()
+{
+    RawSequenceWriter writer;
+    writer.setWriteLatencyHistogram(m_writeLatency);
+
+    const QString started = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    int fileNumber = 0;
+    quint64 written = 0;   // Writer totals already added to the counters
+    quint64 failed = 0;
+    bool openFailed = false;   // A file could not be started, the recording stops there
+    QString error;
+
+    for (;;) {
+        std::vector<FrameHandle> batch;
+        QString path;
+        int framesPerFile;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueNotEmpty.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+
+            if (m_queue.empty()) {
+                break;
+            }
+
+            // Take what has piled up, so it goes out in one write
+            while (!m_queue.empty() && static_cast<int>(batch.size()) < RawSequenceWriter::MAX_BATCH_RECORDS) {
+                batch.push_back(std::move(m_queue.front().frame));
+                m_queue.pop_front();
+            }
+            path = m_recordingPath;
+            framesPerFile = m_maxRecordedImages;
+        }
+        m_queueNotFull.notify_all();
+
+        for (const FrameHandle &frame : batch) {
+            // Opening again would most likely fail the same way, for every frame
+            if (openFailed) {
+                m_droppedCount++;
+                continue;
+            }
+
+            // New file at the start, when the format changes and when the current one is full
+            if (!writer.matches(frame) || writer.isFull()) {
+                if (writer.isOpen() && !writer.close(error)) {
+                    qDebug() << "[FrameRecorder]" << error;
+                }
+
+                const QString filePath = QString("%1/sequence_%2_%3.bseq")
+                                         .arg(path, started)
+                                         .arg(fileNumber, 3, 10, QChar('0'));
+                if (!writer.open(filePath, frame, framesPerFile, m_timestampTickFrequency, error)) {
+                    qDebug() << "[FrameRecorder] Failed to start sequence:" << error << ", dropping the rest of the recording";
+                    openFailed = true;
+                    m_droppedCount++;
+                    {
+                        std::lock_guard<std::mutex> lock(m_queueMutex);
+                        m_sequenceInfo = QString("Cannot open %1 (%2), frames are dropped")
+                                         .arg(QFileInfo(filePath).fileName(), error);
+                    }
+                    publishStats(true);
+                    continue;
+                }
+                fileNumber++;
+
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_sequenceInfo = QString("%1 (%2)").arg(QFileInfo(filePath).fileName(),
+                                                        writer.isDirect() ? "O_DIRECT" : "buffered");
+            }
+
+            const double exposureTime = frame.exposureTime() > 0.0 ? frame.exposureTime() : m_exposureTime.load();
+            if (!writer.append(frame, exposureTime, error)) {
+                qDebug() << "[FrameRecorder] Failed to record frame:" << error;
+            }
+        }
+
+        if (!writer.flush(error)) {
+            qDebug() << "[FrameRecorder] Failed to write frames:" << error;
+        }
+
+        m_writtenCount += writer.framesWritten() - written;
+        m_droppedCount += writer.framesFailed() - failed;
+        written = writer.framesWritten();
+        failed = writer.framesFailed();
+        publishStats(false);
+    }
+
+    if (writer.isOpen() && !writer.close(error)) {
+        qDebug() << "[FrameRecorder]" << error;
+    }
+    m_writtenCount += writer.framesWritten() - written;
+    m_droppedCount += writer.framesFailed() - failed;
+}
+
+void FrameRecorder::writeVideo(RecordingFormat format)
+{
+    const bool mjpeg = (format == FormatVideoMjpeg);
+    const int fourcc = mjpeg ? cv::VideoWriter::fourcc('M', 'J', 'P', 'G') : cv::VideoWriter::fourcc('F', 'F', 'V', '1');
+    // OpenCV's own MJPEG encoder needs no FFmpeg, FFV1 does
+    const int backend = mjpeg ? cv::CAP_ANY : cv::CAP_FFMPEG;
+
+    cv::VideoWriter writer;
+    QFile timestamps;
+    QString fileName;
+    cv::Size size;
+    bool color = false;
+    int segmentFrames = 0;   // Frames in the current file
+
+    const QString started = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    int fileNumber = 0;
+    bool failed = false;     // A segment could not be opened, the recording stops there
+
+    // Rates over about a second, measured by this thread
+    int64_t rateStart = FrameHandle::currentTimestampNs();
+    quint64 rateOffered = m_offeredCount;
+    quint64 encoded = 0;
+    quint64 rateEncoded = 0;
+
+    for (;;) {
+        QueuedFrame item;
+        QString path;
+        int framesPerFile;
+        BayerDemosaic::WhiteBalance whiteBalance;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueNotEmpty.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+
+            if (m_queue.empty()) {
+                break;
+            }
+
+            item = std::move(m_queue.front());
+            m_queue.pop_front();
+            path = m_recordingPath;
+            framesPerFile = m_videoSegmentFrames;
+            whiteBalance = m_whiteBalance;
+        }
+        m_queueNotFull.notify_one();
+
+        // Opening again would most likely fail the same way, for every frame
+        if (failed) {
+            m_droppedCount++;
+            publishStats(false);
+            continue;
+        }
+
+        // Same 8-bit image as the BMP format
+        const cv::Mat image = item.frame.to8Bit(whiteBalance);
+
+        // New file at the start, when the size or colour changes and when the segment is full
+        if (!writer.isOpened() || image.size() != size || (image.channels() == 3) != color ||
+            (framesPerFile > 0 && segmentFrames >= framesPerFile)) {
+            writer.release();
+            timestamps.close();
+
+            const QString filePath = QString("%1/segment_%2_%3.%4")
+                                     .arg(path, started)
+                                     .arg(fileNumber, 3, 10, QChar('0'))
+                                     .arg(mjpeg ? "avi" : "mkv");
+            const double frameRate = m_videoFrameRate > 0.0 ? m_videoFrameRate.load() : DEFAULT_VIDEO_FRAME_RATE;
+            size = image.size();
+            color = (image.channels() == 3);
+            segmentFrames = 0;
+            if (!writer.open(filePath.toStdString(), backend, fourcc, frameRate, size, color)) {
+                qDebug() << "[FrameRecorder] Failed to open video" << filePath << "with" << formatName(format)
+                         << ", dropping the rest of the recording";
+                failed = true;
+                m_droppedCount++;
+                {
+                    std::lock_guard<std::mutex> lock(m_queueMutex);
+                    m_videoInfo = QString("Cannot open %1 (%2 codec missing or path not writable), frames are dropped")
+                                  .arg(QFileInfo(filePath).fileName(), formatName(format));
+                }
+                publishStats(true);
+                continue;
+            }
+            fileNumber++;
+            qDebug() << "[FrameRecorder] Started video segment" << filePath << size.width << "x" << size.height
+                     << "at" << frameRate << "fps";
+
+            // The container only keeps the nominal rate, the real timing goes beside it
+            timestamps.setFileName(QFileInfo(filePath).path() + "/" + QFileInfo(filePath).completeBaseName() + ".csv");
+            if (timestamps.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                timestamps.write("frame,frame_id,block_id,camera_timestamp,host_timestamp_ns\n");
+            }
+            fileName = QFileInfo(filePath).fileName();
+        }
+
+        const int64_t start = FrameHandle::currentTimestampNs();
+        writer.write(image);
+        const int64_t encodeNs = FrameHandle::currentTimestampNs() - start;
+        if (m_encodeTime) {
+            m_encodeTime->record(encodeNs);
+        }
+        if (timestamps.isOpen()) {
+            timestamps.write(QString("%1,%2,%3,%4,%5\n").arg(segmentFrames).arg(item.frame.frameId())
+                             .arg(item.frame.blockId()).arg(item.frame.cameraTimestamp())
+                             .arg(item.frame.timestampNs()).toUtf8());
+        }
+        segmentFrames++;
+        encoded++;
+        m_writtenCount++;
+        if (m_writeLatency) {
+            m_writeLatency->record(FrameHandle::currentTimestampNs() - item.frame.timestampNs());
+        }
+
+        // Encode fps below the acquisition fps means the queue is filling up
+        const int64_t now = FrameHandle::currentTimestampNs();
+        if (now - rateStart >= 1000000000LL) {
+            const double seconds = (now - rateStart) / 1e9;
+            const quint64 offered = m_offeredCount;
+            const quint64 offeredSince = offered >= rateOffered ? offered - rateOffered : offered;   // Counters reset
+            const double encodeFps = (encoded - rateEncoded) / seconds;
+            const double acquisitionFps = offeredSince / seconds;
+            const bool behind = encodeFps < acquisitionFps * 0.98 && getQueueDepth() > 0;
+
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_videoInfo = QString("%1, encode %2 fps / acquisition %3 fps%4")
+                          .arg(fileName)
+                          .arg(encodeFps, 0, 'f', 1)
+                          .arg(acquisitionFps, 0, 'f', 1)
+                          .arg(behind ? ", falling behind" : "");
+            rateStart = now;
+            rateOffered = offered;
+            rateEncoded = encoded;
+        }
+
+        publishStats(false);
+    }
+
+    // Writes the index of the last segment
+    writer.release();
+}
+
+void FrameRecorder::encodeFrames()
+{
+    for (;;) {
+        QueuedFrame item;
+        quint64 ticket;
+        RecordingFormat format;
+        {
+            // Only take a frame within the window, so one slow frame cannot pile up encoded files behind it
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueNotEmpty.wait(lock, [this]() {
+                const bool windowOpen = m_nextTicket - m_nextToWrite < static_cast<quint64>(m_encodeWindow);
+                return (!m_queue.empty() && windowOpen) || (m_queue.empty() && !m_running);
+            });
+
+            if (m_queue.empty()) {
+                break;
+            }
+
+            item = std::move(m_queue.front());
+            m_queue.pop_front();
+            ticket = m_nextTicket++;
+            format = m_activeFormat;
+        }
+        m_queueNotFull.notify_one();
+
+        EncodedFrame encoded;
+        encoded.imageIndex = item.imageIndex;
+        encoded.timestampNs = item.frame.timestampNs();
+
+        const int64_t start = FrameHandle::currentTimestampNs();
+        if (encodeFrame(item.frame, format, encoded.data)) {
+            const int64_t encodeNs = FrameHandle::currentTimestampNs() - start;
+            m_encodedCount++;
+            m_rawBytes += RawSequence::payloadSize(item.frame);
+            m_compressedBytes += encoded.data.size();
+            m_encodeNs += encodeNs;
+            if (m_encodeTime) {
+                m_encodeTime->record(encodeNs);
+            }
+        } else {
+            qDebug() << "[FrameRecorder] Failed to encode frame" << item.frame.frameId();
+            encoded.data.clear();
+        }
+
+        // The grab buffer goes back before the file waits for its turn
+        item.frame = FrameHandle();
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_encoded.emplace(ticket, std::move(encoded));
+        }
+        m_encodedReady.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_activeEncoders--;
+    }
+    m_encodedReady.notify_one();
+}
+
+void FrameRecorder::orderedWriterLoop()
+{
+    applyThreadPolicy();
+
+    for (;;) {
+        EncodedFrame encoded;
+        QString path;
+        RecordingFormat format;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_encodedReady.wait(lock, [this]() {
+                return m_encoded.count(m_nextToWrite) > 0 || m_activeEncoders == 0;
+            });
+
+            // Every frame an encoder took has an entry, failed ones included
+            auto next = m_encoded.find(m_nextToWrite);
+            if (next == m_encoded.end()) {
+                break;
+            }
+
+            encoded = std::move(next->second);
+            m_encoded.erase(next);
+            m_nextToWrite++;
+            path = m_recordingPath;
+            format = m_activeFormat;
+        }
+        // The window moved on
+        m_queueNotEmpty.notify_all();
+
+        if (encoded.data.empty()) {
+            m_droppedCount++;
+            publishStats(false);
+            continue;
+        }
+
+        QString filename = QString("%1/pattern_%2.%3")
+                           .arg(path)
+                           .arg(encoded.imageIndex, 2, 10, QChar('0'))
+                           .arg(format == FormatPng ? "png" : "tif");
+        QFile file(filename);
+        const qint64 size = static_cast<qint64>(encoded.data.size());
+        if (file.open(QIODevice::WriteOnly) &&
+            file.write(reinterpret_cast<const char*>(encoded.data.data()), size) == size) {
+            m_writtenCount++;
+            if (m_writeLatency) {
+                m_writeLatency->record(FrameHandle::currentTimestampNs() - encoded.timestampNs);
+            }
+        } else {
+            qDebug() << "[FrameRecorder] Failed to save image:" << filename;
+            m_droppedCount++;
+        }
+
+        publishStats(false);
+    }
+
+    publishStats(true);
+}
+
+bool FrameRecorder::encodeFrame(const FrameHandle &frame, RecordingFormat format, std::vector<uchar> &data)
+{
+    // Lossless: mono keeps its depth (Mono10/12 in 16 bits), Bayer stays a
+    // mosaic, only RGB8 is swapped to the BGR order the encoders expect
+    const cv::Mat image = (frame.pixelType() == Pylon::PixelType_RGB8packed) ? frame.to8Bit() : frame.image();
+
+    switch (format) {
+        case FormatPng:
+            return cv::imencode(".png", image, data, {cv::IMWRITE_PNG_COMPRESSION, 1});
+        case FormatTiffLzw:
+            // libtiff COMPRESSION_LZW
+            return cv::imencode(".tif", image, data, {cv::IMWRITE_TIFF_COMPRESSION, 5});
+        case FormatTiffDeflate:
+            // libtiff COMPRESSION_ADOBE_DEFLATE
+            return cv::imencode(".tif", image, data, {cv::IMWRITE_TIFF_COMPRESSION, 8});
+        default:
+            return false;
+    }
+}
+
+bool FrameRecorder::isCompressedFormat(RecordingFormat format)
+{
+    return format == FormatPng || format == FormatTiffLzw || format == FormatTiffDeflate;
+}
+
+bool FrameRecorder::isVideoFormat(RecordingFormat format)
+{
+    return format == FormatVideoMjpeg || format == FormatVideoFfv1;
+}
+
+const char* FrameRecorder::formatName(RecordingFormat format)
+{
+    switch (format) {
+        case FormatBmp:         return "BMP";
+        case FormatRawSequence: return "Raw sequence";
+        case FormatPng:         return "PNG";
+        case FormatTiffLzw:     return "TIFF LZW";
+        case FormatTiffDeflate: return "TIFF Deflate";
+        case FormatVideoMjpeg:  return "MJPEG video";
+        default:                return "FFV1 video";
+    }
+}
+
+bool FrameRecorder::writeFrame(const QueuedFrame &item, const QString &path,
+                               const BayerDemosaic::WhiteBalance &whiteBalance)
+{
+    // Generate filename with pattern_XX.bmp format
+    QString filename = QString("%1/pattern_%2.bmp")
+                       .arg(path)
+                       .arg(item.imageIndex, 2, 10, QChar('0')); // 2 digits, zero-padded
+
+    // BMP holds 8 bits per channel: Mono8 and BGR8 are saved straight from the
+    // grab buffer, deeper mono formats stay single-channel, Bayer frames are
+    // demosaiced at full resolution
+    cv::Mat image = item.frame.to8Bit(whiteBalance);
+
+    if (!cv::imwrite(filename.toStdString(), image)) {
+        qDebug() << "[FrameRecorder] Failed to save image:" << filename;
+        return false;
+    }
+
+    qDebug() << "[FrameRecorder] Image saved:" << filename;
+    return true;
+}
+
+void FrameRecorder::publishStats(bool force)
+{
+    qint64 now = steadyMsecs();
+    qint64 last = m_lastStatsTime;
+
+    if (!force && now - last < STATS_INTERVAL_MS) {
+        return;
+    }
+    if (!m_lastStatsTime.compare_exchange_strong(last, now) && !force) {
+        return; // Another thread is publishing
+    }
+
+    emit statsUpdated(m_queuedCount, m_writtenCount, m_droppedCount);
+}
+
+void FrameRecorder::setRecordingPath(const QString &path)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_recordingPath = path;
+
+    if (m_running) {
+        QDir dir(m_recordingPath);
+        if (!dir.exists()) {
+            dir.mkpath(".");
+        }
+    }
+}
+
+QString FrameRecorder::getRecordingPath() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_recordingPath;
+}
+
+void FrameRecorder::setMaxRecordedImages(int maxCount)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_maxRecordedImages = maxCount;
+    if (m_nextImageIndex >= m_maxRecordedImages) {
+        m_nextImageIndex = 0;
+    }
+}
+
+int FrameRecorder::getMaxRecordedImages() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_maxRecordedImages;
+}
+
+void FrameRecorder::setQueueCapacity(int capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queueCapacity = qMax(1, capacity);
+    }
+    m_queueNotFull.notify_all();
+}
+
+int FrameRecorder::getQueueCapacity() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_queueCapacity;
+}
+
+void FrameRecorder::setOverflowPolicy(OverflowPolicy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_overflowPolicy = policy;
+    }
+    m_queueNotFull.notify_all();
+}
+
+FrameRecorder::OverflowPolicy FrameRecorder::getOverflowPolicy() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_overflowPolicy;
+}
+
+void FrameRecorder::setWriterThreadCount(int count)
+{
+    // Takes effect the next time recording starts
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_writerThreadCount = qMax(1, count);
+}
+
+int FrameRecorder::getWriterThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_writerThreadCount;
+}
+
+void FrameRecorder::setWhiteBalance(const BayerDemosaic::WhiteBalance &whiteBalance)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_whiteBalance = whiteBalance;
+}
+
+void FrameRecorder::setRecordingFormat(RecordingFormat format)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_recordingFormat = format;
+}
+
+FrameRecorder::RecordingFormat FrameRecorder::getRecordingFormat() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_recordingFormat;
+}
+
+QString FrameRecorder::getSequenceInfo() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_sequenceInfo.isEmpty() ? QString("No sequence") : m_sequenceInfo;
+}
+
+QString FrameRecorder::getCompressionInfo() const
+{
+    const quint64 frames = m_encodedCount;
+    const quint64 compressedBytes = m_compressedBytes;
+    if (frames == 0 || compressedBytes == 0) {
+        return "Nothing encoded";
+    }
+
+    return QString("Ratio %1:1, %2 MB/frame, encode %3 ms/frame")
+           .arg(static_cast<double>(m_rawBytes) / compressedBytes, 0, 'f', 2)
+           .arg(compressedBytes / 1e6 / frames, 0, 'f', 2)
+           .arg(m_encodeNs / 1e6 / frames, 0, 'f', 2);
+}
+
+void FrameRecorder::setVideoSegmentFrames(int frames)
+{
+    // Takes effect the next time recording starts
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_videoSegmentFrames = qMax(0, frames);
+}
+
+int FrameRecorder::getVideoSegmentFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_videoSegmentFrames;
+}
+
+QString FrameRecorder::getVideoInfo() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_videoInfo.isEmpty() ? QString("No video") : m_videoInfo;
+}
+
+BayerDemosaic::WhiteBalance FrameRecorder::getWhiteBalance() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_whiteBalance;
+}
+
+void FrameRecorder::setThreadPolicy(const ThreadPolicy::Config &config)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_threadPolicy = config;
+}
+
+ThreadPolicy::Config FrameRecorder::getThreadPolicy() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_threadPolicy;
+}
+
+QString FrameRecorder::getThreadPolicyReport() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_threadPolicyReport.isEmpty() ? QString("Not started") : m_threadPolicyReport;
+}
+
+int FrameRecorder::getRecordedImageCount() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_nextImageIndex;
+}
+
+void FrameRecorder::resetRecordingCount()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_nextImageIndex = 0;
+}
+
+int FrameRecorder::getQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return static_cast<int>(m_queue.size());
+}
+
+void FrameRecorder::resetCounters()
+{
+    m_offeredCount = 0;
+    m_queuedCount = 0;
+    m_writtenCount = 0;
+    m_droppedCount = 0;
+    m_encodedCount = 0;
+    m_rawBytes = 0;
+    m_compressedBytes = 0;
+    m_encodeNs = 0;
+    publishStats(true);
+}
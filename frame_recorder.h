@@ -0,0 +1,212 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "frame_handle.h"
+#include "latency_histogram.h"
+#include "thread_policy.h"
+
+// Writes recorded frames to disk off the grab thread.
+//
+// enqueue() is called by the grab thread and only touches a bounded queue.
+// One or more writer threads drain the queue and save each frame as
+// pattern_XX.bmp, the counter wrapping at the configured maximum. In the
+// raw sequence format a single writer appends the frames unconverted to
+// .bseq files instead (see RawSequenceWriter), starting a new file when
+// the maximum is reached. The lossless compressed formats (PNG, TIFF) keep
+// mono frames at their native depth and Bayer frames as the raw mosaic;
+// the writer threads only encode, in parallel, and one more thread writes
+// the encoded files in the order the frames were queued. Encoders stay at
+// most a window of frames ahead of that thread, which bounds the memory
+// held by encoded files. The video formats stream 8-bit frames (like BMP)
+// through a single cv::VideoWriter thread into segment_*.avi/.mkv files,
+// rotating after the configured number of frames, with a .csv of frame
+// IDs and timestamps beside each segment. When the queue is full the
+// overflow policy decides whether the grab thread waits, the new frame is
+// dropped or the oldest queued frame is dropped.
+class FrameRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum OverflowPolicy {
+        OverflowBlock,       // Grab thread waits for a free queue slot
+        OverflowDropNewest,  // Discard the incoming frame
+        OverflowDropOldest   // Discard the oldest queued frame
+    };
+
+    enum RecordingFormat {
+        FormatBmp,           // 8-bit pattern_XX.bmp files
+        FormatRawSequence,   // Native pixel data in sequence_*.bseq files
+        FormatPng,           // Lossless pattern_XX.png, zlib level 1
+        FormatTiffLzw,       // Lossless pattern_XX.tif, LZW
+        FormatTiffDeflate,   // Lossless pattern_XX.tif, Deflate
+        FormatVideoMjpeg,    // MJPEG in segment_*.avi
+        FormatVideoFfv1      // Lossless FFV1 in segment_*.mkv
+    };
+
+    static bool isCompressedFormat(RecordingFormat format);
+    static bool isVideoFormat(RecordingFormat format);
+    static const char* formatName(RecordingFormat format);
+
+    explicit FrameRecorder(QObject *parent = nullptr);
+    ~FrameRecorder();
+
+    // Start the writer threads, stop() lets them drain the queue and exit
+    void start();
+    void stop();
+    void waitForFinished();
+    bool isRunning() const { return m_running; }
+
+    // Called from the grab thread
+    bool enqueue(const FrameHandle &frame);
+
+    // Configuration
+    void setRecordingPath(const QString &path);
+    QString getRecordingPath() const;
+    void setMaxRecordedImages(int maxCount);
+    int getMaxRecordedImages() const;
+    void setQueueCapacity(int capacity);
+    int getQueueCapacity() const;
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy getOverflowPolicy() const;
+    void setWriterThreadCount(int count);
+    int getWriterThreadCount() const;
+
+    // Takes effect the next time recording starts
+    void setRecordingFormat(RecordingFormat format);
+    RecordingFormat getRecordingFormat() const;
+
+    // Stored in the raw sequence records: the exposure for frames without
+    // the ChunkExposureTime chunk, and the camera timestamp tick rate
+    void setExposureTime(double exposureTimeUs) { m_exposureTime = exposureTimeUs; }
+    void setTimestampTickFrequency(double frequency) { m_timestampTickFrequency = frequency; }
+
+    // File the raw sequence writer is appending to
+    QString getSequenceInfo() const;
+
+    // Compressed formats: ratio of pixel data to file bytes, file size and
+    // mean encode time per frame since the counters were reset
+    QString getCompressionInfo() const;
+
+    // Video formats: frames per segment file (0 = one file per recording)
+    // and the frame rate stored in the container, applied when recording starts
+    void setVideoSegmentFrames(int frames);
+    int getVideoSegmentFrames() const;
+    void setVideoFrameRate(double frameRate) { m_videoFrameRate = frameRate; }
+
+    // Current segment and encode fps against the rate frames are offered at
+    QString getVideoInfo() const;
+
+    // Gains used when demosaicing Bayer frames for the file
+    void setWhiteBalance(const BayerDemosaic::WhiteBalance &whiteBalance);
+    BayerDemosaic::WhiteBalance getWhiteBalance() const;
+
+    // Scheduling, cores and memory node of the writer threads, applied when they start
+    void setThreadPolicy(const ThreadPolicy::Config &config);
+    ThreadPolicy::Config getThreadPolicy() const;
+    QString getThreadPolicyReport() const;
+
+    // Receives the frame age at the moment each file is written, may be nullptr
+    void setWriteLatencyHistogram(LatencyHistogram *histogram) { m_writeLatency = histogram; }
+
+    // Receives the encode time of each compressed or video frame, may be nullptr
+    void setEncodeTimeHistogram(LatencyHistogram *histogram) { m_encodeTime = histogram; }
+
+    // Counters
+    int getRecordedImageCount() const;
+    void resetRecordingCount();
+    quint64 getQueuedCount() const { return m_queuedCount; }
+    quint64 getWrittenCount() const { return m_writtenCount; }
+    quint64 getDroppedCount() const { return m_droppedCount; }
+    int getQueueDepth() const;
+    void resetCounters();
+
+signals:
+    void statsUpdated(quint64 queued, quint64 written, quint64 dropped);
+
+private:
+    struct QueuedFrame
+    {
+        FrameHandle frame;
+        int imageIndex = 0;
+    };
+
+    struct EncodedFrame
+    {
+        std::vector<uchar> data;    // Empty when encoding failed
+        int imageIndex = 0;
+        int64_t timestampNs = 0;
+    };
+
+    void applyThreadPolicy();
+    void writerLoop();
+    void writeSequence();
+    void writeVideo(RecordingFormat format);
+    void encodeFrames();
+    void orderedWriterLoop();
+    static bool encodeFrame(const FrameHandle &frame, RecordingFormat format, std::vector<uchar> &data);
+    bool writeFrame(const QueuedFrame &item, const QString &path, const BayerDemosaic::WhiteBalance &whiteBalance);
+    void publishStats(bool force);
+
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueNotEmpty;
+    std::condition_variable m_queueNotFull;
+    std::deque<QueuedFrame> m_queue;
+    std::vector<std::thread> m_writers;
+    std::atomic<bool> m_running;
+
+    // Guarded by m_queueMutex
+    QString m_recordingPath;
+    int m_maxRecordedImages;
+    int m_nextImageIndex;
+    int m_queueCapacity;
+    OverflowPolicy m_overflowPolicy;
+    int m_writerThreadCount;
+    RecordingFormat m_recordingFormat;
+    RecordingFormat m_activeFormat;    // Format of the running writers
+    QString m_sequenceInfo;
+    int m_videoSegmentFrames;
+    QString m_videoInfo;
+    BayerDemosaic::WhiteBalance m_whiteBalance;
+    ThreadPolicy::Config m_threadPolicy;
+    QString m_threadPolicyReport;   // What the last writer thread got
+
+    // Compressed formats, guarded by m_queueMutex
+    std::condition_variable m_encodedReady;   // Encoders also wait on m_queueNotEmpty for the window
+    std::map<quint64, EncodedFrame> m_encoded; // Encoded, waiting for their turn
+    quint64 m_nextTicket;            // Queue order of the next frame an encoder takes
+    quint64 m_nextToWrite;
+    int m_activeEncoders;
+    int m_encodeWindow;
+
+    std::atomic<quint64> m_offeredCount;     // enqueue() calls, the acquisition rate while recording
+    std::atomic<quint64> m_queuedCount;
+    std::atomic<quint64> m_writtenCount;
+    std::atomic<quint64> m_droppedCount;
+    std::atomic<qint64> m_lastStatsTime;
+    std::atomic<double> m_exposureTime;
+    std::atomic<double> m_timestampTickFrequency;
+    std::atomic<quint64> m_encodedCount;
+    std::atomic<quint64> m_rawBytes;         // Pixel data of the encoded frames
+    std::atomic<quint64> m_compressedBytes;
+    std::atomic<quint64> m_encodeNs;
+    std::atomic<double> m_videoFrameRate;
+    LatencyHistogram* m_writeLatency; // Set before start(), not owned
+    LatencyHistogram* m_encodeTime;   // Same
+
+    static const int DEFAULT_QUEUE_CAPACITY = 32;
+    static const int DEFAULT_VIDEO_SEGMENT_FRAMES = 10000;
+    static constexpr double DEFAULT_VIDEO_FRAME_RATE = 30.0; // Without a frame rate setting
+    static const int STATS_INTERVAL_MS = 100; // Throttle for statsUpdated
+};
+
+#endif // FRAME_RECORDER_H
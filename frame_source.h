@@ -0,0 +1,123 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <QString>
+#include <functional>
+#include "frame_handle.h"
+
+// Basler Pylon includes
+#include <pylon/PylonIncludes.h>
+
+// Where BaslerCamera gets its frames from.
+//
+// open()/close() and the settings calls run on the UI thread, startGrabbing(),
+// retrieveFrame() and stopGrabbing() run on the grab thread. Pylon-backed
+// sources may throw GenericException like the rest of the Pylon code, the
+// grab loop already handles that.
+//
+// Frames are either polled with retrieveFrame() or, for sources that support
+// it, pushed to a callback on the source's own thread after
+// startGrabbingEventDriven().
+class IFrameSource
+{
+public:
+    enum RetrieveStatus {
+        RetrieveOk,       // frame holds a new image
+        RetrieveTimeout,  // Nothing arrived within the timeout
+        RetrieveFailed    // A frame arrived but is broken, error is set
+    };
+
+    // Grab buffer pool requested for a grab session
+    struct BufferConfig
+    {
+        int count = 10;           // Number of grab buffers (MaxNumBuffer)
+        size_t size = 0;          // Bytes per buffer, 0 derives it from Width/Height/PixelFormat
+        bool hugePages = false;   // Back the pool with hugepages
+        bool lockMemory = false;  // Pin the pool with mlock()
+    };
+
+    // Which frames reach the grab loop when it falls behind (Pylon grab strategies)
+    enum GrabStrategy {
+        GrabOneByOne,         // Every frame, in order; a slow consumer sees ever older frames
+        GrabLatestImageOnly,  // Only the newest frame is kept, older ones are skipped
+        GrabLatestImages,     // The newest queueSize frames are kept
+        GrabUpcomingImage     // A buffer is queued only while retrieveFrame() waits
+    };
+
+    struct AcquisitionConfig
+    {
+        GrabStrategy strategy = GrabOneByOne;
+        int queueSize = 2;        // Output queue length for GrabLatestImages
+    };
+
+    // Receives each frame on the source's thread, error is set for RetrieveFailed
+    typedef std::function<void(RetrieveStatus status, const FrameHandle &frame, const QString &error)> FrameCallback;
+
+    virtual ~IFrameSource() {}
+
+    virtual bool open(QString &error) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Device information for the UI
+    virtual QString getName() const = 0;
+    virtual QString getModel() const = 0;
+    virtual QString getSerial() const = 0;
+
+    // Pylon camera behind this source for GenApi parameter access,
+    // nullptr when the source has no node map
+    virtual Pylon::CInstantCamera* getCamera() { return nullptr; }
+
+    // Sources without grab buffers ignore bufferConfig, sources without a
+    // frame queue ignore the strategy and always deliver the newest frame
+    virtual void startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition) = 0;
+    virtual void stopGrabbing() = 0;
+    virtual RetrieveStatus retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error) = 0;
+
+    // Makes a retrieveFrame() blocked on the grab thread return RetrieveTimeout
+    // right away, may be called from any thread
+    virtual void interruptRetrieve() {}
+
+    // Push delivery instead of retrieveFrame(). Returns false, without
+    // starting, when the source or this configuration does not support it.
+    // stopGrabbing() returns once the last callback has finished.
+    virtual bool startGrabbingEventDriven(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition,
+                                          FrameCallback callback)
+    {
+        Q_UNUSED(bufferConfig);
+        Q_UNUSED(acquisition);
+        Q_UNUSED(callback);
+        return false;
+    }
+
+    // Frames the grab strategy dropped since startGrabbing()
+    virtual quint64 getSkippedFrameCount() const { return 0; }
+
+    static const char* grabStrategyName(GrabStrategy strategy)
+    {
+        switch (strategy) {
+            case GrabOneByOne:        return "OneByOne";
+            case GrabLatestImageOnly: return "LatestImageOnly";
+            case GrabLatestImages:    return "LatestImages";
+            default:                  return "UpcomingImage";
+        }
+    }
+
+    // Rate of the camera clock behind FrameHandle::cameraTimestamp() in
+    // ticks per second, 0 when frames carry no camera timestamp
+    virtual double getTimestampTickFrequency() const { return 0.0; }
+
+    // Reads the camera clock and FrameHandle::currentTimestampNs() at about
+    // the same moment, false when the camera cannot latch its clock
+    virtual bool latchTimestamp(uint64_t &ticks, int64_t &hostNs)
+    {
+        Q_UNUSED(ticks);
+        Q_UNUSED(hostNs);
+        return false;
+    }
+
+    // Description of the grab buffers in use, empty when not applicable
+    virtual QString getBufferInfo() const { return QString(); }
+};
+
+#endif // FRAME_SOURCE_H
@@ -0,0 +1,106 @@
+#include "frame_statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+FrameStatistics::FrameStatistics()
+    : m_intervalCount(0)
+    , m_frameCount(0)
+    , m_minIntervalNs(std::numeric_limits<int64_t>::max())
+    , m_maxIntervalNs(0)
+    , m_windowSize(DEFAULT_WINDOW_SIZE)
+    , m_lastTimestampNs(0)
+{
+    for (std::atomic<int64_t> &interval : m_intervals) {
+        interval.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FrameStatistics::record(int64_t timestampNs)
+{
+    const uint64_t frames = m_frameCount.load(std::memory_order_relaxed);
+    const int64_t interval = timestampNs - m_lastTimestampNs;
+    m_lastTimestampNs = timestampNs;
+
+    // The first frame only starts the clock, out-of-order timestamps are ignored
+    if (frames > 0 && interval > 0) {
+        const uint64_t index = m_intervalCount.load(std::memory_order_relaxed);
+        m_intervals[index % CAPACITY].store(interval, std::memory_order_relaxed);
+        m_intervalCount.store(index + 1, std::memory_order_release);
+
+        // Single producer, so plain load/store is enough
+        if (interval < m_minIntervalNs.load(std::memory_order_relaxed)) {
+            m_minIntervalNs.store(interval, std::memory_order_relaxed);
+        }
+        if (interval > m_maxIntervalNs.load(std::memory_order_relaxed)) {
+            m_maxIntervalNs.store(interval, std::memory_order_relaxed);
+        }
+    }
+
+    m_frameCount.store(frames + 1, std::memory_order_relaxed);
+}
+
+FrameStatistics::Snapshot FrameStatistics::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.frameCount = m_frameCount.load(std::memory_order_relaxed);
+
+    const uint64_t count = m_intervalCount.load(std::memory_order_acquire);
+    const int window = static_cast<int>(std::min<uint64_t>(count, static_cast<uint64_t>(getWindowSize())));
+    if (window == 0) {
+        return snapshot;
+    }
+
+    // Newest interval last
+    std::vector<int64_t> intervals(window);
+    for (int i = 0; i < window; ++i) {
+        intervals[i] = m_intervals[(count - window + i) % CAPACITY].load(std::memory_order_relaxed);
+    }
+
+    const double toMs = 1e-6;
+    double sum = 0.0;
+    for (int64_t interval : intervals) {
+        sum += static_cast<double>(interval);
+    }
+    const double mean = sum / window;
+    double squares = 0.0;
+    for (int64_t interval : intervals) {
+        const double deviation = static_cast<double>(interval) - mean;
+        squares += deviation * deviation;
+    }
+
+    snapshot.windowSize = window;
+    snapshot.instantFps = 1e9 / static_cast<double>(intervals.back());
+    snapshot.windowFps = 1e9 / mean;
+    snapshot.meanIntervalMs = mean * toMs;
+    snapshot.stddevIntervalMs = std::sqrt(squares / window) * toMs;
+
+    std::sort(intervals.begin(), intervals.end());
+    auto percentile = [&intervals, window](double p) {
+        const int index = std::min(window - 1, static_cast<int>(std::ceil(p / 100.0 * window)) - 1);
+        return static_cast<double>(intervals[std::max(0, index)]);
+    };
+    snapshot.minIntervalMs = intervals.front() * toMs;
+    snapshot.maxIntervalMs = intervals.back() * toMs;
+    snapshot.p50IntervalMs = percentile(50.0) * toMs;
+    snapshot.p95IntervalMs = percentile(95.0) * toMs;
+    snapshot.p99IntervalMs = percentile(99.0) * toMs;
+    snapshot.lifetimeMinIntervalMs = m_minIntervalNs.load(std::memory_order_relaxed) * toMs;
+    snapshot.lifetimeMaxIntervalMs = m_maxIntervalNs.load(std::memory_order_relaxed) * toMs;
+    return snapshot;
+}
+
+void FrameStatistics::setWindowSize(int size)
+{
+    m_windowSize.store(std::max(2, std::min(size, static_cast<int>(CAPACITY))), std::memory_order_relaxed);
+}
+
+void FrameStatistics::reset()
+{
+    m_intervalCount.store(0, std::memory_order_relaxed);
+    m_frameCount.store(0, std::memory_order_relaxed);
+    m_minIntervalNs.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    m_maxIntervalNs.store(0, std::memory_order_relaxed);
+    m_lastTimestampNs = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef FRAME_STATISTICS_H
+#define FRAME_STATISTICS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Frame rate and interval statistics without work on the grab thread.
+//
+// record() is called once per frame by a single producer (the grab thread,
+// or the source's thread in event-driven mode). It stores the interval to
+// the previous frame in a fixed-size ring of atomics and bumps a counter:
+// no locks, allocations, node map reads or logging. snapshot() runs on the
+// reader's side at whatever rate the UI wants and derives the
+// instantaneous and windowed frame rate, the interval jitter and the
+// interval percentiles from the newest windowSize intervals. A snapshot taken
+// while the producer laps the ring may mix in a few newer intervals, which
+// is harmless for statistics.
+class FrameStatistics
+{
+public:
+    struct Snapshot
+    {
+        uint64_t frameCount = 0;
+        int windowSize = 0;           // Intervals the figures below are based on
+        double instantFps = 0.0;      // From the newest interval
+        double windowFps = 0.0;       // From the mean interval of the window
+        double meanIntervalMs = 0.0;
+        double minIntervalMs = 0.0;
+        double maxIntervalMs = 0.0;
+        double stddevIntervalMs = 0.0;
+        double p50IntervalMs = 0.0;
+        double p95IntervalMs = 0.0;
+        double p99IntervalMs = 0.0;
+        double lifetimeMinIntervalMs = 0.0;  // Since the last reset
+        double lifetimeMaxIntervalMs = 0.0;
+    };
+
+    FrameStatistics();
+
+    // Producer side, timestampNs on a steady clock
+    void record(int64_t timestampNs);
+
+    // Reader side, any thread
+    Snapshot snapshot() const;
+    uint64_t frameCount() const { return m_frameCount.load(std::memory_order_relaxed); }
+
+    // Newest intervals the snapshot looks at, clamped to [2, CAPACITY]
+    void setWindowSize(int size);
+    int getWindowSize() const { return m_windowSize.load(std::memory_order_relaxed); }
+
+    // Only while the producer is idle (between grab sessions)
+    void reset();
+
+    static const int CAPACITY = 4096;
+    static const int DEFAULT_WINDOW_SIZE = 120;
+
+private:
+    std::atomic<int64_t> m_intervals[CAPACITY];   // Nanoseconds, ring indexed by interval count
+    std::atomic<uint64_t> m_intervalCount;
+    std::atomic<uint64_t> m_frameCount;
+    std::atomic<int64_t> m_minIntervalNs;
+    std::atomic<int64_t> m_maxIntervalNs;
+    std::atomic<int> m_windowSize;
+
+    int64_t m_lastTimestampNs;   // Producer only
+};
+
+#endif // FRAME_STATISTICS_H
@@ -0,0 +1,216 @@
+#include "frame_timing_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Pylon reports this when the transport layer has no block ID
+const uint64_t NO_BLOCK_ID = std::numeric_limits<uint64_t>::max();
+
+// GigE Vision 1.x block IDs are 16 bits and skip 0 when they wrap
+const uint64_t BLOCK_ID_16_MAX = 0xFFFF;
+
+}
+
+FrameTimingMonitor::FrameTimingMonitor()
+    : m_sampleCount(0)
+    , m_missingFrames(0)
+    , m_skippedFrames(0)
+    , m_blockIdResets(0)
+    , m_minHostMinusCameraNs(std::numeric_limits<int64_t>::max())
+    , m_clockOffsetNs(0)
+    , m_clockOffsetValid(false)
+    , m_hasCameraTime(false)
+    , m_nsPerTick(0.0)
+    , m_lastBlockId(0)
+    , m_lastCameraNs(0)
+    , m_first(true)
+{
+    for (SampleSlot &slot : m_samples) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FrameTimingMonitor::start(double tickFrequency)
+{
+    m_sensorStatistics.reset();
+    m_sampleCount.store(0, std::memory_order_relaxed);
+    m_missingFrames.store(0, std::memory_order_relaxed);
+    m_skippedFrames.store(0, std::memory_order_relaxed);
+    m_blockIdResets.store(0, std::memory_order_relaxed);
+    m_minHostMinusCameraNs.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    m_clockOffsetValid.store(false, std::memory_order_relaxed);
+    m_hasCameraTime.store(false, std::memory_order_relaxed);
+    for (SampleSlot &slot : m_samples) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    m_nsPerTick = (tickFrequency > 0.0) ? 1e9L / tickFrequency : 0.0L;
+    m_lastBlockId = 0;
+    m_lastCameraNs = 0;
+    m_first = true;
+}
+
+void FrameTimingMonitor::setClockOffset(int64_t hostMinusCameraNs)
+{
+    m_clockOffsetNs.store(hostMinusCameraNs, std::memory_order_relaxed);
+    m_clockOffsetValid.store(true, std::memory_order_release);
+}
+
+void FrameTimingMonitor::record(const FrameHandle &frame)
+{
+    const uint64_t blockId = frame.blockId();
+    const uint32_t skipped = frame.skippedImages();
+    const int64_t hostNs = frame.timestampNs();
+
+    // Block IDs the strategy did not skip never reached us
+    uint32_t missing = 0;
+    if (!m_first && blockId != NO_BLOCK_ID && m_lastBlockId != NO_BLOCK_ID) {
+        uint64_t gap = 0;
+        if (blockId > m_lastBlockId) {
+            gap = blockId - m_lastBlockId - 1;
+        } else if (m_lastBlockId <= BLOCK_ID_16_MAX && m_lastBlockId - blockId > BLOCK_ID_16_MAX / 2) {
+            gap = BLOCK_ID_16_MAX - m_lastBlockId + blockId - 1;
+        } else {
+            m_blockIdResets.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (gap > skipped) {
+            missing = static_cast<uint32_t>(std::min<uint64_t>(gap - skipped, std::numeric_limits<uint32_t>::max()));
+            m_missingFrames.fetch_add(missing, std::memory_order_relaxed);
+        }
+    }
+    m_skippedFrames.fetch_add(skipped, std::memory_order_relaxed);
+
+    // Sensor-side timing on the camera clock
+    int64_t cameraNs = 0;
+    int64_t sensorIntervalNs = 0;
+    int64_t hostMinusCameraNs = 0;
+    const uint64_t ticks = frame.cameraTimestamp();
+    if (ticks != 0 && m_nsPerTick > 0.0L) {
+        cameraNs = static_cast<int64_t>(static_cast<long double>(ticks) * m_nsPerTick);
+        if (m_lastCameraNs != 0) {
+            sensorIntervalNs = cameraNs - m_lastCameraNs;
+        }
+        m_lastCameraNs = cameraNs;
+        m_sensorStatistics.record(cameraNs);
+
+        hostMinusCameraNs = hostNs - cameraNs;
+        if (hostMinusCameraNs < m_minHostMinusCameraNs.load(std::memory_order_relaxed)) {
+            m_minHostMinusCameraNs.store(hostMinusCameraNs, std::memory_order_relaxed);
+        }
+        m_hasCameraTime.store(true, std::memory_order_relaxed);
+    }
+
+    m_lastBlockId = blockId;
+    m_first = false;
+
+    // Append to the time series
+    const uint64_t index = m_sampleCount.load(std::memory_order_relaxed);
+    SampleSlot &slot = m_samples[index % SAMPLE_CAPACITY];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.blockId.store(blockId, std::memory_order_relaxed);
+    slot.hostNs.store(hostNs, std::memory_order_relaxed);
+    slot.cameraNs.store(cameraNs, std::memory_order_relaxed);
+    slot.sensorIntervalNs.store(sensorIntervalNs, std::memory_order_relaxed);
+    slot.hostMinusCameraNs.store(hostMinusCameraNs, std::memory_order_relaxed);
+    slot.missingBefore.store(missing, std::memory_order_relaxed);
+    slot.skippedBefore.store(skipped, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    m_sampleCount.store(index + 1, std::memory_order_release);
+}
+
+bool FrameTimingMonitor::readSlot(uint64_t index, Sample &sample, int64_t &hostMinusCameraNs) const
+{
+    const SampleSlot &slot = m_samples[index % SAMPLE_CAPACITY];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index + 2) {
+        return false;
+    }
+
+    sample.blockId = slot.blockId.load(std::memory_order_relaxed);
+    sample.hostNs = slot.hostNs.load(std::memory_order_relaxed);
+    sample.cameraNs = slot.cameraNs.load(std::memory_order_relaxed);
+    sample.sensorIntervalNs = slot.sensorIntervalNs.load(std::memory_order_relaxed);
+    hostMinusCameraNs = slot.hostMinusCameraNs.load(std::memory_order_relaxed);
+    sample.missingBefore = slot.missingBefore.load(std::memory_order_relaxed);
+    sample.skippedBefore = slot.skippedBefore.load(std::memory_order_relaxed);
+
+    // Overwritten while we read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+int64_t FrameTimingMonitor::latencyOffset() const
+{
+    if (m_clockOffsetValid.load(std::memory_order_acquire)) {
+        return m_clockOffsetNs.load(std::memory_order_relaxed);
+    }
+    return m_minHostMinusCameraNs.load(std::memory_order_relaxed);
+}
+
+std::vector<FrameTimingMonitor::Sample> FrameTimingMonitor::samples(int maxCount) const
+{
+    const uint64_t count = m_sampleCount.load(std::memory_order_acquire);
+    const uint64_t available = std::min<uint64_t>(count, static_cast<uint64_t>(std::max(0, std::min(maxCount, static_cast<int>(SAMPLE_CAPACITY)))));
+    const int64_t offset = latencyOffset();
+
+    std::vector<Sample> result;
+    result.reserve(available);
+    for (uint64_t index = count - available; index < count; ++index) {
+        Sample sample;
+        int64_t hostMinusCameraNs = 0;
+        if (!readSlot(index, sample, hostMinusCameraNs)) {
+            continue;
+        }
+        sample.latencyNs = (sample.cameraNs != 0) ? hostMinusCameraNs - offset : 0;
+        result.push_back(sample);
+    }
+    return result;
+}
+
+FrameTimingMonitor::Snapshot FrameTimingMonitor::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.frameCount = m_sampleCount.load(std::memory_order_relaxed);
+    snapshot.missingFrames = m_missingFrames.load(std::memory_order_relaxed);
+    snapshot.skippedFrames = m_skippedFrames.load(std::memory_order_relaxed);
+    snapshot.blockIdResets = m_blockIdResets.load(std::memory_order_relaxed);
+    snapshot.hasCameraTime = m_hasCameraTime.load(std::memory_order_relaxed);
+    snapshot.latencyAbsolute = m_clockOffsetValid.load(std::memory_order_relaxed);
+    snapshot.sensor = m_sensorStatistics.snapshot();
+    if (!snapshot.hasCameraTime) {
+        return snapshot;
+    }
+
+    // Latency over the same window as the sensor intervals
+    std::vector<int64_t> latencies;
+    for (const Sample &sample : samples(m_sensorStatistics.getWindowSize())) {
+        if (sample.cameraNs != 0) {
+            latencies.push_back(sample.latencyNs);
+        }
+    }
+    if (latencies.empty()) {
+        return snapshot;
+    }
+
+    const int window = static_cast<int>(latencies.size());
+    double sum = 0.0;
+    for (int64_t latency : latencies) {
+        sum += static_cast<double>(latency);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies, window](double p) {
+        const int index = std::min(window - 1, static_cast<int>(std::ceil(p / 100.0 * window)) - 1);
+        return static_cast<double>(latencies[std::max(0, index)]);
+    };
+
+    const double toMs = 1e-6;
+    snapshot.latencyWindow = window;
+    snapshot.latencyMeanMs = sum / window * toMs;
+    snapshot.latencyP50Ms = percentile(50.0) * toMs;
+    snapshot.latencyP99Ms = percentile(99.0) * toMs;
+    snapshot.latencyMaxMs = latencies.back() * toMs;
+    return snapshot;
+}
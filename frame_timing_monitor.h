@@ -0,0 +1,110 @@
+#ifndef FRAME_TIMING_MONITOR_H
+#define FRAME_TIMING_MONITOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "frame_handle.h"
+#include "frame_statistics.h"
+
+// Sensor-side frame timing and dropped-frame detection from the camera's own
+// timestamp and stream block ID.
+//
+// record() is called once per delivered frame by a single producer, like
+// FrameStatistics. It converts the camera tick timestamp to nanoseconds and
+// feeds it to a FrameStatistics, so the intervals and jitter are those of
+// the sensor rather than of our grab loop. A gap in the block IDs that the
+// grab strategy did not account for counts as missing frames (lost on the
+// link, incomplete or failed). The host arrival time minus the camera time
+// gives the delivery latency: absolute once the two clocks were related
+// with setClockOffset(), otherwise relative to the fastest frame seen.
+//
+// The newest SAMPLE_CAPACITY frames are kept as a time series. Each slot is
+// guarded by a sequence number, samples() skips slots the producer is
+// rewriting while it reads.
+class FrameTimingMonitor
+{
+public:
+    struct Sample
+    {
+        uint64_t blockId = 0;
+        int64_t hostNs = 0;            // FrameHandle::timestampNs()
+        int64_t cameraNs = 0;          // Camera timestamp in nanoseconds, 0 if none
+        int64_t sensorIntervalNs = 0;  // To the previous delivered frame, camera clock
+        int64_t latencyNs = 0;         // Delivery latency, see Snapshot::latencyAbsolute
+        uint32_t missingBefore = 0;    // Frames lost right before this one
+        uint32_t skippedBefore = 0;    // Frames the grab strategy dropped right before this one
+    };
+
+    struct Snapshot
+    {
+        uint64_t frameCount = 0;
+        uint64_t missingFrames = 0;      // Block ID gaps not explained by skipped frames
+        uint64_t skippedFrames = 0;      // Dropped by the grab strategy
+        uint64_t blockIdResets = 0;      // Block ID went backwards (camera restart)
+        bool hasCameraTime = false;      // Frames carry a camera timestamp
+        bool latencyAbsolute = false;    // Clocks related by a latch, else relative to the fastest frame
+        FrameStatistics::Snapshot sensor;  // Intervals on the camera clock
+        int latencyWindow = 0;
+        double latencyMeanMs = 0.0;
+        double latencyP50Ms = 0.0;
+        double latencyP99Ms = 0.0;
+        double latencyMaxMs = 0.0;
+    };
+
+    FrameTimingMonitor();
+
+    // Only while the producer is idle. tickFrequency is the camera clock in
+    // ticks per second, 0 when frames carry no camera timestamp.
+    void start(double tickFrequency);
+
+    // Host time minus camera time in nanoseconds from a latch of both clocks
+    void setClockOffset(int64_t hostMinusCameraNs);
+
+    // Producer side
+    void record(const FrameHandle &frame);
+
+    // Reader side, any thread
+    Snapshot snapshot() const;
+    uint64_t missingFrameCount() const { return m_missingFrames.load(std::memory_order_relaxed); }
+
+    // Up to maxCount of the newest samples, oldest first
+    std::vector<Sample> samples(int maxCount = SAMPLE_CAPACITY) const;
+
+    static const int SAMPLE_CAPACITY = 4096;
+
+private:
+    struct SampleSlot
+    {
+        std::atomic<uint64_t> sequence;  // 2 * index + 2 when complete, odd while written
+        std::atomic<uint64_t> blockId;
+        std::atomic<int64_t> hostNs;
+        std::atomic<int64_t> cameraNs;
+        std::atomic<int64_t> sensorIntervalNs;
+        std::atomic<int64_t> hostMinusCameraNs;
+        std::atomic<uint32_t> missingBefore;
+        std::atomic<uint32_t> skippedBefore;
+    };
+
+    bool readSlot(uint64_t index, Sample &sample, int64_t &hostMinusCameraNs) const;
+    int64_t latencyOffset() const;
+
+    FrameStatistics m_sensorStatistics;
+    SampleSlot m_samples[SAMPLE_CAPACITY];
+    std::atomic<uint64_t> m_sampleCount;
+    std::atomic<uint64_t> m_missingFrames;
+    std::atomic<uint64_t> m_skippedFrames;
+    std::atomic<uint64_t> m_blockIdResets;
+    std::atomic<int64_t> m_minHostMinusCameraNs;  // Fastest delivery seen
+    std::atomic<int64_t> m_clockOffsetNs;
+    std::atomic<bool> m_clockOffsetValid;
+    std::atomic<bool> m_hasCameraTime;
+
+    // Producer only
+    long double m_nsPerTick;
+    uint64_t m_lastBlockId;
+    int64_t m_lastCameraNs;
+    bool m_first;
+};
+
+#endif // FRAME_TIMING_MONITOR_H
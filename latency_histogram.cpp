@@ -0,0 +1,128 @@
+#include "latency_histogram.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(int64_t valueNs)
+{
+    if (valueNs < 0) {
+        valueNs = 0;
+    }
+    if (valueNs > MAX_VALUE_NS) {
+        valueNs = MAX_VALUE_NS;
+    }
+    if (valueNs < SUB_BUCKET_COUNT) {
+        return static_cast<int>(valueNs);
+    }
+
+    // Keep the top SUB_BUCKET_BITS + 1 significant bits of the value
+    const int msb = 63 - __builtin_clzll(static_cast<unsigned long long>(valueNs));
+    const int shift = msb - SUB_BUCKET_BITS;
+    const int top = static_cast<int>(valueNs >> shift); // In [SUB_BUCKET_COUNT, 2 * SUB_BUCKET_COUNT)
+    return SUB_BUCKET_COUNT + shift * SUB_BUCKET_COUNT + (top - SUB_BUCKET_COUNT);
+}
+
+int64_t LatencyHistogram::bucketUpperEdge(int index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    const int shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+    const int64_t top = SUB_BUCKET_COUNT + (index - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t valueNs)
+{
+    if (valueNs < 0) {
+        valueNs = 0; // Clock adjustments must not corrupt the sum
+    }
+
+    m_buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+    int64_t current = m_min.load(std::memory_order_relaxed);
+    while (valueNs < current &&
+           !m_min.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+
+    current = m_max.load(std::memory_order_relaxed);
+    while (valueNs > current &&
+           !m_max.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint64_t> &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::minValue() const
+{
+    return count() > 0 ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+double LatencyHistogram::mean() const
+{
+    const uint64_t samples = count();
+    return samples > 0 ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / samples : 0.0;
+}
+
+int64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    const uint64_t samples = count();
+    if (samples == 0) {
+        return 0;
+    }
+
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    }
+    if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    // Rank of the sample we are looking for, at least the first one
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * samples));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // The bucket edge may overshoot the largest sample actually seen
+            const int64_t edge = bucketUpperEdge(i);
+            const int64_t max = maxValue();
+            return edge < max ? edge : max;
+        }
+    }
+
+    return maxValue();
+}
+
+std::string LatencyHistogram::bucketsToString() const
+{
+    std::ostringstream out;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        const uint64_t bucketCount = m_buckets[i].load(std::memory_order_relaxed);
+        if (bucketCount > 0) {
+            out << bucketUpperEdge(i) << ' ' << bucketCount << '\n';
+        }
+    }
+    return out.str();
+}
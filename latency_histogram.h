@@ -0,0 +1,54 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Fixed-bucket latency histogram in the style of HdrHistogram.
+//
+// Values are nanoseconds. Below SUB_BUCKET_COUNT every value has its own
+// bucket; above that each power of two is split into SUB_BUCKET_COUNT linear
+// buckets, so a reported percentile is within ~1.6% of the recorded value
+// up to MAX_VALUE_NS. Larger values land in the last bucket.
+//
+// record() is lock-free and may be called from any number of threads. The
+// readers walk the buckets without stopping writers, so a query taken while
+// frames are flowing can be off by the few samples recorded meanwhile.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(int64_t valueNs);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    int64_t minValue() const;
+    int64_t maxValue() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // percentile in [0, 100], returns the upper edge of the matching bucket
+    int64_t valueAtPercentile(double percentile) const;
+
+    // One line per non-empty bucket: "<upper edge ns> <count>"
+    std::string bucketsToString() const;
+
+    static const int SUB_BUCKET_BITS = 6;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int MAX_MAGNITUDE = 40; // 2^40 ns, about 18 minutes
+    static const int BUCKET_COUNT = SUB_BUCKET_COUNT * (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1);
+    static const int64_t MAX_VALUE_NS = (int64_t(1) << MAX_MAGNITUDE) - 1;
+
+private:
+    static int bucketIndex(int64_t valueNs);
+    static int64_t bucketUpperEdge(int index);
+
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<int64_t> m_sum;
+    std::atomic<int64_t> m_min;
+    std::atomic<int64_t> m_max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
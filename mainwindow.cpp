@@ -2,11 +2,16 @@
 #include <QDebug>
 #include <QMessageBox>
 #include <QScrollArea>
+#include <QFileDialog>
+#include <QEvent>
+#include <QGridLayout>
+#include <QSignalBlocker>
+#include "thread_affinity.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , baslerCamera(new BaslerCamera(this))
-    , updateTimer(new QTimer(this))
+    , displayScheduler(new DisplayScheduler(baslerCamera, this, this))
     , imageLabel(nullptr)
     , statusLabel(nullptr)
     , cameraInfoLabel(nullptr)
@@ -14,10 +19,25 @@ MainWindow::MainWindow(QWidget *parent)
     , connectButton(nullptr)
     , disconnectButton(nullptr)
     , grabButton(nullptr)
+    , sourceTypeComboBox(nullptr)
+    , syntheticPixelFormatComboBox(nullptr)
+    , playbackPathEdit(nullptr)
+    , playbackFileButton(nullptr)
+    , playbackFolderButton(nullptr)
+    , playbackPacingComboBox(nullptr)
+    , playbackLoopCheckBox(nullptr)
+    , playbackSeekSpinBox(nullptr)
+    , playbackSeekButton(nullptr)
+    , playbackPositionLabel(nullptr)
+    , loadProfileButton(nullptr)
+    , profileResultLabel(nullptr)
     , widthSpinBox(nullptr)
     , heightSpinBox(nullptr)
     , setResolutionButton(nullptr)
     , resolutionComboBox(nullptr)
+    , pixelFormatComboBox(nullptr)
+    , setPixelFormatButton(nullptr)
+    , bandwidthLabel(nullptr)
     , scalingFactorSpinBox(nullptr)
     , scalingFactorSlider(nullptr)
     , setScalingFactorButton(nullptr)
@@ -48,30 +68,94 @@ MainWindow::MainWindow(QWidget *parent)
     , setRecordingPathButton(nullptr)
     , maxRecordedImagesSpinBox(nullptr)
     , setMaxRecordedImagesButton(nullptr)
+    , recordingOverflowComboBox(nullptr)
+    , recordingWriterThreadsSpinBox(nullptr)
+    , recordingFormatComboBox(nullptr)
+    , recordingSegmentFramesSpinBox(nullptr)
+    , recordingStatsLabel(nullptr)
+    , preTriggerEnableCheckBox(nullptr)
+    , preTriggerFramesSpinBox(nullptr)
+    , postTriggerFramesSpinBox(nullptr)
+    , preTriggerMemorySpinBox(nullptr)
+    , preTriggerPathEdit(nullptr)
+    , preTriggerOnSoftwareTriggerCheckBox(nullptr)
+    , applyPreTriggerButton(nullptr)
+    , preTriggerNowButton(nullptr)
+    , preTriggerStatsLabel(nullptr)
     , realTimeFrameRateLabel(nullptr)
     , frameCountLabel(nullptr)
     , frameIdLabel(nullptr)
     , errorsCountLabel(nullptr)
+    , overwrittenFramesLabel(nullptr)
+    , frameIntervalLabel(nullptr)
+    , sensorTimingLabel(nullptr)
+    , dumpFrameTimingButton(nullptr)
+    , grabBufferCountSpinBox(nullptr)
+    , grabBufferHugePagesCheckBox(nullptr)
+    , grabBufferLockMemoryCheckBox(nullptr)
+    , grabBufferInfoLabel(nullptr)
+    , grabStrategyComboBox(nullptr)
+    , grabQueueSizeSpinBox(nullptr)
+    , eventDrivenCheckBox(nullptr)
+    , setAcquisitionModeButton(nullptr)
+    , skippedFramesLabel(nullptr)
+    , latencyLabel(nullptr)
+    , dumpLatencyButton(nullptr)
+    , resetLatencyButton(nullptr)
+    , lastPaintedFrameId(-1)
+    , displayFullRangeCheckBox(nullptr)
+    , displayWindowLowSpinBox(nullptr)
+    , displayWindowHighSpinBox(nullptr)
+    , displayGammaSpinBox(nullptr)
+    , previewRenderer(new PreviewRenderer(this))
+    , previewQualityComboBox(nullptr)
+    , whiteBalanceRedSpinBox(nullptr)
+    , whiteBalanceGreenSpinBox(nullptr)
+    , whiteBalanceBlueSpinBox(nullptr)
+    , bayerFullResolutionCheckBox(nullptr)
+    , grabSchedulingComboBox(nullptr)
+    , grabPrioritySpinBox(nullptr)
+    , grabCoresEdit(nullptr)
+    , recorderSchedulingComboBox(nullptr)
+    , recorderPrioritySpinBox(nullptr)
+    , recorderCoresEdit(nullptr)
+    , memoryNodeSpinBox(nullptr)
+    , applyThreadPolicyButton(nullptr)
+    , threadPolicyLabel(nullptr)
+    , cameraManager(new CameraManager(this))
+    , multiCameraCountSpinBox(nullptr)
+    , multiCameraFirstCoreSpinBox(nullptr)
+    , multiCameraOpenButton(nullptr)
+    , multiCameraGrabButton(nullptr)
+    , multiCameraCloseButton(nullptr)
+    , multiCameraStatsLabel(nullptr)
 {
     setupUI();
     
     // Connect signals
-    connect(baslerCamera, &BaslerCamera::imageUpdated, this, &MainWindow::updateImage);
+    connect(displayScheduler, &DisplayScheduler::frameReady, this, &MainWindow::updateImage);
     connect(baslerCamera, &BaslerCamera::statusChanged, this, &MainWindow::updateStatus);
     connect(baslerCamera, &BaslerCamera::settingsChanged, this, &MainWindow::updateCameraSettings);
     connect(baslerCamera, &BaslerCamera::frameRateUpdated, this, &MainWindow::onFrameRateUpdated);
     connect(baslerCamera, &BaslerCamera::frameIdUpdated, this, &MainWindow::onFrameIdUpdated);
     connect(baslerCamera, &BaslerCamera::errorsCountUpdated, this, &MainWindow::onErrorsCountUpdated);
+    connect(baslerCamera, &BaslerCamera::recordingStatsUpdated, this, &MainWindow::onRecordingStatsUpdated);
+    connect(previewRenderer, &PreviewRenderer::previewReady, this, &MainWindow::onPreviewReady);
+    // The last preview frame may wrap a grab buffer of the source
+    connect(baslerCamera, &BaslerCamera::sourceClosing, previewRenderer, &PreviewRenderer::clear, Qt::DirectConnection);
+    connect(cameraManager, &CameraManager::statsUpdated, this, &MainWindow::onMultiCameraStatsUpdated);
+    connect(cameraManager, &CameraManager::statusChanged, this, &MainWindow::updateStatus);
     
-    // Setup timer for periodic image updates
-    connect(updateTimer, &QTimer::timeout, this, &MainWindow::updateImage);
-    updateTimer->start(10); // ~30 FPS
+    onPreviewSettingsChanged();
+    previewRenderer->start();
     
     updateStatus("Application started");
 }
 
 MainWindow::~MainWindow()
 {
+    // No previews may arrive while the widgets are torn down
+    previewRenderer->stop();
 }
 
 void MainWindow::setupUI()
@@ -141,16 +225,64 @@ void MainWindow::setupUI()
     errorsCountLabel->setAlignment(Qt::AlignCenter);
     errorsCountLabel->setStyleSheet("QLabel");
     
+    // Frames replaced before the display picked them up
+    overwrittenFramesLabel = new QLabel("Overwritten: 0");
+    overwrittenFramesLabel->setAlignment(Qt::AlignCenter);
+    overwrittenFramesLabel->setStyleSheet("QLabel");
+    
+    // Frames the grab strategy dropped before the grab loop saw them
+    skippedFramesLabel = new QLabel("Skipped: 0");
+    skippedFramesLabel->setAlignment(Qt::AlignCenter);
+    skippedFramesLabel->setStyleSheet("QLabel");
+    
     // Add frame info labels to horizontal layout
     frameInfoLayout->addWidget(frameCountLabel);
     frameInfoLayout->addWidget(frameIdLabel);
     frameInfoLayout->addWidget(errorsCountLabel);
+    frameInfoLayout->addWidget(overwrittenFramesLabel);
+    frameInfoLayout->addWidget(skippedFramesLabel);
+    
+    // Frame interval jitter over the statistics window
+    frameIntervalLabel = new QLabel("Interval: no samples");
+    frameIntervalLabel->setStyleSheet("QLabel { font-family: monospace; }");
+    
+    // Same on the camera clock, plus lost frames and delivery latency
+    sensorTimingLabel = new QLabel("Sensor: no camera timestamps");
+    sensorTimingLabel->setStyleSheet("QLabel { font-family: monospace; }");
+    
+    // Per-stage latency percentiles
+    latencyLabel = new QLabel("Latency: no samples");
+    latencyLabel->setStyleSheet("QLabel { font-family: monospace; }");
+    
+    QHBoxLayout *latencyButtonLayout = new QHBoxLayout();
+    dumpLatencyButton = new QPushButton("Dump Latency...");
+    resetLatencyButton = new QPushButton("Reset Latency");
+    latencyButtonLayout->addWidget(dumpLatencyButton);
+    latencyButtonLayout->addWidget(resetLatencyButton);
+    dumpFrameTimingButton = new QPushButton("Dump Frame Timing...");
+    latencyButtonLayout->addWidget(dumpFrameTimingButton);
     
     realTimeLayout->addWidget(realTimeFrameRateLabel);
     realTimeLayout->addLayout(frameInfoLayout);
+    realTimeLayout->addWidget(frameIntervalLabel);
+    realTimeLayout->addWidget(sensorTimingLabel);
+    realTimeLayout->addWidget(latencyLabel);
+    realTimeLayout->addLayout(latencyButtonLayout);
     
     leftPanel->addWidget(realTimeGroup);
     
+    // Create configuration profile section, a profile is applied with at most one restart
+    QGroupBox *profileGroup = new QGroupBox("Camera Profile");
+    QVBoxLayout *profileLayout = new QVBoxLayout(profileGroup);
+    loadProfileButton = new QPushButton("Load Profile (JSON / .pfs)...");
+    loadProfileButton->setEnabled(false);
+    profileResultLabel = new QLabel("No profile applied");
+    profileResultLabel->setWordWrap(true);
+    profileLayout->addWidget(loadProfileButton);
+    profileLayout->addWidget(profileResultLabel);
+    
+    leftPanel->addWidget(profileGroup);
+    
     // Create resolution control section
     QGroupBox *resolutionGroup = new QGroupBox("Resolution Control");
     QVBoxLayout *resolutionLayout = new QVBoxLayout(resolutionGroup);
@@ -191,6 +323,25 @@ void MainWindow::setupUI()
     
     leftPanel->addWidget(resolutionGroup);
     
+    // Create pixel format section, packed formats need less link bandwidth
+    QGroupBox *pixelFormatGroup = new QGroupBox("Pixel Format");
+    QVBoxLayout *pixelFormatLayout = new QVBoxLayout(pixelFormatGroup);
+    
+    QHBoxLayout *pixelFormatSelectLayout = new QHBoxLayout();
+    pixelFormatComboBox = new QComboBox();
+    pixelFormatComboBox->setEnabled(false);
+    setPixelFormatButton = new QPushButton("Set Format");
+    setPixelFormatButton->setEnabled(false);
+    pixelFormatSelectLayout->addWidget(pixelFormatComboBox);
+    pixelFormatSelectLayout->addWidget(setPixelFormatButton);
+    pixelFormatLayout->addLayout(pixelFormatSelectLayout);
+    
+    bandwidthLabel = new QLabel("Bandwidth: Not connected");
+    bandwidthLabel->setWordWrap(true);
+    pixelFormatLayout->addWidget(bandwidthLabel);
+    
+    leftPanel->addWidget(pixelFormatGroup);
+    
     // Create scaling control section
     QGroupBox *scalingGroup = new QGroupBox("Scaling Factor Control");
     QVBoxLayout *scalingLayout = new QVBoxLayout(scalingGroup);
@@ -442,8 +593,341 @@ void MainWindow::setupUI()
     maxRecordedImagesLayout->addWidget(setMaxRecordedImagesButton);
     recordingLayout->addLayout(maxRecordedImagesLayout);
     
+    // Recorder queue overflow policy
+    QHBoxLayout *recordingOverflowLayout = new QHBoxLayout();
+    recordingOverflowLayout->addWidget(new QLabel("When Queue Full:"));
+    recordingOverflowComboBox = new QComboBox();
+    recordingOverflowComboBox->addItem("Block", FrameRecorder::OverflowBlock);
+    recordingOverflowComboBox->addItem("Drop Newest", FrameRecorder::OverflowDropNewest);
+    recordingOverflowComboBox->addItem("Drop Oldest", FrameRecorder::OverflowDropOldest);
+    recordingOverflowComboBox->setEnabled(false);
+    recordingOverflowLayout->addWidget(recordingOverflowComboBox);
+    recordingLayout->addLayout(recordingOverflowLayout);
+    
+    // Recorder writer threads
+    QHBoxLayout *recordingWritersLayout = new QHBoxLayout();
+    recordingWritersLayout->addWidget(new QLabel("Writer Threads:"));
+    recordingWriterThreadsSpinBox = new QSpinBox();
+    recordingWriterThreadsSpinBox->setRange(1, 16);
+    recordingWriterThreadsSpinBox->setValue(1);
+    recordingWriterThreadsSpinBox->setEnabled(false);
+    recordingWritersLayout->addWidget(recordingWriterThreadsSpinBox);
+    recordingLayout->addLayout(recordingWritersLayout);
+    
+    // Recording file format
+    QHBoxLayout *recordingFormatLayout = new QHBoxLayout();
+    recordingFormatLayout->addWidget(new QLabel("File Format:"));
+    recordingFormatComboBox = new QComboBox();
+    recordingFormatComboBox->addItem("BMP files", FrameRecorder::FormatBmp);
+    recordingFormatComboBox->addItem("Raw sequence (.bseq)", FrameRecorder::FormatRawSequence);
+    recordingFormatComboBox->addItem("PNG, lossless", FrameRecorder::FormatPng);
+    recordingFormatComboBox->addItem("TIFF LZW, lossless", FrameRecorder::FormatTiffLzw);
+    recordingFormatComboBox->addItem("TIFF Deflate, lossless", FrameRecorder::FormatTiffDeflate);
+    recordingFormatComboBox->addItem("MJPEG video (.avi)", FrameRecorder::FormatVideoMjpeg);
+    recordingFormatComboBox->addItem("FFV1 video, lossless (.mkv)", FrameRecorder::FormatVideoFfv1);
+    recordingFormatComboBox->setToolTip("Raw sequences keep the native pixel format and are written without the page cache.\n"
+                                        "PNG/TIFF keep the native bit depth and are encoded on the writer threads.\n"
+                                        "Video formats store 8-bit frames in segment files on one encoder thread.");
+    recordingFormatComboBox->setEnabled(false);
+    recordingFormatLayout->addWidget(recordingFormatComboBox);
+    recordingLayout->addLayout(recordingFormatLayout);
+    
+    // Video segment length
+    QHBoxLayout *recordingSegmentLayout = new QHBoxLayout();
+    recordingSegmentLayout->addWidget(new QLabel("Segment Frames:"));
+    recordingSegmentFramesSpinBox = new QSpinBox();
+    recordingSegmentFramesSpinBox->setRange(0, 10000000);
+    recordingSegmentFramesSpinBox->setSingleStep(1000);
+    recordingSegmentFramesSpinBox->setSpecialValueText("One file");
+    recordingSegmentFramesSpinBox->setToolTip("Frames per video file before the next one starts");
+    recordingSegmentFramesSpinBox->setValue(10000);
+    recordingSegmentFramesSpinBox->setEnabled(false);
+    recordingSegmentLayout->addWidget(recordingSegmentFramesSpinBox);
+    recordingLayout->addLayout(recordingSegmentLayout);
+    
+    // Recorder queue statistics
+    recordingStatsLabel = new QLabel("Queued: 0 / Written: 0 / Dropped: 0");
+    recordingStatsLabel->setAlignment(Qt::AlignCenter);
+    recordingLayout->addWidget(recordingStatsLabel);
+    
     leftPanel->addWidget(recordingGroup);
     
+    // Create pre-trigger section, frames around an event are kept in RAM and dumped to disk
+    QGroupBox *preTriggerGroup = new QGroupBox("Pre-Trigger Buffer");
+    QVBoxLayout *preTriggerLayout = new QVBoxLayout(preTriggerGroup);
+    PreTriggerBuffer::Config preTriggerConfig = baslerCamera->getPreTriggerConfig();
+    
+    preTriggerEnableCheckBox = new QCheckBox("Keep Frames in RAM");
+    preTriggerLayout->addWidget(preTriggerEnableCheckBox);
+    
+    QGridLayout *preTriggerGrid = new QGridLayout();
+    preTriggerGrid->addWidget(new QLabel("Frames Before:"), 0, 0);
+    preTriggerFramesSpinBox = new QSpinBox();
+    preTriggerFramesSpinBox->setRange(0, 10000);
+    preTriggerFramesSpinBox->setValue(preTriggerConfig.preTriggerFrames);
+    preTriggerGrid->addWidget(preTriggerFramesSpinBox, 0, 1);
+    preTriggerGrid->addWidget(new QLabel("Frames After:"), 1, 0);
+    postTriggerFramesSpinBox = new QSpinBox();
+    postTriggerFramesSpinBox->setRange(0, 10000);
+    postTriggerFramesSpinBox->setValue(preTriggerConfig.postTriggerFrames);
+    preTriggerGrid->addWidget(postTriggerFramesSpinBox, 1, 1);
+    preTriggerGrid->addWidget(new QLabel("Memory Limit:"), 2, 0);
+    preTriggerMemorySpinBox = new QSpinBox();
+    preTriggerMemorySpinBox->setRange(0, 65536);
+    preTriggerMemorySpinBox->setSuffix(" MB");
+    preTriggerMemorySpinBox->setSpecialValueText("None");
+    preTriggerMemorySpinBox->setValue(static_cast<int>(preTriggerConfig.maxBytes / (1024 * 1024)));
+    preTriggerGrid->addWidget(preTriggerMemorySpinBox, 2, 1);
+    preTriggerGrid->addWidget(new QLabel("Save Path:"), 3, 0);
+    preTriggerPathEdit = new QLineEdit(preTriggerConfig.path);
+    preTriggerGrid->addWidget(preTriggerPathEdit, 3, 1);
+    preTriggerLayout->addLayout(preTriggerGrid);
+    
+    preTriggerOnSoftwareTriggerCheckBox = new QCheckBox("Dump on Software Trigger");
+    preTriggerOnSoftwareTriggerCheckBox->setChecked(preTriggerConfig.triggerOnSoftwareTrigger);
+    preTriggerLayout->addWidget(preTriggerOnSoftwareTriggerCheckBox);
+    
+    QHBoxLayout *preTriggerButtonLayout = new QHBoxLayout();
+    applyPreTriggerButton = new QPushButton("Apply");
+    preTriggerNowButton = new QPushButton("Dump Now");
+    preTriggerNowButton->setEnabled(false);
+    preTriggerButtonLayout->addWidget(applyPreTriggerButton);
+    preTriggerButtonLayout->addWidget(preTriggerNowButton);
+    preTriggerLayout->addLayout(preTriggerButtonLayout);
+    
+    preTriggerStatsLabel = new QLabel("Disabled");
+    preTriggerStatsLabel->setWordWrap(true);
+    preTriggerLayout->addWidget(preTriggerStatsLabel);
+    
+    leftPanel->addWidget(preTriggerGroup);
+    
+    // Create grab buffer pool section, settings apply when grabbing starts
+    QGroupBox *grabBufferGroup = new QGroupBox("Grab Buffers");
+    QVBoxLayout *grabBufferLayout = new QVBoxLayout(grabBufferGroup);
+    
+    QHBoxLayout *grabBufferCountLayout = new QHBoxLayout();
+    grabBufferCountLayout->addWidget(new QLabel("Buffer Count:"));
+    grabBufferCountSpinBox = new QSpinBox();
+    grabBufferCountSpinBox->setRange(0, 512);
+    grabBufferCountSpinBox->setValue(0);
+    grabBufferCountSpinBox->setSpecialValueText("Auto");
+    grabBufferCountLayout->addWidget(grabBufferCountSpinBox);
+    grabBufferLayout->addLayout(grabBufferCountLayout);
+    
+    grabBufferHugePagesCheckBox = new QCheckBox("Use Hugepages");
+    grabBufferLockMemoryCheckBox = new QCheckBox("Lock in RAM (mlock)");
+    grabBufferLayout->addWidget(grabBufferHugePagesCheckBox);
+    grabBufferLayout->addWidget(grabBufferLockMemoryCheckBox);
+    
+    grabBufferInfoLabel = new QLabel("Pool: Not connected");
+    grabBufferInfoLabel->setWordWrap(true);
+    grabBufferLayout->addWidget(grabBufferInfoLabel);
+    
+    leftPanel->addWidget(grabBufferGroup);
+    
+    // Create acquisition mode section
+    QGroupBox *acquisitionGroup = new QGroupBox("Acquisition");
+    QVBoxLayout *acquisitionLayout = new QVBoxLayout(acquisitionGroup);
+    
+    QHBoxLayout *grabStrategyLayout = new QHBoxLayout();
+    grabStrategyLayout->addWidget(new QLabel("Strategy:"));
+    grabStrategyComboBox = new QComboBox();
+    const IFrameSource::GrabStrategy strategies[] = {
+        IFrameSource::GrabOneByOne, IFrameSource::GrabLatestImageOnly,
+        IFrameSource::GrabLatestImages, IFrameSource::GrabUpcomingImage
+    };
+    for (IFrameSource::GrabStrategy strategy : strategies) {
+        grabStrategyComboBox->addItem(IFrameSource::grabStrategyName(strategy), strategy);
+    }
+    grabStrategyComboBox->setEnabled(false);
+    grabStrategyLayout->addWidget(grabStrategyComboBox);
+    acquisitionLayout->addLayout(grabStrategyLayout);
+    
+    QHBoxLayout *grabQueueSizeLayout = new QHBoxLayout();
+    grabQueueSizeLayout->addWidget(new QLabel("Queue Size:"));
+    grabQueueSizeSpinBox = new QSpinBox();
+    grabQueueSizeSpinBox->setRange(1, 512);
+    grabQueueSizeSpinBox->setValue(2);
+    grabQueueSizeSpinBox->setToolTip("Frames kept by LatestImages");
+    grabQueueSizeSpinBox->setEnabled(false);
+    grabQueueSizeLayout->addWidget(grabQueueSizeSpinBox);
+    acquisitionLayout->addLayout(grabQueueSizeLayout);
+    
+    eventDrivenCheckBox = new QCheckBox("Event-driven (no polling)");
+    eventDrivenCheckBox->setEnabled(false);
+    acquisitionLayout->addWidget(eventDrivenCheckBox);
+    
+    setAcquisitionModeButton = new QPushButton("Set Mode");
+    setAcquisitionModeButton->setEnabled(false);
+    acquisitionLayout->addWidget(setAcquisitionModeButton);
+    
+    leftPanel->addWidget(acquisitionGroup);
+    
+    // Create real-time thread section, applied when grabbing/recording starts
+    QGroupBox *threadPolicyGroup = new QGroupBox("Real-Time Threads");
+    QGridLayout *threadPolicyLayout = new QGridLayout(threadPolicyGroup);
+    
+    QComboBox **schedulingComboBoxes[] = { &grabSchedulingComboBox, &recorderSchedulingComboBox };
+    QSpinBox **prioritySpinBoxes[] = { &grabPrioritySpinBox, &recorderPrioritySpinBox };
+    QLineEdit **coresEdits[] = { &grabCoresEdit, &recorderCoresEdit };
+    const char *threadNames[] = { "Grab:", "Recorder:" };
+    
+    for (int row = 0; row < 2; ++row) {
+        QComboBox *scheduling = new QComboBox();
+        scheduling->addItem(ThreadPolicy::schedulingName(ThreadPolicy::SchedulingDefault), ThreadPolicy::SchedulingDefault);
+        scheduling->addItem(ThreadPolicy::schedulingName(ThreadPolicy::SchedulingFifo), ThreadPolicy::SchedulingFifo);
+        scheduling->addItem(ThreadPolicy::schedulingName(ThreadPolicy::SchedulingRoundRobin), ThreadPolicy::SchedulingRoundRobin);
+        
+        QSpinBox *priority = new QSpinBox();
+        priority->setRange(1, 99);
+        priority->setValue(row == 0 ? 80 : 20);
+        priority->setToolTip("Real-time priority for SCHED_FIFO/SCHED_RR");
+        
+        QLineEdit *cores = new QLineEdit();
+        cores->setPlaceholderText("cores, e.g. 2-3");
+        
+        threadPolicyLayout->addWidget(new QLabel(threadNames[row]), row, 0);
+        threadPolicyLayout->addWidget(scheduling, row, 1);
+        threadPolicyLayout->addWidget(priority, row, 2);
+        threadPolicyLayout->addWidget(cores, row, 3);
+        
+        *schedulingComboBoxes[row] = scheduling;
+        *prioritySpinBoxes[row] = priority;
+        *coresEdits[row] = cores;
+    }
+    
+    threadPolicyLayout->addWidget(new QLabel("Memory Node:"), 2, 0);
+    memoryNodeSpinBox = new QSpinBox();
+    memoryNodeSpinBox->setRange(-1, ThreadPolicy::nodeCount() - 1);
+    memoryNodeSpinBox->setValue(-1);
+    memoryNodeSpinBox->setSpecialValueText("Off");
+    memoryNodeSpinBox->setToolTip("Preferred NUMA node for grab buffers and recorder memory, also the default cores");
+    threadPolicyLayout->addWidget(memoryNodeSpinBox, 2, 1);
+    applyThreadPolicyButton = new QPushButton("Apply");
+    threadPolicyLayout->addWidget(applyThreadPolicyButton, 2, 3);
+    
+    threadPolicyLabel = new QLabel("Grab: Not started\nRecorder: Not started");
+    threadPolicyLabel->setWordWrap(true);
+    threadPolicyLayout->addWidget(threadPolicyLabel, 3, 0, 1, 4);
+    
+    leftPanel->addWidget(threadPolicyGroup);
+    
+    // Create multi-camera section, uses the backend selected under Frame Source
+    QGroupBox *multiCameraGroup = new QGroupBox("Multi-Camera");
+    QVBoxLayout *multiCameraLayout = new QVBoxLayout(multiCameraGroup);
+    
+    QHBoxLayout *multiCameraCountLayout = new QHBoxLayout();
+    multiCameraCountLayout->addWidget(new QLabel("Cameras:"));
+    multiCameraCountSpinBox = new QSpinBox();
+    multiCameraCountSpinBox->setRange(0, 64);
+    multiCameraCountSpinBox->setValue(0);
+    multiCameraCountSpinBox->setSpecialValueText("All");
+    multiCameraCountSpinBox->setToolTip("Devices to open, number of generators for Synthetic");
+    multiCameraCountLayout->addWidget(multiCameraCountSpinBox);
+    multiCameraCountLayout->addWidget(new QLabel("First Core:"));
+    multiCameraFirstCoreSpinBox = new QSpinBox();
+    multiCameraFirstCoreSpinBox->setRange(-1, 1023);
+    multiCameraFirstCoreSpinBox->setValue(-1);
+    multiCameraFirstCoreSpinBox->setSpecialValueText("Off");
+    multiCameraFirstCoreSpinBox->setToolTip("Grab threads are pinned round robin from this core on");
+    multiCameraCountLayout->addWidget(multiCameraFirstCoreSpinBox);
+    multiCameraLayout->addLayout(multiCameraCountLayout);
+    
+    QHBoxLayout *multiCameraButtonLayout = new QHBoxLayout();
+    multiCameraOpenButton = new QPushButton("Open All");
+    multiCameraGrabButton = new QPushButton("Start All");
+    multiCameraGrabButton->setEnabled(false);
+    multiCameraCloseButton = new QPushButton("Close All");
+    multiCameraCloseButton->setEnabled(false);
+    multiCameraButtonLayout->addWidget(multiCameraOpenButton);
+    multiCameraButtonLayout->addWidget(multiCameraGrabButton);
+    multiCameraButtonLayout->addWidget(multiCameraCloseButton);
+    multiCameraLayout->addLayout(multiCameraButtonLayout);
+    
+    multiCameraStatsLabel = new QLabel("No cameras open");
+    multiCameraStatsLabel->setWordWrap(true);
+    multiCameraStatsLabel->setStyleSheet("QLabel { font-family: monospace; }");
+    multiCameraLayout->addWidget(multiCameraStatsLabel);
+    
+    leftPanel->addWidget(multiCameraGroup);
+    
+    // Create preview section, the preview is rendered at the size of the image area
+    QGroupBox *previewGroup = new QGroupBox("Preview");
+    QHBoxLayout *previewLayout = new QHBoxLayout(previewGroup);
+    previewQualityComboBox = new QComboBox();
+    previewQualityComboBox->addItem(PreviewRenderer::qualityName(PreviewRenderer::QualityFast), PreviewRenderer::QualityFast);
+    previewQualityComboBox->addItem(PreviewRenderer::qualityName(PreviewRenderer::QualityBalanced), PreviewRenderer::QualityBalanced);
+    previewQualityComboBox->addItem(PreviewRenderer::qualityName(PreviewRenderer::QualitySmooth), PreviewRenderer::QualitySmooth);
+    previewQualityComboBox->setCurrentIndex(1);
+    previewLayout->addWidget(new QLabel("Quality:"));
+    previewLayout->addWidget(previewQualityComboBox);
+    leftPanel->addWidget(previewGroup);
+    
+    // Create display mapping section for deep mono formats, values are raw sensor units
+    QGroupBox *displayMappingGroup = new QGroupBox("Display Mapping (Mono10/12/16)");
+    QVBoxLayout *displayMappingLayout = new QVBoxLayout(displayMappingGroup);
+    
+    displayFullRangeCheckBox = new QCheckBox("Full Range");
+    displayFullRangeCheckBox->setChecked(true);
+    displayMappingLayout->addWidget(displayFullRangeCheckBox);
+    
+    QHBoxLayout *displayWindowLayout = new QHBoxLayout();
+    displayWindowLowSpinBox = new QSpinBox();
+    displayWindowLowSpinBox->setRange(0, 65534);
+    displayWindowLowSpinBox->setValue(0);
+    displayWindowLowSpinBox->setEnabled(false);
+    displayWindowHighSpinBox = new QSpinBox();
+    displayWindowHighSpinBox->setRange(1, 65535);
+    displayWindowHighSpinBox->setValue(4095);
+    displayWindowHighSpinBox->setEnabled(false);
+    displayWindowLayout->addWidget(new QLabel("Low:"));
+    displayWindowLayout->addWidget(displayWindowLowSpinBox);
+    displayWindowLayout->addWidget(new QLabel("High:"));
+    displayWindowLayout->addWidget(displayWindowHighSpinBox);
+    displayMappingLayout->addLayout(displayWindowLayout);
+    
+    QHBoxLayout *displayGammaLayout = new QHBoxLayout();
+    displayGammaSpinBox = new QDoubleSpinBox();
+    displayGammaSpinBox->setRange(0.1, 5.0);
+    displayGammaSpinBox->setSingleStep(0.1);
+    displayGammaSpinBox->setDecimals(2);
+    displayGammaSpinBox->setValue(1.0);
+    displayGammaLayout->addWidget(new QLabel("Gamma:"));
+    displayGammaLayout->addWidget(displayGammaSpinBox);
+    displayMappingLayout->addLayout(displayGammaLayout);
+    
+    // Gamma 1 runs the SIMD window kernel, anything else a lookup table
+    displayMappingLayout->addWidget(new QLabel(QString("Kernel: %1")
+        .arg(MonoDisplayMapper::simdLevelName(MonoDisplayMapper::detectSimdLevel()))));
+    
+    leftPanel->addWidget(displayMappingGroup);
+    
+    // Create Bayer section, the gains are used for display, getImage() and recording
+    QGroupBox *bayerGroup = new QGroupBox("Bayer Demosaic (BayerRG8/BG8/GR8/GB8)");
+    QVBoxLayout *bayerLayout = new QVBoxLayout(bayerGroup);
+    
+    QHBoxLayout *whiteBalanceLayout = new QHBoxLayout();
+    QDoubleSpinBox **gainSpinBoxes[] = { &whiteBalanceRedSpinBox, &whiteBalanceGreenSpinBox, &whiteBalanceBlueSpinBox };
+    const char *gainLabels[] = { "R:", "G:", "B:" };
+    for (int i = 0; i < 3; ++i) {
+        QDoubleSpinBox *spinBox = new QDoubleSpinBox();
+        spinBox->setRange(0.0, 8.0);
+        spinBox->setSingleStep(0.05);
+        spinBox->setDecimals(2);
+        spinBox->setValue(1.0);
+        whiteBalanceLayout->addWidget(new QLabel(gainLabels[i]));
+        whiteBalanceLayout->addWidget(spinBox);
+        *gainSpinBoxes[i] = spinBox;
+    }
+    bayerLayout->addLayout(whiteBalanceLayout);
+    
+    // The half-resolution preview is several times cheaper than the full demosaic
+    bayerFullResolutionCheckBox = new QCheckBox("Full Resolution Preview");
+    bayerFullResolutionCheckBox->setChecked(false);
+    bayerLayout->addWidget(bayerFullResolutionCheckBox);
+    
+    leftPanel->addWidget(bayerGroup);
+    
     // Create status label
     statusLabel = new QLabel("Status: Ready");
     statusLabel->setStyleSheet("QLabel { color: blue; font-weight: bold; padding: 5px; }");
@@ -466,6 +950,79 @@ void MainWindow::setupUI()
     
     leftPanel->addWidget(ipGroup);
     
+    // Create frame source section
+    QGroupBox *sourceGroup = new QGroupBox("Frame Source");
+    QHBoxLayout *sourceLayout = new QHBoxLayout(sourceGroup);
+    
+    sourceTypeComboBox = new QComboBox();
+    sourceTypeComboBox->addItem("Basler GigE", BaslerCamera::SourceGigE);
+    sourceTypeComboBox->addItem("Pylon Emulator", BaslerCamera::SourceEmulator);
+    sourceTypeComboBox->addItem("Synthetic", BaslerCamera::SourceSynthetic);
+    sourceTypeComboBox->addItem("Playback", BaslerCamera::SourcePlayback);
+    
+    // Pixel format of the synthetic generator
+    syntheticPixelFormatComboBox = new QComboBox();
+    syntheticPixelFormatComboBox->addItem("Mono8", PixelType_Mono8);
+    syntheticPixelFormatComboBox->addItem("Mono10", PixelType_Mono10);
+    syntheticPixelFormatComboBox->addItem("Mono12", PixelType_Mono12);
+    syntheticPixelFormatComboBox->addItem("Mono16", PixelType_Mono16);
+    syntheticPixelFormatComboBox->addItem("RGB8", PixelType_RGB8packed);
+    syntheticPixelFormatComboBox->addItem("BGR8", PixelType_BGR8packed);
+    syntheticPixelFormatComboBox->addItem("BayerRG8", PixelType_BayerRG8);
+    syntheticPixelFormatComboBox->setEnabled(false);
+    
+    sourceLayout->addWidget(new QLabel("Source:"));
+    sourceLayout->addWidget(sourceTypeComboBox);
+    sourceLayout->addWidget(new QLabel("Format:"));
+    sourceLayout->addWidget(syntheticPixelFormatComboBox);
+    
+    leftPanel->addWidget(sourceGroup);
+    
+    // Create playback section, a recording replaces the camera on the next connect
+    QGroupBox *playbackGroup = new QGroupBox("Playback");
+    QVBoxLayout *playbackLayout = new QVBoxLayout(playbackGroup);
+    
+    QHBoxLayout *playbackPathLayout = new QHBoxLayout();
+    playbackPathEdit = new QLineEdit(baslerCamera->getPlaybackPath());
+    playbackPathEdit->setPlaceholderText(".bseq file or image directory");
+    playbackFileButton = new QPushButton("File...");
+    playbackFolderButton = new QPushButton("Folder...");
+    playbackPathLayout->addWidget(playbackPathEdit);
+    playbackPathLayout->addWidget(playbackFileButton);
+    playbackPathLayout->addWidget(playbackFolderButton);
+    playbackLayout->addLayout(playbackPathLayout);
+    
+    QHBoxLayout *playbackModeLayout = new QHBoxLayout();
+    playbackPacingComboBox = new QComboBox();
+    playbackPacingComboBox->addItem("Real Time", PlaybackFrameSource::PacingRealTime);
+    playbackPacingComboBox->addItem("Max Speed", PlaybackFrameSource::PacingMaxSpeed);
+    playbackPacingComboBox->setToolTip("Real time follows the recorded timestamps, image directories use the frame rate");
+    playbackLoopCheckBox = new QCheckBox("Loop");
+    playbackModeLayout->addWidget(new QLabel("Pacing:"));
+    playbackModeLayout->addWidget(playbackPacingComboBox);
+    playbackModeLayout->addWidget(playbackLoopCheckBox);
+    playbackLayout->addLayout(playbackModeLayout);
+    
+    QHBoxLayout *playbackSeekLayout = new QHBoxLayout();
+    playbackSeekSpinBox = new QSpinBox();
+    playbackSeekSpinBox->setRange(0, 0);
+    playbackSeekSpinBox->setEnabled(false);
+    playbackSeekButton = new QPushButton("Seek");
+    playbackSeekButton->setEnabled(false);
+    playbackSeekLayout->addWidget(new QLabel("Frame:"));
+    playbackSeekLayout->addWidget(playbackSeekSpinBox);
+    playbackSeekLayout->addWidget(playbackSeekButton);
+    playbackLayout->addLayout(playbackSeekLayout);
+    
+    playbackPositionLabel = new QLabel("Not playing back");
+    playbackLayout->addWidget(playbackPositionLabel);
+    
+    playbackPathEdit->setEnabled(false);
+    playbackFileButton->setEnabled(false);
+    playbackFolderButton->setEnabled(false);
+    
+    leftPanel->addWidget(playbackGroup);
+    
     // Create button layout
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     
@@ -513,8 +1070,50 @@ void MainWindow::setupUI()
     connect(connectButton, &QPushButton::clicked, this, &MainWindow::onConnectClicked);
     connect(disconnectButton, &QPushButton::clicked, this, &MainWindow::onDisconnectClicked);
     connect(setIPButton, &QPushButton::clicked, this, &MainWindow::onSetIPClicked);
+    connect(dumpLatencyButton, &QPushButton::clicked, this, &MainWindow::onDumpLatencyClicked);
+    connect(dumpFrameTimingButton, &QPushButton::clicked, this, &MainWindow::onDumpFrameTimingClicked);
+    connect(loadProfileButton, &QPushButton::clicked, this, &MainWindow::onLoadProfileClicked);
+    connect(grabBufferCountSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onGrabBufferSettingsChanged);
+    connect(grabBufferHugePagesCheckBox, &QCheckBox::toggled, this, &MainWindow::onGrabBufferSettingsChanged);
+    connect(grabBufferLockMemoryCheckBox, &QCheckBox::toggled, this, &MainWindow::onGrabBufferSettingsChanged);
+    connect(setAcquisitionModeButton, &QPushButton::clicked, this, &MainWindow::onSetAcquisitionModeClicked);
+    connect(applyThreadPolicyButton, &QPushButton::clicked, this, &MainWindow::onApplyThreadPolicyClicked);
+    connect(multiCameraOpenButton, &QPushButton::clicked, this, &MainWindow::onMultiCameraOpenClicked);
+    connect(multiCameraGrabButton, &QPushButton::clicked, this, &MainWindow::onMultiCameraGrabClicked);
+    connect(multiCameraCloseButton, &QPushButton::clicked, this, &MainWindow::onMultiCameraCloseClicked);
+    connect(multiCameraFirstCoreSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onMultiCameraFirstCoreChanged);
+    connect(resetLatencyButton, &QPushButton::clicked, this, &MainWindow::onResetLatencyClicked);
+    connect(displayFullRangeCheckBox, &QCheckBox::toggled, this, &MainWindow::onDisplayMappingChanged);
+    connect(displayWindowLowSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onDisplayMappingChanged);
+    connect(displayWindowHighSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onDisplayMappingChanged);
+    connect(displayGammaSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onDisplayMappingChanged);
+    connect(whiteBalanceRedSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onWhiteBalanceChanged);
+    connect(whiteBalanceGreenSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onWhiteBalanceChanged);
+    connect(whiteBalanceBlueSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &MainWindow::onWhiteBalanceChanged);
+    connect(bayerFullResolutionCheckBox, &QCheckBox::toggled, this, &MainWindow::onPreviewSettingsChanged);
+    connect(previewQualityComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onPreviewSettingsChanged);
+    connect(sourceTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onSourceTypeChanged);
+    connect(playbackFileButton, &QPushButton::clicked, this, &MainWindow::onPlaybackBrowseFileClicked);
+    connect(playbackFolderButton, &QPushButton::clicked, this, &MainWindow::onPlaybackBrowseFolderClicked);
+    connect(playbackPacingComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onPlaybackPacingChanged);
+    connect(playbackLoopCheckBox, &QCheckBox::toggled, this, &MainWindow::onPlaybackLoopChanged);
+    connect(playbackSeekButton, &QPushButton::clicked, this, &MainWindow::onPlaybackSeekClicked);
+    connect(syntheticPixelFormatComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onSyntheticPixelFormatChanged);
     connect(grabButton, &QPushButton::clicked, this, &MainWindow::onGrabClicked);
     connect(setResolutionButton, &QPushButton::clicked, this, &MainWindow::onSetResolutionClicked);
+    connect(setPixelFormatButton, &QPushButton::clicked, this, &MainWindow::onSetPixelFormatClicked);
     connect(setScalingFactorButton, &QPushButton::clicked, this, &MainWindow::onSetScalingFactorClicked);
     connect(setExposureTimeButton, &QPushButton::clicked, this, &MainWindow::onSetExposureTimeClicked);
     connect(setFrameRateButton, &QPushButton::clicked, this, &MainWindow::onSetFrameRateClicked);
@@ -533,10 +1132,22 @@ void MainWindow::setupUI()
     connect(triggerSourceComboBox, QOverload<const QString &>::of(&QComboBox::currentTextChanged),
             this, &MainWindow::onTriggerSourceChanged);
     connect(softwareTriggerButton, &QPushButton::clicked, this, &MainWindow::onSoftwareTriggerClicked);
+    connect(baslerCamera, &BaslerCamera::parameterWriteFinished, this, &MainWindow::onParameterWriteFinished);
     connect(recordingToggleButton, &QPushButton::clicked, this, &MainWindow::onRecordingToggleClicked);
     connect(resetRecordingCountButton, &QPushButton::clicked, this, &MainWindow::onResetRecordingCountClicked);
     connect(setRecordingPathButton, &QPushButton::clicked, this, &MainWindow::onSetRecordingPathClicked);
     connect(setMaxRecordedImagesButton, &QPushButton::clicked, this, &MainWindow::onSetMaxRecordedImagesClicked);
+    connect(recordingOverflowComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onRecordingOverflowPolicyChanged);
+    connect(recordingWriterThreadsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onRecordingWriterThreadsChanged);
+    connect(recordingFormatComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onRecordingFormatChanged);
+    connect(recordingSegmentFramesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::onRecordingSegmentFramesChanged);
+    connect(applyPreTriggerButton, &QPushButton::clicked, this, &MainWindow::onApplyPreTriggerClicked);
+    connect(preTriggerNowButton, &QPushButton::clicked, this, &MainWindow::onPreTriggerNowClicked);
+    connect(baslerCamera, &BaslerCamera::preTriggerDumpFinished, this, &MainWindow::onPreTriggerDumpFinished);
     
     // Set window properties
     setWindowTitle("Basler Camera Grabber");
@@ -546,10 +1157,20 @@ void MainWindow::setupUI()
 
 void MainWindow::onConnectClicked()
 {
+    baslerCamera->setPlaybackPath(playbackPathEdit->text().trimmed());
+    
     if (baslerCamera->connect()) {
         connectButton->setEnabled(false);
+        sourceTypeComboBox->setEnabled(false);
+        playbackPathEdit->setEnabled(false);
+        playbackFileButton->setEnabled(false);
+        playbackFolderButton->setEnabled(false);
+        playbackSeekSpinBox->setRange(0, qMax(0, baslerCamera->getPlaybackFrameCount() - 1));
+        playbackSeekSpinBox->setEnabled(baslerCamera->getPlaybackFrameCount() > 0);
+        playbackSeekButton->setEnabled(baslerCamera->getPlaybackFrameCount() > 0);
         disconnectButton->setEnabled(true);
         grabButton->setEnabled(true);
+        loadProfileButton->setEnabled(true);
         setResolutionButton->setEnabled(true);
         setScalingFactorButton->setEnabled(true);
         setExposureTimeButton->setEnabled(true);
@@ -578,10 +1199,19 @@ void MainWindow::onConnectClicked()
         setRecordingPathButton->setEnabled(true);
         maxRecordedImagesSpinBox->setEnabled(true);
         setMaxRecordedImagesButton->setEnabled(true);
+        recordingOverflowComboBox->setEnabled(true);
+        recordingWriterThreadsSpinBox->setEnabled(true);
+        recordingFormatComboBox->setEnabled(true);
+        recordingSegmentFramesSpinBox->setEnabled(true);
+        grabStrategyComboBox->setEnabled(true);
+        grabQueueSizeSpinBox->setEnabled(true);
+        eventDrivenCheckBox->setEnabled(true);
+        setAcquisitionModeButton->setEnabled(true);
         
         updateCameraInfo();
         updateCameraSettings();
         updateResolutionControls();
+        updatePixelFormatControls();
         updateScalingControls();
         updateExposureControls();
         updateFrameRateControls();
@@ -596,8 +1226,17 @@ void MainWindow::onDisconnectClicked()
 {
     baslerCamera->disconnect();
     connectButton->setEnabled(true);
+    sourceTypeComboBox->setEnabled(true);
+    const bool playback = (baslerCamera->getSourceType() == BaslerCamera::SourcePlayback);
+    playbackPathEdit->setEnabled(playback);
+    playbackFileButton->setEnabled(playback);
+    playbackFolderButton->setEnabled(playback);
+    playbackSeekSpinBox->setEnabled(false);
+    playbackSeekButton->setEnabled(false);
+    updatePlaybackDisplay();
     disconnectButton->setEnabled(false);
     grabButton->setEnabled(false);
+    loadProfileButton->setEnabled(false);
     setResolutionButton->setEnabled(false);
     setScalingFactorButton->setEnabled(false);
     setExposureTimeButton->setEnabled(false);
@@ -626,6 +1265,16 @@ void MainWindow::onDisconnectClicked()
     setRecordingPathButton->setEnabled(false);
     maxRecordedImagesSpinBox->setEnabled(false);
     setMaxRecordedImagesButton->setEnabled(false);
+    recordingOverflowComboBox->setEnabled(false);
+    recordingWriterThreadsSpinBox->setEnabled(false);
+    recordingFormatComboBox->setEnabled(false);
+    recordingSegmentFramesSpinBox->setEnabled(false);
+    grabStrategyComboBox->setEnabled(false);
+    grabQueueSizeSpinBox->setEnabled(false);
+    eventDrivenCheckBox->setEnabled(false);
+    setAcquisitionModeButton->setEnabled(false);
+    pixelFormatComboBox->setEnabled(false);
+    setPixelFormatButton->setEnabled(false);
     grabButton->setText("Start Grabbing");
     
     // Clear image and camera info
@@ -634,6 +1283,8 @@ void MainWindow::onDisconnectClicked()
     cameraSettingsLabel->setText("Settings: Not available");
     resolutionComboBox->clear();
     resolutionComboBox->addItem("Select resolution...");
+    pixelFormatComboBox->clear();
+    bandwidthLabel->setText("Bandwidth: Not connected");
     scalingFactorLabel->setText("Current: 1.00x");
     exposureTimeLabel->setText("Current: 10000 μs");
     frameRateLabel->setText("Current: 30.0 fps");
@@ -661,12 +1312,8 @@ void MainWindow::onSetResolutionClicked()
     int width = widthSpinBox->value();
     int height = heightSpinBox->value();
     
-    if (baslerCamera->setResolution(width, height)) {
-        updateCameraSettings();
-        updateResolutionControls();
-    } else {
-        QMessageBox::warning(this, "Resolution Error", "Failed to set resolution!");
-    }
+    // Applied on the camera-control thread, see onParameterWriteFinished()
+    baslerCamera->setResolutionAsync(width, height);
 }
 
 void MainWindow::onResolutionComboChanged(const QString &text)
@@ -689,22 +1336,57 @@ void MainWindow::onResolutionComboChanged(const QString &text)
     }
 }
 
-void MainWindow::updateImage()
+void MainWindow::updateImage(const FrameHandle &frame)
 {
     if (baslerCamera->isConnected()) {
-        cv::Mat image = baslerCamera->getImage();
-        
-        if (!image.empty()) {
-            // Convert OpenCV Mat to QImage
-            QImage qimg(image.data, image.cols, image.rows, image.step, QImage::Format_RGB888);
-            qimg = qimg.rgbSwapped(); // Convert BGR to RGB
-            
-            // Scale image to fit label while maintaining aspect ratio
-            QPixmap pixmap = QPixmap::fromImage(qimg);
-            pixmap = pixmap.scaled(imageLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            
-            imageLabel->setPixmap(pixmap);
-        }
+        // Called at most once per screen refresh, the preview worker does the conversion
+        previewRenderer->setTargetSize(imageLabel->contentsRect().size());
+        previewRenderer->submit(frame);
+    }
+}
+
+void MainWindow::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        updateDisplayActive();
+    }
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateDisplayActive();
+}
+
+void MainWindow::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateDisplayActive();
+}
+
+void MainWindow::updateDisplayActive()
+{
+    displayScheduler->setActive(isVisible() && !isMinimized());
+}
+
+void MainWindow::onPreviewReady(const QImage &image, qint64 frameId, qint64 timestampNs, qint64 convertNs)
+{
+    // A preview rendered just before disconnecting must not replace "No Image"
+    if (!baslerCamera->isConnected()) {
+        return;
+    }
+    
+    baslerCamera->recordLatency(BaslerCamera::LatencyConvert, convertNs);
+    
+    // Already display-sized, no scaling on the GUI thread
+    imageLabel->setPixmap(QPixmap::fromImage(image));
+    
+    // A settings change renders the same frame again, only its first paint counts
+    if (frameId != lastPaintedFrameId) {
+        lastPaintedFrameId = frameId;
+        baslerCamera->recordLatency(BaslerCamera::LatencyDisplay,
+                                    FrameHandle::currentTimestampNs() - timestampNs);
     }
 }
 
@@ -746,16 +1428,37 @@ void MainWindow::updateResolutionControls()
     }
 }
 
-void MainWindow::onSetScalingFactorClicked()
+void MainWindow::updatePixelFormatControls()
 {
-    double factor = scalingFactorSpinBox->value();
+    if (!baslerCamera->isConnected()) {
+        return;
+    }
     
-    if (baslerCamera->setScalingFactor(factor)) {
-        updateCameraSettings();
-        updateScalingControls();
-    } else {
-        QMessageBox::warning(this, "Scaling Factor Error", "Failed to set scaling factor!");
+    // The synthetic source takes its format from the Frame Source group
+    QStringList formats = baslerCamera->getAvailablePixelFormats();
+    pixelFormatComboBox->clear();
+    pixelFormatComboBox->addItems(formats);
+    pixelFormatComboBox->setCurrentText(baslerCamera->getPixelFormat());
+    pixelFormatComboBox->setEnabled(!formats.isEmpty());
+    setPixelFormatButton->setEnabled(!formats.isEmpty());
+    
+    bandwidthLabel->setText("Bandwidth: " + baslerCamera->getBandwidthInfo());
+}
+
+void MainWindow::onSetPixelFormatClicked()
+{
+    QString format = pixelFormatComboBox->currentText();
+    if (format.isEmpty()) {
+        return;
     }
+    
+    baslerCamera->setParameterAsync(CameraParameterModel::PixelFormat, format);
+}
+
+void MainWindow::onSetScalingFactorClicked()
+{
+    double factor = scalingFactorSpinBox->value();
+    baslerCamera->setParameterAsync(CameraParameterModel::ScalingFactor, factor);
 }
 
 void MainWindow::onScalingFactorSliderChanged(int value)
@@ -763,6 +1466,12 @@ void MainWindow::onScalingFactorSliderChanged(int value)
     double factor = value / 100.0;
     scalingFactorSpinBox->setValue(factor);
     scalingFactorLabel->setText(QString("Current: %1x").arg(factor, 0, 'f', 2));
+    
+    // Applied while dragging, queued writes are coalesced to the newest value.
+    // Only cameras with a node map have this parameter.
+    if (baslerCamera->getParameterModel()->isAttached()) {
+        baslerCamera->setParameterAsync(CameraParameterModel::ScalingFactor, factor);
+    }
 }
 
 void MainWindow::updateScalingControls()
@@ -771,12 +1480,17 @@ void MainWindow::updateScalingControls()
         return;
     }
     
+    // Showing the camera's value must not write it back, nor move the slider under the user
+    QSignalBlocker sliderBlocker(scalingFactorSlider);
+    
     // Update spin box with current value
     scalingFactorSpinBox->setValue(baslerCamera->getScalingFactor());
     
     // Update slider with current value
     int sliderValue = static_cast<int>(baslerCamera->getScalingFactor() * 100);
-    scalingFactorSlider->setValue(sliderValue);
+    if (!scalingFactorSlider->isSliderDown()) {
+        scalingFactorSlider->setValue(sliderValue);
+    }
     
     // Update label
     scalingFactorLabel->setText(QString("Current: %1x").arg(baslerCamera->getScalingFactor(), 0, 'f', 2));
@@ -794,31 +1508,23 @@ void MainWindow::updateScalingControls()
 void MainWindow::onSetExposureTimeClicked()
 {
     double exposureTime = exposureTimeSpinBox->value();
-    
-    if (baslerCamera->setExposureTime(exposureTime)) {
-        updateCameraSettings();
-        updateExposureControls();
-    } else {
-        QMessageBox::warning(this, "Exposure Time Error", "Failed to set exposure time!");
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::ExposureTime, exposureTime);
 }
 
 void MainWindow::onExposureTimeSliderChanged(int value)
 {
     exposureTimeSpinBox->setValue(value);
     exposureTimeLabel->setText(QString("Current: %1 μs").arg(value));
+    
+    if (baslerCamera->getParameterModel()->isAttached()) {
+        baslerCamera->setParameterAsync(CameraParameterModel::ExposureTime, static_cast<double>(value));
+    }
 }
 
 void MainWindow::onExposureAutoChanged(bool checked)
 {
-    if (baslerCamera->setExposureAuto(checked)) {
-        updateCameraSettings();
-        updateExposureControls();
-    } else {
-        QMessageBox::warning(this, "Exposure Auto Error", "Failed to set exposure auto!");
-        // Revert checkbox state
-        exposureAutoCheckBox->setChecked(!checked);
-    }
+    // A failed write reverts the checkbox in onParameterWriteFinished()
+    baslerCamera->setParameterAsync(CameraParameterModel::ExposureAuto, QString(checked ? "Continuous" : "Off"));
 }
 
 void MainWindow::updateExposureControls()
@@ -827,11 +1533,17 @@ void MainWindow::updateExposureControls()
         return;
     }
     
+    // Showing the camera's values must not write them back, nor move the slider under the user
+    QSignalBlocker sliderBlocker(exposureTimeSlider);
+    QSignalBlocker autoBlocker(exposureAutoCheckBox);
+    
     // Update spin box with current value
     exposureTimeSpinBox->setValue(baslerCamera->getExposureTime());
     
     // Update slider with current value
-    exposureTimeSlider->setValue(static_cast<int>(baslerCamera->getExposureTime()));
+    if (!exposureTimeSlider->isSliderDown()) {
+        exposureTimeSlider->setValue(static_cast<int>(baslerCamera->getExposureTime()));
+    }
     
     // Update label
     exposureTimeLabel->setText(QString("Current: %1 μs").arg(baslerCamera->getExposureTime(), 0, 'f', 0));
@@ -858,13 +1570,7 @@ void MainWindow::updateExposureControls()
 void MainWindow::onSetFrameRateClicked()
 {
     double frameRate = frameRateSpinBox->value();
-    
-    if (baslerCamera->setFrameRate(frameRate)) {
-        updateCameraSettings();
-        updateFrameRateControls();
-    } else {
-        QMessageBox::warning(this, "Frame Rate Error", "Failed to set frame rate!");
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::AcquisitionFrameRate, frameRate);
 }
 
 void MainWindow::onFrameRateSliderChanged(int value)
@@ -872,18 +1578,15 @@ void MainWindow::onFrameRateSliderChanged(int value)
     double frameRate = value / 10.0;
     frameRateSpinBox->setValue(frameRate);
     frameRateLabel->setText(QString("Current: %1 fps").arg(frameRate, 0, 'f', 1));
+    
+    if (baslerCamera->isConnected()) {
+        baslerCamera->setParameterAsync(CameraParameterModel::AcquisitionFrameRate, frameRate);
+    }
 }
 
 void MainWindow::onFrameRateEnabledChanged(bool checked)
 {
-    if (baslerCamera->setFrameRateEnabled(checked)) {
-        updateCameraSettings();
-        updateFrameRateControls();
-    } else {
-        QMessageBox::warning(this, "Frame Rate Enable Error", "Failed to set frame rate enable!");
-        // Revert checkbox state
-        frameRateEnabledCheckBox->setChecked(!checked);
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::AcquisitionFrameRateEnable, checked);
 }
 
 void MainWindow::updateFrameRateControls()
@@ -892,12 +1595,18 @@ void MainWindow::updateFrameRateControls()
         return;
     }
     
+    // Showing the camera's values must not write them back, nor move the slider under the user
+    QSignalBlocker sliderBlocker(frameRateSlider);
+    QSignalBlocker enabledBlocker(frameRateEnabledCheckBox);
+    
     // Update spin box with current value
     frameRateSpinBox->setValue(baslerCamera->getFrameRate());
     
     // Update slider with current value
     int sliderValue = static_cast<int>(baslerCamera->getFrameRate() * 10);
-    frameRateSlider->setValue(sliderValue);
+    if (!frameRateSlider->isSliderDown()) {
+        frameRateSlider->setValue(sliderValue);
+    }
     
     // Update label
     frameRateLabel->setText(QString("Current: %1 fps").arg(baslerCamera->getFrameRate(), 0, 'f', 1));
@@ -926,6 +1635,258 @@ void MainWindow::onFrameRateUpdated(double frameRate)
     // Update real-time frame rate display
     realTimeFrameRateLabel->setText(QString("Current FPS: %1").arg(frameRate, 0, 'f', 1));
     frameCountLabel->setText(QString("Frame Count: %1").arg(baslerCamera->getFrameCount()));
+    overwrittenFramesLabel->setText(QString("Overwritten: %1").arg(baslerCamera->getOverwrittenFrameCount()));
+    skippedFramesLabel->setText(QString("Skipped: %1").arg(baslerCamera->getSkippedFrameCount()));
+    updatePreTriggerDisplay();
+    updatePlaybackDisplay();
+    
+    FrameStatistics::Snapshot statistics = baslerCamera->getFrameStatistics();
+    if (statistics.windowSize > 0) {
+        frameIntervalLabel->setText(QString("Interval (last %1): mean %2 ms, sd %3, min %4, max %5\n"
+                                            "p50 %6 ms, p95 %7, p99 %8, instant %9 fps")
+                                    .arg(statistics.windowSize)
+                                    .arg(statistics.meanIntervalMs, 0, 'f', 2)
+                                    .arg(statistics.stddevIntervalMs, 0, 'f', 2)
+                                    .arg(statistics.minIntervalMs, 0, 'f', 2)
+                                    .arg(statistics.maxIntervalMs, 0, 'f', 2)
+                                    .arg(statistics.p50IntervalMs, 0, 'f', 2)
+                                    .arg(statistics.p95IntervalMs, 0, 'f', 2)
+                                    .arg(statistics.p99IntervalMs, 0, 'f', 2)
+                                    .arg(statistics.instantFps, 0, 'f', 1));
+    } else {
+        frameIntervalLabel->setText("Interval: no samples");
+    }
+    
+    FrameTimingMonitor::Snapshot timing = baslerCamera->getFrameTiming();
+    QString sensorText = QString("Missing: %1 (block ID gaps)").arg(timing.missingFrames);
+    if (timing.sensor.windowSize > 0) {
+        sensorText = QString("Sensor: %1 fps, interval sd %2 ms, min %3, max %4\n"
+                             "Delivery (%5): p50 %6 ms, p99 %7, max %8\n")
+                     .arg(timing.sensor.windowFps, 0, 'f', 1)
+                     .arg(timing.sensor.stddevIntervalMs, 0, 'f', 3)
+                     .arg(timing.sensor.minIntervalMs, 0, 'f', 2)
+                     .arg(timing.sensor.maxIntervalMs, 0, 'f', 2)
+                     .arg(timing.latencyAbsolute ? "absolute" : "above fastest")
+                     .arg(timing.latencyP50Ms, 0, 'f', 2)
+                     .arg(timing.latencyP99Ms, 0, 'f', 2)
+                     .arg(timing.latencyMaxMs, 0, 'f', 2)
+                     + sensorText;
+    }
+    sensorTimingLabel->setText(sensorText);
+    updateLatencyDisplay();
+    grabBufferInfoLabel->setText("Pool: " + baslerCamera->getGrabBufferInfo());
+    threadPolicyLabel->setText("Grab: " + baslerCamera->getGrabThreadPolicyReport()
+                               + "\nRecorder: " + baslerCamera->getRecorderThreadPolicyReport());
+    bandwidthLabel->setText("Bandwidth: " + baslerCamera->getBandwidthInfo());
+}
+
+void MainWindow::onGrabBufferSettingsChanged()
+{
+    baslerCamera->setGrabBufferCount(grabBufferCountSpinBox->value());
+    baslerCamera->setGrabBufferHugePages(grabBufferHugePagesCheckBox->isChecked());
+    baslerCamera->setGrabBufferLockMemory(grabBufferLockMemoryCheckBox->isChecked());
+    updateStatus("Grab buffer settings apply the next time grabbing starts");
+}
+
+void MainWindow::onSetAcquisitionModeClicked()
+{
+    IFrameSource::GrabStrategy strategy =
+        static_cast<IFrameSource::GrabStrategy>(grabStrategyComboBox->currentData().toInt());
+    
+    if (!baslerCamera->setAcquisitionMode(strategy, grabQueueSizeSpinBox->value(), eventDrivenCheckBox->isChecked())) {
+        QMessageBox::warning(this, "Acquisition Error", "Failed to set acquisition mode!");
+    }
+}
+
+bool MainWindow::readThreadPolicy(QComboBox *scheduling, QSpinBox *priority, QLineEdit *cores,
+                                  ThreadPolicy::Config &config)
+{
+    config.scheduling = static_cast<ThreadPolicy::Scheduling>(scheduling->currentData().toInt());
+    config.priority = priority->value();
+    config.memoryNode = memoryNodeSpinBox->value();
+    return ThreadAffinity::parseCoreList(cores->text(), config.cores);
+}
+
+void MainWindow::onApplyThreadPolicyClicked()
+{
+    ThreadPolicy::Config grabPolicy;
+    ThreadPolicy::Config recorderPolicy;
+    if (!readThreadPolicy(grabSchedulingComboBox, grabPrioritySpinBox, grabCoresEdit, grabPolicy)
+        || !readThreadPolicy(recorderSchedulingComboBox, recorderPrioritySpinBox, recorderCoresEdit, recorderPolicy)) {
+        QMessageBox::warning(this, "Thread Policy Error", "Cores must be a list like 0-3,8!");
+        return;
+    }
+    
+    baslerCamera->setGrabThreadPolicy(grabPolicy);
+    baslerCamera->setRecorderThreadPolicy(recorderPolicy);
+    
+    // Additional cameras keep their round-robin cores when a first core is set
+    cameraManager->setThreadPolicy(grabPolicy);
+    cameraManager->setRecorderThreadPolicy(recorderPolicy);
+    
+    updateStatus("Thread policies apply the next time grabbing or recording starts");
+}
+
+void MainWindow::onMultiCameraOpenClicked()
+{
+    // Devices are opened exclusively, the single camera view would hold one of them
+    if (baslerCamera->isConnected()) {
+        QMessageBox::warning(this, "Multi-Camera", "Disconnect the camera above before opening all cameras!");
+        return;
+    }
+    
+    BaslerCamera::SourceType type =
+        static_cast<BaslerCamera::SourceType>(sourceTypeComboBox->currentData().toInt());
+    cameraManager->setFirstCore(multiCameraFirstCoreSpinBox->value());
+    
+    if (cameraManager->openAll(type, multiCameraCountSpinBox->value()) == 0) {
+        QMessageBox::warning(this, "Multi-Camera", "No camera could be opened!");
+    }
+    
+    bool opened = cameraManager->getCameraCount() > 0;
+    connectButton->setEnabled(!opened);
+    multiCameraOpenButton->setEnabled(!opened);
+    multiCameraGrabButton->setEnabled(opened);
+    multiCameraGrabButton->setText("Start All");
+    multiCameraCloseButton->setEnabled(opened);
+    onMultiCameraStatsUpdated();
+}
+
+void MainWindow::onMultiCameraGrabClicked()
+{
+    if (multiCameraGrabButton->text() == "Start All") {
+        cameraManager->startAll();
+        multiCameraGrabButton->setText("Stop All");
+    } else {
+        cameraManager->stopAll();
+        multiCameraGrabButton->setText("Start All");
+    }
+}
+
+void MainWindow::onMultiCameraCloseClicked()
+{
+    cameraManager->closeAll();
+    
+    connectButton->setEnabled(true);
+    multiCameraOpenButton->setEnabled(true);
+    multiCameraGrabButton->setEnabled(false);
+    multiCameraGrabButton->setText("Start All");
+    multiCameraCloseButton->setEnabled(false);
+    multiCameraStatsLabel->setText("No cameras open");
+}
+
+void MainWindow::onMultiCameraFirstCoreChanged(int core)
+{
+    cameraManager->setFirstCore(core);
+    if (cameraManager->getCameraCount() > 0) {
+        updateStatus("Core placement applies the next time grabbing starts");
+    }
+}
+
+void MainWindow::onMultiCameraStatsUpdated()
+{
+    if (cameraManager->getCameraCount() == 0) {
+        return;
+    }
+    multiCameraStatsLabel->setText(cameraManager->getSummary());
+}
+
+void MainWindow::onDisplayMappingChanged()
+{
+    bool fullRange = displayFullRangeCheckBox->isChecked();
+    displayWindowLowSpinBox->setEnabled(!fullRange);
+    displayWindowHighSpinBox->setEnabled(!fullRange);
+    
+    onPreviewSettingsChanged();
+}
+
+void MainWindow::onWhiteBalanceChanged()
+{
+    BayerDemosaic::WhiteBalance whiteBalance;
+    whiteBalance.red = whiteBalanceRedSpinBox->value();
+    whiteBalance.green = whiteBalanceGreenSpinBox->value();
+    whiteBalance.blue = whiteBalanceBlueSpinBox->value();
+    baslerCamera->setWhiteBalance(whiteBalance);
+    
+    onPreviewSettingsChanged();
+}
+
+void MainWindow::onPreviewSettingsChanged()
+{
+    // The worker renders the current frame again with the new settings
+    PreviewRenderer::Settings settings;
+    settings.quality = static_cast<PreviewRenderer::Quality>(previewQualityComboBox->currentData().toInt());
+    settings.fullRange = displayFullRangeCheckBox->isChecked();
+    settings.windowLow = displayWindowLowSpinBox->value();
+    settings.windowHigh = displayWindowHighSpinBox->value();
+    settings.gamma = displayGammaSpinBox->value();
+    settings.whiteBalance.red = whiteBalanceRedSpinBox->value();
+    settings.whiteBalance.green = whiteBalanceGreenSpinBox->value();
+    settings.whiteBalance.blue = whiteBalanceBlueSpinBox->value();
+    settings.bayerFullResolution = bayerFullResolutionCheckBox->isChecked();
+    previewRenderer->setSettings(settings);
+}
+
+void MainWindow::updateLatencyDisplay()
+{
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5").arg("stage (us)", -13).arg("n", 8).arg("p50", 9).arg("p99", 9).arg("p99.9", 9);
+    
+    for (int i = 0; i < BaslerCamera::LATENCY_STAGE_COUNT; ++i) {
+        BaslerCamera::LatencyStage stage = static_cast<BaslerCamera::LatencyStage>(i);
+        lines << QString("%1 %2 %3 %4 %5")
+                 .arg(BaslerCamera::getLatencyStageName(stage), -13)
+                 .arg(baslerCamera->getLatencySampleCount(stage), 8)
+                 .arg(baslerCamera->getLatencyPercentile(stage, 50.0), 9, 'f', 1)
+                 .arg(baslerCamera->getLatencyPercentile(stage, 99.0), 9, 'f', 1)
+                 .arg(baslerCamera->getLatencyPercentile(stage, 99.9), 9, 'f', 1);
+    }
+    
+    lines << QString("display @ %1 Hz: rendered %2, coalesced %3, skipped %4")
+             .arg(displayScheduler->getRefreshRate(), 0, 'f', 0)
+             .arg(displayScheduler->getRenderedCount())
+             .arg(displayScheduler->getCoalescedCount())
+             .arg(displayScheduler->getSkippedCount());
+    
+    latencyLabel->setText(lines.join("\n"));
+}
+
+void MainWindow::onDumpFrameTimingClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Dump Frame Timing",
+                                                    "frame_timing.csv", "CSV files (*.csv)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    if (baslerCamera->dumpFrameTiming(fileName)) {
+        updateStatus(QString("Frame timing written to: %1").arg(fileName));
+    } else {
+        QMessageBox::warning(this, "Frame Timing Dump Error", "Failed to write frame timing!");
+    }
+}
+
+void MainWindow::onDumpLatencyClicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Dump Latency Statistics",
+                                                    "latency_stats.txt", "Text files (*.txt)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    if (baslerCamera->dumpLatencyStats(fileName)) {
+        updateStatus(QString("Latency statistics written to: %1").arg(fileName));
+    } else {
+        QMessageBox::warning(this, "Latency Dump Error", "Failed to write latency statistics!");
+    }
+}
+
+void MainWindow::onResetLatencyClicked()
+{
+    baslerCamera->resetLatencyStats();
+    displayScheduler->resetCounters();
+    lastPaintedFrameId = -1;
+    updateLatencyDisplay();
 }
 
 void MainWindow::onFrameIdUpdated(int frameId)
@@ -954,50 +1915,23 @@ void MainWindow::updateRealTimeFrameRateDisplay()
 // Trigger control slots
 void MainWindow::onTriggerEnabledChanged(bool checked)
 {
-    if (baslerCamera->setTriggerEnabled(checked)) {
-        updateCameraSettings();
-        updateTriggerControls();
-    } else {
-        QMessageBox::warning(this, "Trigger Enable Error", "Failed to set trigger enable!");
-        // Revert checkbox state
-        triggerEnabledCheckBox->setChecked(!checked);
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::TriggerMode, QString(checked ? "On" : "Off"));
 }
 
 void MainWindow::onTriggerModeChanged(const QString &text)
 {
-    if (baslerCamera->setTriggerMode(text)) {
-        updateCameraSettings();
-        updateTriggerControls();
-    } else {
-        QMessageBox::warning(this, "Trigger Mode Error", "Failed to set trigger mode!");
-        // Revert combo box selection
-        triggerModeComboBox->setCurrentText(baslerCamera->getTriggerMode());
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::TriggerMode, text);
 }
 
 void MainWindow::onTriggerSourceChanged(const QString &text)
 {
-    if (baslerCamera->setTriggerSource(text)) {
-        updateCameraSettings();
-        updateTriggerControls();
-    } else {
-        QMessageBox::warning(this, "Trigger Source Error", "Failed to set trigger source!");
-        // Revert combo box selection
-        triggerSourceComboBox->setCurrentText(baslerCamera->getTriggerSource());
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::TriggerSource, text);
 }
 
 void MainWindow::onSetTriggerDelayClicked()
 {
     double delay = triggerDelaySpinBox->value();
-    
-    if (baslerCamera->setTriggerDelay(delay)) {
-        updateCameraSettings();
-        updateTriggerControls();
-    } else {
-        QMessageBox::warning(this, "Trigger Delay Error", "Failed to set trigger delay!");
-    }
+    baslerCamera->setParameterAsync(CameraParameterModel::TriggerDelay, delay);
 }
 
 void MainWindow::onTriggerDelaySliderChanged(int value)
@@ -1005,6 +1939,67 @@ void MainWindow::onTriggerDelaySliderChanged(int value)
     double delay = static_cast<double>(value);
     triggerDelaySpinBox->setValue(delay);
     triggerDelayLabel->setText(QString("Current: %1 μs").arg(delay, 0, 'f', 0));
+    
+    if (baslerCamera->getParameterModel()->isAttached()) {
+        baslerCamera->setParameterAsync(CameraParameterModel::TriggerDelay, delay);
+    }
+}
+
+void MainWindow::onParameterWriteFinished(const QString &name, bool success, const QString &error)
+{
+    typedef CameraParameterModel Model;
+    
+    // Writes dropped by a disconnect need no attention
+    if (!success && error != "Cancelled") {
+        QMessageBox::warning(this, "Camera Parameter Error", QString("Failed to set %1: %2").arg(name, error));
+    }
+    if (!baslerCamera->isConnected()) {
+        return;
+    }
+    
+    // Show what the camera has now, this also reverts controls after a failed write
+    updateCameraSettings();
+    if (name == "Configuration") {
+        profileResultLabel->setText(CameraConfiguration::describe(baslerCamera->getLastConfigurationResult()));
+        updateResolutionControls();
+        updatePixelFormatControls();
+        updateScalingControls();
+        updateExposureControls();
+        updateFrameRateControls();
+        updateTriggerControls();
+    } else if (name == "Resolution" || name == Model::parameterName(Model::PixelFormat)) {
+        updateResolutionControls();
+        updatePixelFormatControls();
+    } else if (name == Model::parameterName(Model::ScalingFactor)) {
+        updateScalingControls();
+    } else if (name == Model::parameterName(Model::ExposureTime) || name == Model::parameterName(Model::ExposureAuto)) {
+        updateExposureControls();
+    } else if (name == Model::parameterName(Model::AcquisitionFrameRate) || name == Model::parameterName(Model::AcquisitionFrameRateEnable)) {
+        updateFrameRateControls();
+    } else {
+        updateTriggerControls();
+    }
+}
+
+void MainWindow::onLoadProfileClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Load Camera Profile", QString(),
+                                                    "Camera profiles (*.json *.pfs);;All files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    CameraConfiguration configuration;
+    QString error;
+    if (!configuration.load(fileName, error)) {
+        QMessageBox::warning(this, "Camera Profile Error", error);
+        return;
+    }
+    
+    // Applied on the camera-control thread, the result arrives in onParameterWriteFinished()
+    profileResultLabel->setText(QString("Applying %1 (%2 parameters, %3 features)...")
+                                .arg(fileName).arg(configuration.changes().size()).arg(configuration.features().size()));
+    baslerCamera->applyConfigurationAsync(configuration);
 }
 
 void MainWindow::updateTriggerControls()
@@ -1013,11 +2008,19 @@ void MainWindow::updateTriggerControls()
         return;
     }
     
+    // Showing the camera's values must not write them back, nor move the slider under the user
+    QSignalBlocker sliderBlocker(triggerDelaySlider);
+    QSignalBlocker enabledBlocker(triggerEnabledCheckBox);
+    QSignalBlocker modeBlocker(triggerModeComboBox);
+    QSignalBlocker sourceBlocker(triggerSourceComboBox);
+    
     // Update spin box with current value
     triggerDelaySpinBox->setValue(baslerCamera->getTriggerDelay());
     
     // Update slider with current value
-    triggerDelaySlider->setValue(static_cast<int>(baslerCamera->getTriggerDelay()));
+    if (!triggerDelaySlider->isSliderDown()) {
+        triggerDelaySlider->setValue(static_cast<int>(baslerCamera->getTriggerDelay()));
+    }
     
     // Update label
     triggerDelayLabel->setText(QString("Current: %1 μs").arg(baslerCamera->getTriggerDelay(), 0, 'f', 0));
@@ -1109,6 +2112,19 @@ void MainWindow::updateRecordingControls()
     // Update max recorded images
     maxRecordedImagesSpinBox->setValue(baslerCamera->getMaxRecordedImages());
     
+    // Update recorder queue settings
+    recordingOverflowComboBox->setCurrentIndex(
+        recordingOverflowComboBox->findData(baslerCamera->getRecordingOverflowPolicy()));
+    recordingWriterThreadsSpinBox->setValue(baslerCamera->getRecordingWriterThreads());
+    recordingFormatComboBox->setCurrentIndex(
+        recordingFormatComboBox->findData(baslerCamera->getRecordingFormat()));
+    recordingSegmentFramesSpinBox->setValue(baslerCamera->getRecordingVideoSegmentFrames());
+    
+    // Writer threads, format and segment length only change when recording starts
+    recordingWriterThreadsSpinBox->setEnabled(!isRecording);
+    recordingFormatComboBox->setEnabled(!isRecording);
+    recordingSegmentFramesSpinBox->setEnabled(!isRecording);
+    
     // Enable reset button only if there are recorded images
     resetRecordingCountButton->setEnabled(recordedCount > 0);
 }
@@ -1137,6 +2153,182 @@ void MainWindow::onSetMaxRecordedImagesClicked()
     }
 }
 
+void MainWindow::onRecordingOverflowPolicyChanged(int index)
+{
+    QVariant policy = recordingOverflowComboBox->itemData(index);
+    if (policy.isValid()) {
+        baslerCamera->setRecordingOverflowPolicy(static_cast<FrameRecorder::OverflowPolicy>(policy.toInt()));
+    }
+}
+
+void MainWindow::onRecordingWriterThreadsChanged(int count)
+{
+    baslerCamera->setRecordingWriterThreads(count);
+}
+
+void MainWindow::onRecordingFormatChanged(int index)
+{
+    QVariant format = recordingFormatComboBox->itemData(index);
+    if (format.isValid()) {
+        baslerCamera->setRecordingFormat(static_cast<FrameRecorder::RecordingFormat>(format.toInt()));
+    }
+}
+
+void MainWindow::onRecordingSegmentFramesChanged(int frames)
+{
+    baslerCamera->setRecordingVideoSegmentFrames(frames);
+}
+
+void MainWindow::onRecordingStatsUpdated(quint64 queued, quint64 written, quint64 dropped)
+{
+    QString stats = QString("Queued: %1 / Written: %2 / Dropped: %3").arg(queued).arg(written).arg(dropped);
+    if (baslerCamera->getRecordingFormat() == FrameRecorder::FormatRawSequence) {
+        stats += QString("\n%1").arg(baslerCamera->getRecordingSequenceInfo());
+    } else if (FrameRecorder::isCompressedFormat(baslerCamera->getRecordingFormat())) {
+        stats += QString("\n%1").arg(baslerCamera->getRecordingCompressionInfo());
+    } else if (FrameRecorder::isVideoFormat(baslerCamera->getRecordingFormat())) {
+        stats += QString("\n%1").arg(baslerCamera->getRecordingVideoInfo());
+    }
+    recordingStatsLabel->setText(stats);
+    recordedImageCountLabel->setText(QString("Saved Images: %1").arg(baslerCamera->getRecordedImageCount()));
+}
+
+void MainWindow::onApplyPreTriggerClicked()
+{
+    PreTriggerBuffer::Config config;
+    config.preTriggerFrames = preTriggerFramesSpinBox->value();
+    config.postTriggerFrames = postTriggerFramesSpinBox->value();
+    config.maxBytes = static_cast<qint64>(preTriggerMemorySpinBox->value()) * 1024 * 1024;
+    config.path = preTriggerPathEdit->text().trimmed();
+    config.triggerOnSoftwareTrigger = preTriggerOnSoftwareTriggerCheckBox->isChecked();
+    
+    if (config.path.isEmpty()) {
+        QMessageBox::warning(this, "Path Error", "Please enter a valid path!");
+        return;
+    }
+    
+    baslerCamera->setPreTriggerConfig(config);
+    baslerCamera->setPreTriggerEnabled(preTriggerEnableCheckBox->isChecked());
+    updatePreTriggerDisplay();
+}
+
+void MainWindow::onPreTriggerNowClicked()
+{
+    if (!baslerCamera->triggerPreTrigger("Manual")) {
+        updateStatus("Pre-trigger dump not started: buffer disabled or a dump is still running");
+    }
+    updatePreTriggerDisplay();
+}
+
+void MainWindow::onPreTriggerDumpFinished(const QString &filePath, int frames, bool success, const QString &message)
+{
+    if (success) {
+        updateStatus(QString("Pre-trigger dump saved: %1 (%2)").arg(filePath, message));
+    } else {
+        updateStatus(QString("Pre-trigger dump of %1 frames failed: %2").arg(frames).arg(message));
+    }
+    updatePreTriggerDisplay();
+}
+
+void MainWindow::updatePreTriggerDisplay()
+{
+    PreTriggerBuffer::Stats stats = baslerCamera->getPreTriggerStats();
+    preTriggerNowButton->setEnabled(stats.enabled && !stats.busy);
+    
+    if (!stats.enabled && stats.triggers == 0) {
+        preTriggerStatsLabel->setText("Disabled");
+        return;
+    }
+    
+    QString text = QString("Buffered: %1 / %2 frames, %3 MB%4\n"
+                           "Dumps: %5 (%6 failed), triggers ignored: %7")
+                   .arg(stats.bufferedFrames)
+                   .arg(stats.depthFrames)
+                   .arg(stats.memoryBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                   .arg(stats.busy ? ", dumping" : "")
+                   .arg(stats.dumpsCompleted)
+                   .arg(stats.dumpsFailed)
+                   .arg(stats.triggersIgnored);
+    if (stats.dumpsCompleted + stats.dumpsFailed > 0) {
+        text += QString("\nLast: %1 frames at %2 MB/s")
+                .arg(stats.lastDumpFrames)
+                .arg(stats.lastDumpMBps, 0, 'f', 1);
+    }
+    preTriggerStatsLabel->setText(text);
+}
+
+void MainWindow::onSourceTypeChanged(int index)
+{
+    QVariant type = sourceTypeComboBox->itemData(index);
+    if (!type.isValid()) {
+        return;
+    }
+    
+    BaslerCamera::SourceType sourceType = static_cast<BaslerCamera::SourceType>(type.toInt());
+    baslerCamera->setSourceType(sourceType);
+    
+    // The IP address only matters for the GigE camera
+    ipAddressEdit->setEnabled(sourceType == BaslerCamera::SourceGigE);
+    setIPButton->setEnabled(sourceType == BaslerCamera::SourceGigE);
+    syntheticPixelFormatComboBox->setEnabled(sourceType == BaslerCamera::SourceSynthetic);
+    playbackPathEdit->setEnabled(sourceType == BaslerCamera::SourcePlayback);
+    playbackFileButton->setEnabled(sourceType == BaslerCamera::SourcePlayback);
+    playbackFolderButton->setEnabled(sourceType == BaslerCamera::SourcePlayback);
+    
+    updateStatus(QString("Frame source set to: %1").arg(sourceTypeComboBox->itemText(index)));
+}
+
+void MainWindow::onSyntheticPixelFormatChanged(int index)
+{
+    QVariant pixelType = syntheticPixelFormatComboBox->itemData(index);
+    if (pixelType.isValid()) {
+        baslerCamera->setSyntheticPixelType(static_cast<EPixelType>(pixelType.toInt()));
+    }
+}
+
+void MainWindow::onPlaybackBrowseFileClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Open Raw Sequence", playbackPathEdit->text(),
+                                                    "Raw sequences (*.bseq);;All files (*)");
+    if (!fileName.isEmpty()) {
+        playbackPathEdit->setText(fileName);
+        baslerCamera->setPlaybackPath(fileName);
+    }
+}
+
+void MainWindow::onPlaybackBrowseFolderClicked()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "Open Image Directory", playbackPathEdit->text());
+    if (!directory.isEmpty()) {
+        playbackPathEdit->setText(directory);
+        baslerCamera->setPlaybackPath(directory);
+    }
+}
+
+void MainWindow::onPlaybackPacingChanged(int index)
+{
+    QVariant pacing = playbackPacingComboBox->itemData(index);
+    if (pacing.isValid()) {
+        baslerCamera->setPlaybackPacing(static_cast<PlaybackFrameSource::Pacing>(pacing.toInt()));
+    }
+}
+
+void MainWindow::onPlaybackLoopChanged(bool loop)
+{
+    baslerCamera->setPlaybackLoop(loop);
+}
+
+void MainWindow::onPlaybackSeekClicked()
+{
+    baslerCamera->seekPlayback(playbackSeekSpinBox->value());
+    updatePlaybackDisplay();
+}
+
+void MainWindow::updatePlaybackDisplay()
+{
+    playbackPositionLabel->setText(baslerCamera->getPlaybackInfo());
+}
+
 void MainWindow::onSetIPClicked()
 {
     QString ipAddress = ipAddressEdit->text().trimmed();
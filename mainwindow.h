@@ -15,6 +15,9 @@
 #include <QSlider>
 #include <QCheckBox>
 #include "basler_camera.h"
+#include "preview_renderer.h"
+#include "display_scheduler.h"
+#include "camera_manager.h"
 #include <QLineEdit>
 
 class MainWindow : public QMainWindow
@@ -25,12 +28,19 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    // Pause the display scheduler while the window cannot be seen
+    void changeEvent(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void onConnectClicked();
     void onDisconnectClicked();
     void onGrabClicked();
     void onSetResolutionClicked();
     void onResolutionComboChanged(const QString &text);
+    void onSetPixelFormatClicked();
     void onSetScalingFactorClicked();
     void onScalingFactorSliderChanged(int value);
     void onSetExposureTimeClicked();
@@ -48,16 +58,48 @@ private slots:
     void onSetTriggerDelayClicked();
     void onTriggerDelaySliderChanged(int value);
     void onSoftwareTriggerClicked();
+    void onParameterWriteFinished(const QString &name, bool success, const QString &error);
+    void onLoadProfileClicked();
     void onRecordingToggleClicked();
     void onResetRecordingCountClicked();
     void onSetRecordingPathClicked();
     void onSetMaxRecordedImagesClicked();
+    void onRecordingOverflowPolicyChanged(int index);
+    void onRecordingWriterThreadsChanged(int count);
+    void onRecordingFormatChanged(int index);
+    void onRecordingSegmentFramesChanged(int frames);
+    void onRecordingStatsUpdated(quint64 queued, quint64 written, quint64 dropped);
+    void onApplyPreTriggerClicked();
+    void onPreTriggerNowClicked();
+    void onPreTriggerDumpFinished(const QString &filePath, int frames, bool success, const QString &message);
     void onSetIPClicked();
-    void updateImage();
+    void onSourceTypeChanged(int index);
+    void onDumpLatencyClicked();
+    void onDumpFrameTimingClicked();
+    void onGrabBufferSettingsChanged();
+    void onSetAcquisitionModeClicked();
+    void onApplyThreadPolicyClicked();
+    void onMultiCameraOpenClicked();
+    void onMultiCameraGrabClicked();
+    void onMultiCameraCloseClicked();
+    void onMultiCameraFirstCoreChanged(int core);
+    void onMultiCameraStatsUpdated();
+    void onResetLatencyClicked();
+    void onSyntheticPixelFormatChanged(int index);
+    void onPlaybackBrowseFileClicked();
+    void onPlaybackBrowseFolderClicked();
+    void onPlaybackPacingChanged(int index);
+    void onPlaybackLoopChanged(bool loop);
+    void onPlaybackSeekClicked();
+    void onDisplayMappingChanged();
+    void onWhiteBalanceChanged();
+    void onPreviewSettingsChanged();
+    void onPreviewReady(const QImage &image, qint64 frameId, qint64 timestampNs, qint64 convertNs);
+    void updateImage(const FrameHandle &frame);
 
 private:
     BaslerCamera *baslerCamera;
-    QTimer *updateTimer;
+    DisplayScheduler *displayScheduler;
     
     // UI elements
     QLabel *imageLabel;
@@ -72,12 +114,35 @@ private:
     QLineEdit *ipAddressEdit;
     QPushButton *setIPButton;
     
+    // Frame source control
+    QComboBox *sourceTypeComboBox;
+    QComboBox *syntheticPixelFormatComboBox;
+    
+    // Playback of recorded sequences and BMP directories
+    QLineEdit *playbackPathEdit;
+    QPushButton *playbackFileButton;
+    QPushButton *playbackFolderButton;
+    QComboBox *playbackPacingComboBox;
+    QCheckBox *playbackLoopCheckBox;
+    QSpinBox *playbackSeekSpinBox;
+    QPushButton *playbackSeekButton;
+    QLabel *playbackPositionLabel;
+    
+    // Configuration profiles (JSON / .pfs) applied as one transaction
+    QPushButton *loadProfileButton;
+    QLabel *profileResultLabel;
+    
     // Resolution control
     QSpinBox *widthSpinBox;
     QSpinBox *heightSpinBox;
     QPushButton *setResolutionButton;
     QComboBox *resolutionComboBox;
     
+    // Pixel format control
+    QComboBox *pixelFormatComboBox;
+    QPushButton *setPixelFormatButton;
+    QLabel *bandwidthLabel;
+    
     // Scaling control
     QDoubleSpinBox *scalingFactorSpinBox;
     QSlider *scalingFactorSlider;
@@ -117,23 +182,104 @@ private:
     QPushButton *setRecordingPathButton;
     QSpinBox *maxRecordedImagesSpinBox;
     QPushButton *setMaxRecordedImagesButton;
+    QComboBox *recordingOverflowComboBox;
+    QSpinBox *recordingWriterThreadsSpinBox;
+    QComboBox *recordingFormatComboBox;
+    QSpinBox *recordingSegmentFramesSpinBox;
+    QLabel *recordingStatsLabel;
+    
+    // Pre-trigger ring
+    QCheckBox *preTriggerEnableCheckBox;
+    QSpinBox *preTriggerFramesSpinBox;
+    QSpinBox *postTriggerFramesSpinBox;
+    QSpinBox *preTriggerMemorySpinBox;
+    QLineEdit *preTriggerPathEdit;
+    QCheckBox *preTriggerOnSoftwareTriggerCheckBox;
+    QPushButton *applyPreTriggerButton;
+    QPushButton *preTriggerNowButton;
+    QLabel *preTriggerStatsLabel;
     
     // Real-time frame rate display
     QLabel *realTimeFrameRateLabel;
     QLabel *frameCountLabel;
     QLabel *frameIdLabel;
     QLabel *errorsCountLabel;
+    QLabel *overwrittenFramesLabel;
+    QLabel *frameIntervalLabel;
+    QLabel *sensorTimingLabel;
+    QPushButton *dumpFrameTimingButton;
+    
+    // Grab buffer pool control
+    QSpinBox *grabBufferCountSpinBox;
+    QCheckBox *grabBufferHugePagesCheckBox;
+    QCheckBox *grabBufferLockMemoryCheckBox;
+    QLabel *grabBufferInfoLabel;
+    
+    // Grab strategy and event-driven acquisition
+    QComboBox *grabStrategyComboBox;
+    QSpinBox *grabQueueSizeSpinBox;
+    QCheckBox *eventDrivenCheckBox;
+    QPushButton *setAcquisitionModeButton;
+    QLabel *skippedFramesLabel;
+    
+    // Per-stage latency display
+    QLabel *latencyLabel;
+    QPushButton *dumpLatencyButton;
+    QPushButton *resetLatencyButton;
+    int64_t lastPaintedFrameId;
+    
+    // Window/level for Mono10/12/16 display
+    QCheckBox *displayFullRangeCheckBox;
+    QSpinBox *displayWindowLowSpinBox;
+    QSpinBox *displayWindowHighSpinBox;
+    QDoubleSpinBox *displayGammaSpinBox;
+    
+    // Display-sized preview images are rendered off the GUI thread
+    PreviewRenderer *previewRenderer;
+    QComboBox *previewQualityComboBox;
+    
+    // Demosaic gains and preview mode for Bayer formats
+    QDoubleSpinBox *whiteBalanceRedSpinBox;
+    QDoubleSpinBox *whiteBalanceGreenSpinBox;
+    QDoubleSpinBox *whiteBalanceBlueSpinBox;
+    QCheckBox *bayerFullResolutionCheckBox;
+    
+    // Real-time scheduling and placement of the grab and recorder threads
+    QComboBox *grabSchedulingComboBox;
+    QSpinBox *grabPrioritySpinBox;
+    QLineEdit *grabCoresEdit;
+    QComboBox *recorderSchedulingComboBox;
+    QSpinBox *recorderPrioritySpinBox;
+    QLineEdit *recorderCoresEdit;
+    QSpinBox *memoryNodeSpinBox;
+    QPushButton *applyThreadPolicyButton;
+    QLabel *threadPolicyLabel;
+    
+    // Further cameras, each with its own pipeline and pinned grab thread
+    CameraManager *cameraManager;
+    QSpinBox *multiCameraCountSpinBox;
+    QSpinBox *multiCameraFirstCoreSpinBox;
+    QPushButton *multiCameraOpenButton;
+    QPushButton *multiCameraGrabButton;
+    QPushButton *multiCameraCloseButton;
+    QLabel *multiCameraStatsLabel;
     
     void setupUI();
+    bool readThreadPolicy(QComboBox *scheduling, QSpinBox *priority, QLineEdit *cores, ThreadPolicy::Config &config);
     void updateStatus(const QString &status);
     void updateCameraInfo();
     void updateCameraSettings();
     void updateResolutionControls();
+    void updatePixelFormatControls();
     void updateScalingControls();
+    void updateDisplayActive();
     void updateExposureControls();
     void updateFrameRateControls();
     void updateTriggerControls();
     void updateRecordingControls();
+    void updatePreTriggerDisplay();
+    void updatePlaybackDisplay();
+    void updateLatencyDisplay();
     void updateRealTimeFrameRateDisplay();
 };
 
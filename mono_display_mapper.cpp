@@ -0,0 +1,257 @@
+#include "mono_display_mapper.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MONO_DISPLAY_X86 1
+#endif
+
+MonoDisplayMapper::MonoDisplayMapper()
+    : m_bits(0)
+    , m_low(0)
+    , m_high(0)
+    , m_gamma(1.0)
+    , m_scale(0)
+{
+    configure(16);
+}
+
+void MonoDisplayMapper::configure(int bits)
+{
+    bits = std::min(16, std::max(8, bits));
+    configure(bits, 0, (1 << bits) - 1, 1.0);
+}
+
+void MonoDisplayMapper::configure(int bits, int low, int high, double gamma)
+{
+    bits = std::min(16, std::max(8, bits));
+    const int maxValue = (1 << bits) - 1;
+
+    low = std::min(maxValue - 1, std::max(0, low));
+    high = std::min(maxValue, std::max(low + 1, high));
+    if (!(gamma > 0.0)) {
+        gamma = 1.0;
+    }
+
+    // Reconfiguring per frame is cheap when nothing changed
+    if (bits == m_bits && low == m_low && high == m_high && gamma == m_gamma) {
+        return;
+    }
+
+    m_bits = bits;
+    m_low = low;
+    m_high = high;
+    m_gamma = gamma;
+
+    const uint32_t range = static_cast<uint32_t>(high - low);
+    m_scale = ((255u << 16) + range / 2) / range;
+
+    m_lut.clear();
+    if (std::fabs(gamma - 1.0) > 1e-9) {
+        m_lut.resize(static_cast<size_t>(maxValue) + 1);
+        for (int v = 0; v <= maxValue; ++v) {
+            double x = static_cast<double>(std::min(std::max(v - low, 0), high - low)) / range;
+            m_lut[v] = static_cast<uint8_t>(std::lround(255.0 * std::pow(x, 1.0 / gamma)));
+        }
+    }
+}
+
+void MonoDisplayMapper::map(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int width, int height) const
+{
+    static const SimdLevel level = detectSimdLevel();
+    map(src, srcStride, dst, dstStride, width, height, level);
+}
+
+void MonoDisplayMapper::map(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int width, int height, SimdLevel level) const
+{
+    if (!m_lut.empty()) {
+        lutScalar(src, srcStride, dst, dstStride, width, height,
+                  m_lut.data(), static_cast<uint16_t>(m_lut.size() - 1));
+        return;
+    }
+
+    const uint16_t low = static_cast<uint16_t>(m_low);
+    const uint16_t range = static_cast<uint16_t>(m_high - m_low);
+
+    switch (level) {
+        case SimdAvx2:
+            windowAvx2(src, srcStride, dst, dstStride, width, height, low, range, m_scale);
+            break;
+        case SimdSse41:
+            windowSse41(src, srcStride, dst, dstStride, width, height, low, range, m_scale);
+            break;
+        case SimdScalar:
+        default:
+            windowScalar(src, srcStride, dst, dstStride, width, height, low, range, m_scale);
+            break;
+    }
+}
+
+MonoDisplayMapper::SimdLevel MonoDisplayMapper::detectSimdLevel()
+{
+#ifdef MONO_DISPLAY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdAvx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SimdSse41;
+    }
+#endif
+    return SimdScalar;
+}
+
+const char* MonoDisplayMapper::simdLevelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdAvx2:  return "AVX2";
+        case SimdSse41: return "SSE4.1";
+        default:        return "scalar";
+    }
+}
+
+static inline const uint16_t* srcRow(const uint16_t* src, size_t stride, int y)
+{
+    return reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(src) + stride * y);
+}
+
+static inline uint8_t windowPixel(uint16_t v, uint16_t low, uint16_t range, uint32_t k)
+{
+    uint32_t d = v > low ? static_cast<uint32_t>(v - low) : 0u;
+    d = std::min<uint32_t>(d, range);
+    return static_cast<uint8_t>((d * k + 0x8000u) >> 16);
+}
+
+void MonoDisplayMapper::windowScalar(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                     int width, int height, uint16_t low, uint16_t range, uint32_t k)
+{
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* in = srcRow(src, srcStride, y);
+        uint8_t* out = dst + dstStride * y;
+        for (int x = 0; x < width; ++x) {
+            out[x] = windowPixel(in[x], low, range, k);
+        }
+    }
+}
+
+#ifdef MONO_DISPLAY_X86
+
+__attribute__((target("sse4.1")))
+static inline __m128i windowSse41x8(__m128i v, __m128i low, __m128i range, __m128i k, __m128i round)
+{
+    __m128i d = _mm_min_epu16(_mm_subs_epu16(v, low), range);
+    __m128i lo = _mm_cvtepu16_epi32(d);
+    __m128i hi = _mm_unpackhi_epi16(d, _mm_setzero_si128());
+    lo = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(lo, k), round), 16);
+    hi = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(hi, k), round), 16);
+    return _mm_packus_epi32(lo, hi);
+}
+
+__attribute__((target("sse4.1")))
+void MonoDisplayMapper::windowSse41(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                    int width, int height, uint16_t low, uint16_t range, uint32_t k)
+{
+    const __m128i vLow = _mm_set1_epi16(static_cast<short>(low));
+    const __m128i vRange = _mm_set1_epi16(static_cast<short>(range));
+    const __m128i vK = _mm_set1_epi32(static_cast<int>(k));
+    const __m128i vRound = _mm_set1_epi32(0x8000);
+
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* in = srcRow(src, srcStride, y);
+        uint8_t* out = dst + dstStride * y;
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            __m128i a = windowSse41x8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x)),
+                                      vLow, vRange, vK, vRound);
+            __m128i b = windowSse41x8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + x + 8)),
+                                      vLow, vRange, vK, vRound);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(a, b));
+        }
+        for (; x < width; ++x) {
+            out[x] = windowPixel(in[x], low, range, k);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i windowAvx2x16(__m256i v, __m256i low, __m256i range, __m256i k, __m256i round)
+{
+    __m256i d = _mm256_min_epu16(_mm256_subs_epu16(v, low), range);
+    __m256i lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(d));
+    __m256i hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(d, 1));
+    lo = _mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(lo, k), round), 16);
+    hi = _mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(hi, k), round), 16);
+
+    // packus works per 128-bit lane, restore pixel order afterwards
+    return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+}
+
+__attribute__((target("avx2")))
+void MonoDisplayMapper::windowAvx2(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                   int width, int height, uint16_t low, uint16_t range, uint32_t k)
+{
+    const __m256i vLow = _mm256_set1_epi16(static_cast<short>(low));
+    const __m256i vRange = _mm256_set1_epi16(static_cast<short>(range));
+    const __m256i vK = _mm256_set1_epi32(static_cast<int>(k));
+    const __m256i vRound = _mm256_set1_epi32(0x8000);
+
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* in = srcRow(src, srcStride, y);
+        uint8_t* out = dst + dstStride * y;
+
+        int x = 0;
+        for (; x + 32 <= width; x += 32) {
+            __m256i a = windowAvx2x16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + x)),
+                                      vLow, vRange, vK, vRound);
+            __m256i b = windowAvx2x16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + x + 16)),
+                                      vLow, vRange, vK, vRound);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), packed);
+        }
+        for (; x < width; ++x) {
+            out[x] = windowPixel(in[x], low, range, k);
+        }
+    }
+}
+
+#else
+
+// No x86 SIMD on this target, fall back to the scalar loop
+void MonoDisplayMapper::windowSse41(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                    int width, int height, uint16_t low, uint16_t range, uint32_t k)
+{
+    windowScalar(src, srcStride, dst, dstStride, width, height, low, range, k);
+}
+
+void MonoDisplayMapper::windowAvx2(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                   int width, int height, uint16_t low, uint16_t range, uint32_t k)
+{
+    windowScalar(src, srcStride, dst, dstStride, width, height, low, range, k);
+}
+
+#endif
+
+void MonoDisplayMapper::lutScalar(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                                  int width, int height, const uint8_t* lut, uint16_t maxValue)
+{
+    for (int y = 0; y < height; ++y) {
+        const uint16_t* in = srcRow(src, srcStride, y);
+        uint8_t* out = dst + dstStride * y;
+
+        // Unused high bits in the container must not index past the table
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            out[x] = lut[std::min(in[x], maxValue)];
+            out[x + 1] = lut[std::min(in[x + 1], maxValue)];
+            out[x + 2] = lut[std::min(in[x + 2], maxValue)];
+            out[x + 3] = lut[std::min(in[x + 3], maxValue)];
+        }
+        for (; x < width; ++x) {
+            out[x] = lut[std::min(in[x], maxValue)];
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef MONO_DISPLAY_MAPPER_H
+#define MONO_DISPLAY_MAPPER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Maps 10..16-bit mono pixels (one per uint16_t) to 8-bit display values.
+//
+// The window [low, high] in raw sensor units is stretched to 0..255, values
+// outside it clip. With gamma == 1 the mapping is the linear window/level
+//     out = (min(max(v - low, 0), high - low) * k + 0x8000) >> 16
+// with k = round(255 * 65536 / (high - low)), evaluated by SSE4.1 or AVX2
+// kernels when the CPU has them, by a scalar loop otherwise. All three give
+// bit-identical results. Any other gamma goes through a 2^bits entry LUT.
+//
+// Not thread-safe: configure() and map() must not run concurrently, keep one
+// mapper per consumer thread.
+class MonoDisplayMapper
+{
+public:
+    enum SimdLevel {
+        SimdScalar,
+        SimdSse41,
+        SimdAvx2
+    };
+
+    MonoDisplayMapper();
+
+    // Full range of the given bit depth, linear
+    void configure(int bits);
+    void configure(int bits, int low, int high, double gamma);
+
+    int bits() const { return m_bits; }
+    int low() const { return m_low; }
+    int high() const { return m_high; }
+    double gamma() const { return m_gamma; }
+    bool isLinear() const { return m_lut.empty(); }
+
+    // Strides are in bytes
+    void map(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+             int width, int height) const;
+    void map(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+             int width, int height, SimdLevel level) const;
+
+    // Best kernel this CPU supports
+    static SimdLevel detectSimdLevel();
+    static const char* simdLevelName(SimdLevel level);
+
+    // Kernels, exposed for the benchmark
+    static void windowScalar(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                             int width, int height, uint16_t low, uint16_t range, uint32_t k);
+    static void windowSse41(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                            int width, int height, uint16_t low, uint16_t range, uint32_t k);
+    static void windowAvx2(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                           int width, int height, uint16_t low, uint16_t range, uint32_t k);
+    static void lutScalar(const uint16_t* src, size_t srcStride, uint8_t* dst, size_t dstStride,
+                          int width, int height, const uint8_t* lut, uint16_t maxValue);
+
+private:
+    int m_bits;
+    int m_low;
+    int m_high;
+    double m_gamma;
+    uint32_t m_scale;          // k of the linear mapping
+    std::vector<uint8_t> m_lut; // Only used when gamma != 1
+};
+
+#endif // MONO_DISPLAY_MAPPER_H
@@ -0,0 +1,217 @@
+#include "packed_mono_unpacker.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PACKED_MONO_X86 1
+#endif
+
+int PackedMonoUnpacker::bitDepth(Layout layout)
+{
+    return (layout == Mono10p || layout == Mono10packed) ? 10 : 12;
+}
+
+size_t PackedMonoUnpacker::rowBytes(Layout layout, int width)
+{
+    switch (layout) {
+        case Mono10p:
+            return (static_cast<size_t>(width) * 10 + 7) / 8;
+        case Mono12p:
+            return (static_cast<size_t>(width) * 12 + 7) / 8;
+        default:
+            // Pairs of pixels, an odd last pixel still takes two bytes
+            return (static_cast<size_t>(width) * 3 + 1) / 2;
+    }
+}
+
+const char* PackedMonoUnpacker::layoutName(Layout layout)
+{
+    switch (layout) {
+        case Mono10p:      return "Mono10p";
+        case Mono12p:      return "Mono12p";
+        case Mono10packed: return "Mono10packed";
+        default:           return "Mono12packed";
+    }
+}
+
+// One pixel of each layout, used by the scalar loop and the SIMD row tails
+template <PackedMonoUnpacker::Layout L>
+static inline uint16_t unpackPixel(const uint8_t* row, int x)
+{
+    if (L == PackedMonoUnpacker::Mono10p || L == PackedMonoUnpacker::Mono12p) {
+        const int bits = (L == PackedMonoUnpacker::Mono10p) ? 10 : 12;
+        const size_t bitPos = static_cast<size_t>(x) * bits;
+        const uint8_t* p = row + bitPos / 8;
+        // A pixel never spans more than two bytes at these depths
+        const unsigned v = p[0] | (p[1] << 8);
+        return static_cast<uint16_t>((v >> (bitPos % 8)) & ((1u << bits) - 1));
+    }
+
+    const int shift = (L == PackedMonoUnpacker::Mono10packed) ? 2 : 4;
+    const unsigned lowMask = (1u << shift) - 1;
+    const uint8_t* p = row + static_cast<size_t>(x / 2) * 3;
+    if ((x & 1) == 0) {
+        return static_cast<uint16_t>((p[0] << shift) | (p[1] & lowMask));
+    }
+    return static_cast<uint16_t>((p[2] << shift) | ((p[1] >> 4) & lowMask));
+}
+
+template <PackedMonoUnpacker::Layout L>
+static void unpackScalar(const uint8_t* src, size_t srcStride, uint16_t* dst, size_t dstStride,
+                         int width, int height)
+{
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* in = src + srcStride * y;
+        uint16_t* out = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(dst) + dstStride * y);
+        for (int x = 0; x < width; ++x) {
+            out[x] = unpackPixel<L>(in, x);
+        }
+    }
+}
+
+#ifdef PACKED_MONO_X86
+
+// Per layout: the shuffle that puts each pixel's two source bytes in a 16-bit
+// lane, the multipliers that move its lowest bit to the top of a bit field
+// ending at bit 15, and the right shift that brings the field down again.
+// The legacy layouts OR in their high byte separately.
+struct VectorLayout
+{
+    int bytesPer8;          // Source bytes consumed per 8 pixels
+    int8_t shuffle[16];
+    int16_t multiplier[8];
+    int lowShift;
+    int highShift;          // Legacy layouts only
+    int16_t highMask;       // 0 for the bit-stream layouts
+};
+
+static const VectorLayout VECTOR_LAYOUTS[] = {
+    // Mono10p: lane j of each 5-byte group holds bytes j, j + 1, field starts at bit 2j
+    { 10, { 0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9 },
+      { 64, 16, 4, 1, 64, 16, 4, 1 }, 6, 0, 0 },
+    // Mono12p: even pixels start at bit 0 of bytes 0/1, odd at bit 4 of bytes 1/2
+    { 12, { 0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11 },
+      { 16, 1, 16, 1, 16, 1, 16, 1 }, 4, 0, 0 },
+    // Mono10packed: lanes are b1 | b0 << 8 and b1 | b2 << 8
+    { 12, { 1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11 },
+      { 1 << 14, 1 << 10, 1 << 14, 1 << 10, 1 << 14, 1 << 10, 1 << 14, 1 << 10 }, 14, 6, 0x3FC },
+    // Mono12packed: same lanes, 4 low bits
+    { 12, { 1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11 },
+      { 1 << 12, 1 << 8, 1 << 12, 1 << 8, 1 << 12, 1 << 8, 1 << 12, 1 << 8 }, 12, 4, 0xFF0 },
+};
+
+typedef void (*ScalarRowTail)(const uint8_t* row, uint16_t* out, int x, int width);
+
+template <PackedMonoUnpacker::Layout L>
+static void scalarTail(const uint8_t* row, uint16_t* out, int x, int width)
+{
+    for (; x < width; ++x) {
+        out[x] = unpackPixel<L>(row, x);
+    }
+}
+
+static const ScalarRowTail SCALAR_TAILS[] = {
+    scalarTail<PackedMonoUnpacker::Mono10p>,
+    scalarTail<PackedMonoUnpacker::Mono12p>,
+    scalarTail<PackedMonoUnpacker::Mono10packed>,
+    scalarTail<PackedMonoUnpacker::Mono12packed>,
+};
+
+__attribute__((target("sse4.1")))
+static void unpackSse41(const VectorLayout& vl, ScalarRowTail tail, const uint8_t* src, size_t srcStride,
+                        uint16_t* dst, size_t dstStride, int width, int height, size_t rowBytes)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vl.shuffle));
+    const __m128i multiplier = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vl.multiplier));
+    const __m128i lowShift = _mm_cvtsi32_si128(vl.lowShift);
+    const __m128i highShift = _mm_cvtsi32_si128(vl.highShift);
+    const __m128i highMask = _mm_set1_epi16(vl.highMask);
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* in = src + srcStride * y;
+        uint16_t* out = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(dst) + dstStride * y);
+
+        // Each load reads 16 bytes, stop while they are still inside the row
+        int x = 0;
+        size_t offset = 0;
+        for (; offset + 16 <= rowBytes; x += 8, offset += vl.bytesPer8) {
+            __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset)), shuffle);
+            __m128i p = _mm_srl_epi16(_mm_mullo_epi16(v, multiplier), lowShift);
+            p = _mm_or_si128(p, _mm_and_si128(_mm_srl_epi16(v, highShift), highMask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), p);
+        }
+        tail(in, out, x, width);
+    }
+}
+
+__attribute__((target("avx2")))
+static void unpackAvx2(const VectorLayout& vl, ScalarRowTail tail, const uint8_t* src, size_t srcStride,
+                       uint16_t* dst, size_t dstStride, int width, int height, size_t rowBytes)
+{
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vl.shuffle)));
+    const __m256i multiplier = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vl.multiplier)));
+    const __m128i lowShift = _mm_cvtsi32_si128(vl.lowShift);
+    const __m128i highShift = _mm_cvtsi32_si128(vl.highShift);
+    const __m256i highMask = _mm256_set1_epi16(vl.highMask);
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* in = src + srcStride * y;
+        uint16_t* out = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(dst) + dstStride * y);
+
+        // 16 pixels per step: each 128-bit lane unpacks 8 pixels from its own load
+        int x = 0;
+        size_t offset = 0;
+        for (; offset + vl.bytesPer8 + 16 <= rowBytes; x += 16, offset += 2 * vl.bytesPer8) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset + vl.bytesPer8));
+            __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+            __m256i p = _mm256_srl_epi16(_mm256_mullo_epi16(v, multiplier), lowShift);
+            p = _mm256_or_si256(p, _mm256_and_si256(_mm256_srl_epi16(v, highShift), highMask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), p);
+        }
+        tail(in, out, x, width);
+    }
+}
+
+#endif
+
+void PackedMonoUnpacker::unpack(Layout layout, const uint8_t* src, size_t srcStride,
+                                uint16_t* dst, size_t dstStride, int width, int height)
+{
+    static const MonoDisplayMapper::SimdLevel level = MonoDisplayMapper::detectSimdLevel();
+    unpack(layout, src, srcStride, dst, dstStride, width, height, level);
+}
+
+void PackedMonoUnpacker::unpack(Layout layout, const uint8_t* src, size_t srcStride,
+                                uint16_t* dst, size_t dstStride, int width, int height,
+                                MonoDisplayMapper::SimdLevel level)
+{
+#ifdef PACKED_MONO_X86
+    if (level != MonoDisplayMapper::SimdScalar) {
+        const VectorLayout& vl = VECTOR_LAYOUTS[layout];
+        const size_t bytes = rowBytes(layout, width);
+        if (level == MonoDisplayMapper::SimdAvx2) {
+            unpackAvx2(vl, SCALAR_TAILS[layout], src, srcStride, dst, dstStride, width, height, bytes);
+        } else {
+            unpackSse41(vl, SCALAR_TAILS[layout], src, srcStride, dst, dstStride, width, height, bytes);
+        }
+        return;
+    }
+#else
+    (void)level;
+#endif
+
+    switch (layout) {
+        case Mono10p:
+            unpackScalar<Mono10p>(src, srcStride, dst, dstStride, width, height);
+            break;
+        case Mono12p:
+            unpackScalar<Mono12p>(src, srcStride, dst, dstStride, width, height);
+            break;
+        case Mono10packed:
+            unpackScalar<Mono10packed>(src, srcStride, dst, dstStride, width, height);
+            break;
+        case Mono12packed:
+            unpackScalar<Mono12packed>(src, srcStride, dst, dstStride, width, height);
+            break;
+    }
+}
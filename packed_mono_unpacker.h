@@ -0,0 +1,46 @@
+#ifndef PACKED_MONO_UNPACKER_H
+#define PACKED_MONO_UNPACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "mono_display_mapper.h"
+
+// Unpacks bit-packed mono rows into one uint16_t per pixel.
+//
+// Mono10p / Mono12p (GenICam PFNC): pixels form one LSB-first bit stream,
+//     4 pixels in 5 bytes / 2 pixels in 3 bytes.
+// Mono10packed / Mono12packed (Basler GigE legacy): 2 pixels in 3 bytes, the
+//     middle byte holds the low bits of both pixels
+//     p0 = b0 << n | (b1 & lowMask), p1 = b2 << n | (b1 >> 4 & lowMask).
+//
+// The SSE4.1 and AVX2 kernels shuffle each pixel's two source bytes into a
+// 16-bit lane and shift the bits into place with one multiply per vector;
+// they are picked the same way as MonoDisplayMapper's kernels and give the
+// same result as the scalar loop.
+class PackedMonoUnpacker
+{
+public:
+    enum Layout {
+        Mono10p,
+        Mono12p,
+        Mono10packed,
+        Mono12packed
+    };
+
+    // Significant bits per unpacked pixel
+    static int bitDepth(Layout layout);
+
+    // Bytes holding one row of the given width, without padding
+    static size_t rowBytes(Layout layout, int width);
+
+    // Strides are in bytes
+    static void unpack(Layout layout, const uint8_t* src, size_t srcStride,
+                       uint16_t* dst, size_t dstStride, int width, int height);
+    static void unpack(Layout layout, const uint8_t* src, size_t srcStride,
+                       uint16_t* dst, size_t dstStride, int width, int height,
+                       MonoDisplayMapper::SimdLevel level);
+
+    static const char* layoutName(Layout layout);
+};
+
+#endif // PACKED_MONO_UNPACKER_H
@@ -0,0 +1,464 @@
+#include "playback_frame_source.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <climits>
+
+using namespace Pylon;
+
+// Sequence records the kernel is asked to read ahead of the playback position
+static const quint64 PREFETCH_FRAMES = 4;
+
+// Real-time pacing gives up on the recorded schedule when this far behind it
+static const int MAX_LAG_MS = 50;
+
+PlaybackFrameSource::PlaybackFrameSource(const QString &path)
+    : m_path(path)
+    , m_open(false)
+    , m_isSequence(false)
+    , m_hasCameraTimestamps(false)
+    , m_tickFrequency(0.0)
+    , m_frameCount(0)
+    , m_width(0)
+    , m_height(0)
+    , m_pixelType(PixelType_Undefined)
+    , m_frameIdSpan(0)
+    , m_blockIdSpan(0)
+    , m_timestampSpan(0)
+    , m_pacing(PacingRealTime)
+    , m_loop(false)
+    , m_frameRate(30.0)
+    , m_seekRequest(-1)
+    , m_next(0)
+    , m_anchored(false)
+    , m_anchorIndex(0)
+    , m_position(-1)
+    , m_loopCount(0)
+    , m_finished(false)
+    , m_interrupted(false)
+{
+}
+
+bool PlaybackFrameSource::open(QString &error)
+{
+    close();
+
+    if (m_path.isEmpty()) {
+        error = "No playback file or directory selected";
+        return false;
+    }
+
+    const QFileInfo info(m_path);
+    if (!info.exists()) {
+        error = QString("%1 does not exist").arg(m_path);
+        return false;
+    }
+
+    m_isSequence = !info.isDir();
+    if (!(m_isSequence ? openSequence(error) : openDirectory(error))) {
+        close();
+        return false;
+    }
+
+    m_open = true;
+    m_next = 0;
+    m_anchored = false;
+    m_position = -1;
+    m_loopCount = 0;
+    m_finished = false;
+
+    qDebug() << "[PlaybackFrameSource] Opened" << m_path << ":" << m_frameCount << "frames,"
+             << m_width << "x" << m_height << "pixel type" << m_pixelType
+             << (m_hasCameraTimestamps ? "with camera timestamps" : "without camera timestamps");
+    return true;
+}
+
+bool PlaybackFrameSource::openSequence(QString &error)
+{
+    std::shared_ptr<RawSequenceReader> sequence = std::make_shared<RawSequenceReader>();
+    if (!sequence->open(m_path, error)) {
+        return false;
+    }
+
+    const RawSequence::FileHeader &header = sequence->header();
+    const EPixelType pixelType = static_cast<EPixelType>(header.pixelType);
+    const int type = matType(pixelType);
+    if (type < 0) {
+        error = QString("Pixel type %1 in %2 cannot be played back").arg(header.pixelType).arg(m_path);
+        return false;
+    }
+    if (header.payloadSize != static_cast<uint64_t>(header.width) * header.height * CV_ELEM_SIZE(type)) {
+        error = QString("%1 has a payload size that does not match its geometry").arg(m_path);
+        return false;
+    }
+    if (sequence->frameCount() == 0) {
+        error = QString("%1 holds no frames").arg(m_path);
+        return false;
+    }
+
+    m_frameCount = static_cast<int>(qMin<quint64>(sequence->frameCount(), INT_MAX));
+    m_width = static_cast<int>(header.width);
+    m_height = static_cast<int>(header.height);
+    m_pixelType = pixelType;
+    m_tickFrequency = header.timestampTickFrequency;
+
+    // Camera clock when the recording has it, host arrival time otherwise
+    const RawSequence::RecordHeader *first = sequence->record(0);
+    const RawSequence::RecordHeader *last = sequence->record(m_frameCount - 1);
+    m_hasCameraTimestamps = (m_tickFrequency > 0.0 && first->cameraTimestamp != 0);
+    m_timesNs.resize(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) {
+        const RawSequence::RecordHeader *record = sequence->record(i);
+        if (m_hasCameraTimestamps) {
+            const int64_t ticks = static_cast<int64_t>(record->cameraTimestamp - first->cameraTimestamp);
+            m_timesNs[i] = static_cast<int64_t>(ticks * 1e9 / m_tickFrequency);
+        } else {
+            m_timesNs[i] = record->hostTimestampNs - first->hostTimestampNs;
+        }
+    }
+
+    // The next pass starts one frame after this one ends
+    const int64_t intervalNs = (m_frameCount > 1 && m_timesNs.back() > 0)
+                               ? m_timesNs.back() / (m_frameCount - 1)
+                               : static_cast<int64_t>(1e9 / getFrameRate());
+    m_frameIdSpan = last->frameId - first->frameId + 1;
+    m_blockIdSpan = last->blockId - first->blockId + 1;
+    m_timestampSpan = m_hasCameraTimestamps
+                      ? last->cameraTimestamp - first->cameraTimestamp
+                        + static_cast<uint64_t>(intervalNs * m_tickFrequency / 1e9)
+                      : 0;
+
+    m_sequence = sequence;
+    m_sequence->prefetch(0, PREFETCH_FRAMES);
+    return true;
+}
+
+bool PlaybackFrameSource::openDirectory(QString &error)
+{
+    QDir dir(m_path);
+    QStringList names = dir.entryList(QStringList() << "*.bmp" << "*.png" << "*.tif" << "*.tiff", QDir::Files);
+
+    // pattern_9.bmp before pattern_10.bmp
+    std::sort(names.begin(), names.end(), [](const QString &a, const QString &b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+    if (names.isEmpty()) {
+        error = QString("No BMP, PNG or TIFF files in %1").arg(m_path);
+        return false;
+    }
+
+    m_files.clear();
+    for (const QString &name : names) {
+        m_files.append(dir.filePath(name));
+    }
+
+    // The first image tells the geometry, later ones may differ like after a format change
+    QString readError;
+    const FrameHandle first = makeFrame(0, 0, readError);
+    if (first.isEmpty()) {
+        error = readError;
+        return false;
+    }
+
+    m_frameCount = m_files.size();
+    m_width = first.width();
+    m_height = first.height();
+    m_pixelType = first.pixelType();
+    m_tickFrequency = 0.0;
+    m_hasCameraTimestamps = false;
+    m_timesNs.clear();
+    m_frameIdSpan = m_frameCount;
+    m_blockIdSpan = static_cast<uint64_t>(m_frameCount);
+    m_timestampSpan = 0;
+    return true;
+}
+
+void PlaybackFrameSource::close()
+{
+    // Frames still in the pipeline keep the mapping alive
+    m_open = false;
+    m_sequence.reset();
+    m_files.clear();
+    m_timesNs.clear();
+    m_frameCount = 0;
+}
+
+QString PlaybackFrameSource::getName() const
+{
+    return QString("Playback: %1").arg(QFileInfo(m_path).fileName());
+}
+
+QString PlaybackFrameSource::getModel() const
+{
+    return m_isSequence ? "Raw Sequence" : "Image Directory";
+}
+
+void PlaybackFrameSource::startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition)
+{
+    // Frames are views into the recording, there is no buffer pool or frame queue
+    Q_UNUSED(bufferConfig);
+    Q_UNUSED(acquisition);
+
+    // Grabbing again after the end starts over, otherwise it resumes
+    if (m_finished) {
+        m_next = 0;
+        m_finished = false;
+    }
+    m_anchored = false;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_interrupted = false;
+    }
+}
+
+void PlaybackFrameSource::stopGrabbing()
+{
+}
+
+void PlaybackFrameSource::interruptRetrieve()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_interrupted = true;
+    }
+    m_wakeUp.notify_all();
+}
+
+bool PlaybackFrameSource::waitUntil(Clock::time_point time)
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeUp.wait_until(lock, time, [this]() { return m_interrupted; });
+
+    const bool interrupted = m_interrupted;
+    m_interrupted = false;
+    return !interrupted;
+}
+
+int64_t PlaybackFrameSource::recordedTimeNs(int index, double frameRate) const
+{
+    if (m_isSequence) {
+        return m_timesNs[index];
+    }
+    return frameRate > 0.0 ? static_cast<int64_t>(index * 1e9 / frameRate) : 0;
+}
+
+IFrameSource::RetrieveStatus PlaybackFrameSource::retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error)
+{
+    if (!m_open) {
+        return RetrieveTimeout;
+    }
+
+    Pacing pacing;
+    bool loop;
+    double frameRate;
+    int seek;
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        pacing = m_pacing;
+        loop = m_loop;
+        frameRate = m_frameRate;
+        seek = m_seekRequest;
+        m_seekRequest = -1;
+    }
+
+    if (seek >= 0) {
+        m_next = qMin(seek, m_frameCount - 1);
+        m_anchored = false;
+        m_finished = false;
+        if (m_sequence) {
+            m_sequence->prefetch(m_next, PREFETCH_FRAMES);
+        }
+    }
+
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    if (m_next >= m_frameCount) {
+        if (!loop) {
+            m_finished = true;
+            waitUntil(deadline);
+            return RetrieveTimeout;
+        }
+
+        // Keep the recorded rhythm across the wrap: one average interval after the last frame
+        const int64_t intervalNs = m_frameCount > 1 ? recordedTimeNs(m_frameCount - 1, frameRate) / (m_frameCount - 1) : 0;
+        m_next = 0;
+        m_loopCount++;
+        if (m_anchored) {
+            m_anchorTime = m_lastDue + std::chrono::nanoseconds(intervalNs);
+            m_anchorIndex = 0;
+        }
+    }
+
+    Clock::time_point due = Clock::now();
+    if (pacing == PacingRealTime) {
+        int64_t offsetNs = 0;
+        if (m_anchored) {
+            offsetNs = recordedTimeNs(m_next, frameRate) - recordedTimeNs(m_anchorIndex, frameRate);
+        }
+        if (!m_anchored || offsetNs < 0) {
+            // First frame, after a seek, or timestamps going backwards in the recording
+            m_anchorTime = due;
+            m_anchorIndex = m_next;
+            m_anchored = true;
+            offsetNs = 0;
+        }
+
+        due = m_anchorTime + std::chrono::nanoseconds(offsetNs);
+        if (due > deadline) {
+            waitUntil(deadline);
+            return RetrieveTimeout;
+        }
+        if (!waitUntil(due)) {
+            return RetrieveTimeout;
+        }
+
+        // After a stall the rest of the playback moves, every frame is still delivered
+        const Clock::time_point now = Clock::now();
+        if (now - due > std::chrono::milliseconds(MAX_LAG_MS)) {
+            m_anchorTime = now;
+            m_anchorIndex = m_next;
+            due = now;
+        }
+    } else {
+        m_anchored = false;
+    }
+    m_lastDue = due;
+
+    const int index = m_next++;
+    const uint64_t scheduledNs = std::chrono::duration_cast<std::chrono::nanoseconds>(due.time_since_epoch()).count();
+    frame = makeFrame(index, scheduledNs, error);
+    m_position = index;
+    return frame.isEmpty() ? RetrieveFailed : RetrieveOk;
+}
+
+FrameHandle PlaybackFrameSource::makeFrame(int index, uint64_t cameraTimestamp, QString &error)
+{
+    const int64_t loops = m_loopCount;
+
+    if (!m_isSequence) {
+        cv::Mat image = cv::imread(m_files.at(index).toStdString(), cv::IMREAD_UNCHANGED);
+        if (!image.empty() && image.channels() == 4) {
+            cv::cvtColor(image, image, cv::COLOR_BGRA2BGR);
+        }
+        // 16 bits per pixel from the lossless formats, whatever depth the camera had
+        EPixelType pixelType = PixelType_Undefined;
+        if (image.type() == CV_8UC1) {
+            pixelType = PixelType_Mono8;
+        } else if (image.type() == CV_8UC3) {
+            pixelType = PixelType_BGR8packed;
+        } else if (image.type() == CV_16UC1) {
+            pixelType = PixelType_Mono16;
+        }
+        if (pixelType == PixelType_Undefined) {
+            error = QString("Cannot play back %1, not an 8-bit or 16-bit mono or BGR image").arg(m_files.at(index));
+            return FrameHandle();
+        }
+
+        const int64_t frameId = index + loops * m_frameIdSpan;
+        return FrameHandle::fromRecording(image, pixelType, frameId, static_cast<uint64_t>(frameId),
+                                          cameraTimestamp, 0, 0.0, nullptr);
+    }
+
+    const RawSequence::RecordHeader *record = m_sequence->record(index);
+    if (!record || static_cast<int>(record->width) != m_width || static_cast<int>(record->height) != m_height ||
+        record->pixelType != static_cast<uint32_t>(m_pixelType)) {
+        error = QString("Record %1 of %2 does not match the sequence").arg(index).arg(m_path);
+        return FrameHandle();
+    }
+    m_sequence->prefetch(index + 1, PREFETCH_FRAMES);
+
+    // A view into the mapping, the frame holds a reference to the reader
+    cv::Mat image(m_height, m_width, matType(m_pixelType), const_cast<uint8_t*>(m_sequence->pixels(index)));
+    if (m_hasCameraTimestamps) {
+        cameraTimestamp = record->cameraTimestamp + static_cast<uint64_t>(loops) * m_timestampSpan;
+    }
+    return FrameHandle::fromRecording(image, m_pixelType, record->frameId + loops * m_frameIdSpan,
+                                      record->blockId + static_cast<uint64_t>(loops) * m_blockIdSpan,
+                                      cameraTimestamp, record->skippedImages, record->exposureTimeUs, m_sequence);
+}
+
+double PlaybackFrameSource::getTimestampTickFrequency() const
+{
+    // Recorded camera ticks, or the host clock the frames are stamped with
+    return m_hasCameraTimestamps ? m_tickFrequency : 1e9;
+}
+
+bool PlaybackFrameSource::latchTimestamp(uint64_t &ticks, int64_t &hostNs)
+{
+    // The recorded camera clock has no relation to ours
+    if (m_hasCameraTimestamps) {
+        return false;
+    }
+    hostNs = FrameHandle::currentTimestampNs();
+    ticks = static_cast<uint64_t>(hostNs);
+    return true;
+}
+
+void PlaybackFrameSource::setPacing(Pacing pacing)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_pacing = pacing;
+}
+
+PlaybackFrameSource::Pacing PlaybackFrameSource::getPacing() const
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_pacing;
+}
+
+void PlaybackFrameSource::setLoop(bool loop)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_loop = loop;
+}
+
+bool PlaybackFrameSource::getLoop() const
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_loop;
+}
+
+void PlaybackFrameSource::setFrameRate(double frameRate)
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_frameRate = frameRate > 0.0 ? frameRate : 30.0;
+}
+
+double PlaybackFrameSource::getFrameRate() const
+{
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    return m_frameRate;
+}
+
+void PlaybackFrameSource::seek(int frameIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        m_seekRequest = qMax(0, frameIndex);
+    }
+    m_finished = false;
+
+    // Do not sit out a long real-time wait first
+    interruptRetrieve();
+}
+
+int PlaybackFrameSource::matType(EPixelType pixelType)
+{
+    switch (pixelType) {
+        case PixelType_Mono8:
+        case PixelType_BayerRG8:
+        case PixelType_BayerBG8:
+        case PixelType_BayerGR8:
+        case PixelType_BayerGB8:
+            return CV_8UC1;
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16:
+            return CV_16UC1;
+        case PixelType_RGB8packed:
+        case PixelType_BGR8packed:
+            return CV_8UC3;
+        default:
+            return -1;
+    }
+}
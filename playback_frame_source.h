@@ -0,0 +1,139 @@
+#ifndef PLAYBACK_FRAME_SOURCE_H
+#define PLAYBACK_FRAME_SOURCE_H
+
+#include <QStringList>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "frame_source.h"
+#include "raw_sequence.h"
+
+// Replays a recording through the same pipeline as a live camera.
+//
+// The path is either a .bseq file (FrameRecorder's raw sequence format) or
+// a directory of BMP, PNG or TIFF files as FrameRecorder writes them. A
+// sequence is memory-mapped with RawSequenceReader and every frame is a
+// view into the mapping that keeps it alive, so replaying costs no pixel
+// copies; image files are decoded one at a time, 16-bit ones as Mono16.
+// Sequence frames keep their recorded frame IDs, block IDs, camera
+// timestamps and exposure, so frame timing and drop statistics see what the
+// camera delivered. Frames without a camera timestamp (image files,
+// sequences recorded without one) are stamped with their scheduled delivery
+// time on the host's steady clock, like the synthetic source.
+//
+// Real-time pacing spaces the frames like the recorded timestamps (camera
+// clock, or host arrival time without one; the frame rate setting for image
+// files). A stall delays the rest of the playback instead of dropping
+// frames. Max speed hands out a frame on every retrieveFrame() for
+// throughput measurements. With looping, frame IDs and timestamps keep
+// counting up over each pass. Pacing, looping and seeking may be changed
+// from any thread while grabbing and apply to the next frame.
+class PlaybackFrameSource : public IFrameSource
+{
+public:
+    enum Pacing {
+        PacingRealTime,   // Intervals of the recording
+        PacingMaxSpeed    // As fast as the grab loop takes frames
+    };
+
+    explicit PlaybackFrameSource(const QString &path);
+
+    bool open(QString &error) override;
+    void close() override;
+    bool isOpen() const override { return m_open; }
+
+    QString getName() const override;
+    QString getModel() const override;
+    QString getSerial() const override { return "N/A"; }
+
+    void startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition) override;
+    void stopGrabbing() override;
+    RetrieveStatus retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error) override;
+    void interruptRetrieve() override;
+    double getTimestampTickFrequency() const override;
+    bool latchTimestamp(uint64_t &ticks, int64_t &hostNs) override;
+
+    void setPacing(Pacing pacing);
+    Pacing getPacing() const;
+    void setLoop(bool loop);
+    bool getLoop() const;
+
+    // Real-time rate for recordings without timestamps (image directories)
+    void setFrameRate(double frameRate);
+    double getFrameRate() const;
+
+    // Frame to deliver next, clamped to the recording
+    void seek(int frameIndex);
+
+    // Recording geometry, known after open()
+    int getFrameCount() const { return m_frameCount; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    Pylon::EPixelType getPixelType() const { return m_pixelType; }
+
+    // Index of the last frame delivered, -1 before the first
+    int getPosition() const { return m_position; }
+    int getLoopCount() const { return m_loopCount; }
+    // The last frame has been delivered and looping is off
+    bool isFinished() const { return m_finished; }
+
+    // cv::Mat type of the frames FrameHandle wraps natively, -1 for other formats
+    static int matType(Pylon::EPixelType pixelType);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool openSequence(QString &error);
+    bool openDirectory(QString &error);
+    FrameHandle makeFrame(int index, uint64_t cameraTimestamp, QString &error);
+
+    // Recorded time of a frame relative to the first one, for pacing
+    int64_t recordedTimeNs(int index, double frameRate) const;
+
+    // Sleeps until the time point, false when interruptRetrieve() ended it early
+    bool waitUntil(Clock::time_point time);
+
+    QString m_path;
+    bool m_open;
+    bool m_isSequence;
+    std::shared_ptr<RawSequenceReader> m_sequence;   // Frames share it with the source
+    QStringList m_files;                             // Image files in playback order
+    std::vector<int64_t> m_timesNs;                  // recordedTimeNs() of each sequence frame
+    bool m_hasCameraTimestamps;
+    double m_tickFrequency;
+    int m_frameCount;
+    int m_width;
+    int m_height;
+    Pylon::EPixelType m_pixelType;
+
+    // Added to IDs and timestamps on every pass, so looping never goes back
+    int64_t m_frameIdSpan;
+    uint64_t m_blockIdSpan;
+    uint64_t m_timestampSpan;
+
+    // Guarded by m_controlMutex
+    mutable std::mutex m_controlMutex;
+    Pacing m_pacing;
+    bool m_loop;
+    double m_frameRate;
+    int m_seekRequest;      // -1 when none
+
+    // Grab thread state
+    int m_next;
+    bool m_anchored;        // m_anchorTime belongs to m_anchorIndex
+    Clock::time_point m_anchorTime;
+    int m_anchorIndex;
+    Clock::time_point m_lastDue;
+    std::atomic<int> m_position;
+    std::atomic<int> m_loopCount;
+    std::atomic<bool> m_finished;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeUp;
+    bool m_interrupted;     // Guarded by m_wakeMutex
+};
+
+#endif // PLAYBACK_FRAME_SOURCE_H
@@ -0,0 +1,257 @@
+#include "pooled_buffer_factory.h"
+#include <QDebug>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+using namespace Pylon;
+
+static size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+PooledBufferFactory::PooledBufferFactory()
+    : m_current(nullptr)
+    , m_fallbackCount(0)
+    , m_heapOutstanding(0)
+    , m_released(false)
+{
+}
+
+PooledBufferFactory::~PooledBufferFactory()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Only reached with every buffer back, see release()
+    if (m_current) {
+        destroyPool(m_current);
+        m_current = nullptr;
+    }
+    for (Pool* pool : m_retired) {
+        destroyPool(pool);
+    }
+    m_retired.clear();
+}
+
+void PooledBufferFactory::release()
+{
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_released = true;
+
+        // Frames may still hold grab results, their pools stay mapped until they are freed
+        retireCurrentPool();
+        idle = m_retired.empty() && m_heapOutstanding == 0;
+        if (!idle) {
+            qDebug() << "[PooledBufferFactory] Released with buffers still in use, freed with the last one";
+        }
+    }
+
+    if (idle) {
+        delete this;
+    }
+}
+
+bool PooledBufferFactory::preallocate(size_t bufferSize, int bufferCount, bool useHugePages, bool lockMemory)
+{
+    if (bufferSize == 0 || bufferCount <= 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Keep the current pool when it already matches the requested layout
+    const size_t stride = roundUp(bufferSize, BUFFER_ALIGNMENT);
+    if (m_current && m_current->stride == stride && m_current->count == bufferCount &&
+        m_current->hugePagesRequested == useHugePages && m_current->lockRequested == lockMemory) {
+        return true;
+    }
+
+    retireCurrentPool();
+    m_current = createPool(bufferSize, bufferCount, useHugePages, lockMemory);
+    return m_current != nullptr;
+}
+
+PooledBufferFactory::Pool* PooledBufferFactory::createPool(size_t bufferSize, int bufferCount,
+                                                           bool useHugePages, bool lockMemory)
+{
+    Pool* pool = new Pool();
+    pool->stride = roundUp(bufferSize, BUFFER_ALIGNMENT);
+    pool->count = bufferCount;
+    pool->mappedBytes = pool->stride * bufferCount;
+    pool->hugePagesRequested = useHugePages;
+    pool->lockRequested = lockMemory;
+
+    void* base = MAP_FAILED;
+
+    if (useHugePages) {
+        // Explicit hugepages need pages reserved in /proc/sys/vm/nr_hugepages
+        const size_t hugeBytes = roundUp(pool->mappedBytes, HUGE_PAGE_SIZE);
+        base = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if (base != MAP_FAILED) {
+            pool->mappedBytes = hugeBytes;
+            pool->hugePages = true;
+        } else {
+            qDebug() << "[PooledBufferFactory] Hugepage mapping failed (" << strerror(errno)
+                     << "), using transparent hugepages";
+        }
+    }
+
+    if (base == MAP_FAILED) {
+        base = mmap(nullptr, pool->mappedBytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            qDebug() << "[PooledBufferFactory] Failed to map buffer pool:" << strerror(errno);
+            delete pool;
+            return nullptr;
+        }
+
+        if (useHugePages) {
+            madvise(base, pool->mappedBytes, MADV_HUGEPAGE);
+        }
+
+        // Fault every page in now instead of on the first frames
+        memset(base, 0, pool->mappedBytes);
+    }
+
+    pool->base = static_cast<uint8_t*>(base);
+
+    if (lockMemory) {
+        if (mlock(pool->base, pool->mappedBytes) == 0) {
+            pool->locked = true;
+        } else {
+            qDebug() << "[PooledBufferFactory] mlock failed (" << strerror(errno)
+                     << "), check RLIMIT_MEMLOCK; continuing without pinned memory";
+        }
+    }
+
+    // Hand out the lowest addresses first
+    pool->freeList.reserve(bufferCount);
+    for (int i = bufferCount - 1; i >= 0; --i) {
+        pool->freeList.push_back(i);
+    }
+
+    qDebug() << "[PooledBufferFactory] Pool ready:" << bufferCount << "x" << pool->stride << "bytes,"
+             << (pool->hugePages ? "hugepages" : "regular pages") << (pool->locked ? ", locked" : "");
+    return pool;
+}
+
+void PooledBufferFactory::destroyPool(Pool* pool)
+{
+    if (pool->locked) {
+        munlock(pool->base, pool->mappedBytes);
+    }
+    munmap(pool->base, pool->mappedBytes);
+    delete pool;
+}
+
+void PooledBufferFactory::retireCurrentPool()
+{
+    if (!m_current) {
+        return;
+    }
+
+    if (m_current->outstanding == 0) {
+        destroyPool(m_current);
+    } else {
+        m_current->retired = true;
+        m_retired.push_back(m_current);
+    }
+    m_current = nullptr;
+}
+
+void PooledBufferFactory::AllocateBuffer(size_t bufferSize, void** pCreatedBuffer, intptr_t& bufferContext)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_current && bufferSize <= m_current->stride && !m_current->freeList.empty()) {
+        const int index = m_current->freeList.back();
+        m_current->freeList.pop_back();
+        m_current->outstanding++;
+
+        *pCreatedBuffer = m_current->base + static_cast<size_t>(index) * m_current->stride;
+        bufferContext = reinterpret_cast<intptr_t>(m_current);
+        return;
+    }
+
+    // Not covered by the pool, serve it from the heap so grabbing still works
+    void* buffer = std::aligned_alloc(BUFFER_ALIGNMENT, roundUp(bufferSize, BUFFER_ALIGNMENT));
+    if (buffer == nullptr) {
+        throw std::bad_alloc();
+    }
+    m_fallbackCount++;
+    m_heapOutstanding++;
+
+    qDebug() << "[PooledBufferFactory] Pool cannot serve" << bufferSize << "bytes, using heap buffer";
+    *pCreatedBuffer = buffer;
+    bufferContext = 0;
+}
+
+void PooledBufferFactory::FreeBuffer(void* pCreatedBuffer, intptr_t bufferContext)
+{
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (bufferContext == 0) {
+            std::free(pCreatedBuffer);
+            m_heapOutstanding--;
+        } else {
+            Pool* pool = reinterpret_cast<Pool*>(bufferContext);
+            const size_t offset = static_cast<uint8_t*>(pCreatedBuffer) - pool->base;
+            pool->freeList.push_back(static_cast<int>(offset / pool->stride));
+            pool->outstanding--;
+
+            // A replaced pool goes away with its last buffer
+            if (pool->retired && pool->outstanding == 0) {
+                for (size_t i = 0; i < m_retired.size(); ++i) {
+                    if (m_retired[i] == pool) {
+                        m_retired.erase(m_retired.begin() + i);
+                        break;
+                    }
+                }
+                destroyPool(pool);
+            }
+        }
+
+        idle = m_released && m_retired.empty() && m_heapOutstanding == 0;
+    }
+
+    // The last buffer of a released factory
+    if (idle) {
+        delete this;
+    }
+}
+
+void PooledBufferFactory::DestroyBufferFactory()
+{
+    // Owned by PylonFrameSource through release(), registered with Cleanup_None
+}
+
+QString PooledBufferFactory::describe() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_current) {
+        return "Pylon default allocator";
+    }
+
+    return QString("%1 x %2 KB, %3%4, %5 in use, %6 heap fallback(s)")
+           .arg(m_current->count)
+           .arg(m_current->stride / 1024.0, 0, 'f', 1)
+           .arg(m_current->hugePages ? "hugepages" : "regular pages")
+           .arg(m_current->locked ? ", locked" : "")
+           .arg(m_current->outstanding)
+           .arg(m_fallbackCount);
+}
+
+quint64 PooledBufferFactory::getFallbackCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fallbackCount;
+}
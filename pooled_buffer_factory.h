@@ -0,0 +1,82 @@
+#ifndef POOLED_BUFFER_FACTORY_H
+#define POOLED_BUFFER_FACTORY_H
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Basler Pylon includes
+#include <pylon/PylonIncludes.h>
+
+// Pylon buffer factory backed by a preallocated pool.
+//
+// preallocate() maps one region holding bufferCount buffers, each starting
+// on a page boundary so O_DIRECT recording can write straight from them
+// (see RawSequenceWriter), prefaults it and optionally backs it with hugepages
+// and pins it with mlock(). AllocateBuffer()/FreeBuffer() then only move an
+// index on a free list, so starting the grab touches neither malloc nor
+// fresh pages. Requests the pool cannot serve (too large, pool exhausted)
+// fall back to aligned heap memory and are counted.
+//
+// Grab results can outlive a grab session, so a pool replaced by a new
+// layout stays mapped until its last buffer has been freed. For the same
+// reason the factory can outlive its camera: the owner calls release()
+// instead of deleting it, and it deletes itself once every buffer, pooled
+// or from the heap, has come back through FreeBuffer().
+class PooledBufferFactory : public Pylon::IBufferFactory
+{
+public:
+    PooledBufferFactory();
+
+    // Ends the owner's use, after the camera has been destroyed
+    void release();
+
+    // Lays out the pool for the next grab session, a no-op when the
+    // current pool already fits
+    bool preallocate(size_t bufferSize, int bufferCount, bool useHugePages, bool lockMemory);
+
+    // Pylon::IBufferFactory
+    void AllocateBuffer(size_t bufferSize, void** pCreatedBuffer, intptr_t& bufferContext) override;
+    void FreeBuffer(void* pCreatedBuffer, intptr_t bufferContext) override;
+    void DestroyBufferFactory() override;
+
+    // Short description of the active pool for the UI
+    QString describe() const;
+    quint64 getFallbackCount() const;
+
+    static const size_t BUFFER_ALIGNMENT = 4096;
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+private:
+    struct Pool
+    {
+        uint8_t* base = nullptr;
+        size_t mappedBytes = 0;
+        size_t stride = 0;
+        int count = 0;
+        std::vector<int> freeList;
+        int outstanding = 0;
+        bool hugePagesRequested = false;
+        bool lockRequested = false;
+        bool hugePages = false;
+        bool locked = false;
+        bool retired = false;
+    };
+
+    ~PooledBufferFactory();   // Through release()
+
+    static Pool* createPool(size_t bufferSize, int bufferCount, bool useHugePages, bool lockMemory);
+    static void destroyPool(Pool* pool);
+    void retireCurrentPool();
+
+    mutable std::mutex m_mutex;
+    Pool* m_current;
+    std::vector<Pool*> m_retired; // Replaced pools with buffers still in use
+    quint64 m_fallbackCount;
+    int m_heapOutstanding;        // Fallback buffers not freed yet
+    bool m_released;              // The owner is gone, the last FreeBuffer() deletes us
+};
+
+#endif // POOLED_BUFFER_FACTORY_H
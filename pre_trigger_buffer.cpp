@@ -0,0 +1,363 @@
+#include "pre_trigger_buffer.h"
+#include "raw_sequence.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <cstdlib>
+
+static size_t roundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void PreTriggerBuffer::FreeDeleter::operator()(void *p) const
+{
+    std::free(p);
+}
+
+PreTriggerBuffer::PreTriggerBuffer(QObject *parent)
+    : QObject(parent)
+    , m_stop(false)
+    , m_postRemaining(0)
+    , m_capturing(false)
+    , m_busy(false)
+    , m_frameBytes(0)
+    , m_enabled(false)
+    , m_memoryBytes(0)
+    , m_exposureTime(0.0)
+    , m_timestampTickFrequency(0.0)
+{
+    m_dumpThread = std::thread(&PreTriggerBuffer::dumpLoop, this);
+}
+
+PreTriggerBuffer::~PreTriggerBuffer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // A window still collecting its post-trigger frames is written as it is
+        if (m_capturing) {
+            m_pending.push_back(std::move(m_capture));
+            m_capturing = false;
+        }
+        m_stop = true;
+    }
+    m_dumpReady.notify_all();
+    if (m_dumpThread.joinable()) {
+        m_dumpThread.join();
+    }
+}
+
+void PreTriggerBuffer::setConfig(const Config &config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+
+    // Oldest frames go first when the window got shorter
+    const size_t depth = static_cast<size_t>(depthFor(m_frameBytes));
+    while (m_ring.size() > depth) {
+        m_memoryBytes -= m_ring.front().bytes;
+        m_ring.pop_front();
+    }
+    releaseSlots(m_free, 0);
+
+    qDebug() << "[PreTriggerBuffer] Config:" << config.preTriggerFrames << "frames before,"
+             << config.postTriggerFrames << "after, limit" << config.maxBytes << "bytes, path" << config.path;
+}
+
+PreTriggerBuffer::Config PreTriggerBuffer::getConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+void PreTriggerBuffer::setEnabled(bool enable)
+{
+    bool ready = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_enabled == enable) {
+            return;
+        }
+        m_enabled = enable;
+
+        if (!enable) {
+            if (m_capturing) {
+                m_pending.push_back(std::move(m_capture));
+                m_capture = Window();
+                m_capturing = false;
+                ready = true;
+            }
+            for (Slot &slot : m_ring) {
+                m_memoryBytes -= slot.bytes;
+            }
+            m_ring.clear();
+            releaseSlots(m_free, 0);
+        }
+    }
+
+    if (ready) {
+        m_dumpReady.notify_one();
+    }
+    qDebug() << "[PreTriggerBuffer] Enabled:" << enable;
+}
+
+void PreTriggerBuffer::push(const FrameHandle &frame)
+{
+    if (!m_enabled || frame.isEmpty()) {
+        return;
+    }
+
+    const size_t bytes = RawSequence::payloadSize(frame);
+    Slot slot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frameBytes = bytes;
+        if (!m_free.empty()) {
+            slot = std::move(m_free.back());
+            m_free.pop_back();
+        } else if (!m_capturing && !m_ring.empty() && static_cast<int>(m_ring.size()) >= depthFor(bytes)) {
+            // Full, reuse the oldest frame's slot
+            slot = std::move(m_ring.front());
+            m_ring.pop_front();
+        }
+    }
+
+    // Copy outside the lock, trigger() and the GUI never wait for it
+    slot.frame = FrameHandle();
+    if (slot.bytes < bytes) {
+        const size_t size = roundUp(bytes, RawSequence::BLOCK_SIZE);
+        m_memoryBytes -= slot.bytes;
+        slot.memory.reset(static_cast<uint8_t*>(std::aligned_alloc(RawSequence::BLOCK_SIZE, size)));
+        slot.bytes = slot.memory ? size : 0;
+        m_memoryBytes += slot.bytes;
+        if (!slot.memory) {
+            qDebug() << "[PreTriggerBuffer] Out of memory for a" << bytes << "byte frame";
+            return;
+        }
+    }
+
+    const cv::Mat &image = frame.image();
+    cv::Mat copy(image.rows, image.cols, image.type(), slot.memory.get());
+    image.copyTo(copy);
+    slot.frame = frame.withImage(copy);
+
+    bool ready = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            // Disabled while copying
+            m_memoryBytes -= slot.bytes;
+            return;
+        }
+
+        if (m_capturing) {
+            m_capture.frames.push_back(std::move(slot));
+            if (--m_postRemaining <= 0) {
+                m_pending.push_back(std::move(m_capture));
+                m_capture = Window();
+                m_capturing = false;
+                ready = true;
+            }
+        } else {
+            m_ring.push_back(std::move(slot));
+            const size_t depth = static_cast<size_t>(depthFor(bytes));
+            while (m_ring.size() > depth) {
+                m_free.push_back(std::move(m_ring.front()));
+                m_ring.pop_front();
+            }
+        }
+    }
+
+    if (ready) {
+        m_dumpReady.notify_one();
+    }
+}
+
+bool PreTriggerBuffer::trigger(const QString &reason)
+{
+    bool ready = false;
+    int preTriggerFrames = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return false;
+        }
+        if (m_busy) {
+            m_stats.triggersIgnored++;
+            return false;
+        }
+        m_stats.triggers++;
+        m_busy = true;
+
+        // Freeze what is buffered, the ring starts over with fresh slots
+        m_capture = Window();
+        m_capture.frames.reserve(m_ring.size() + qMax(0, m_config.postTriggerFrames));
+        for (Slot &slot : m_ring) {
+            m_capture.frames.push_back(std::move(slot));
+        }
+        m_ring.clear();
+        m_capture.preTriggerFrames = static_cast<int>(m_capture.frames.size());
+        m_capture.reason = reason;
+        m_capture.number = m_stats.triggers;
+        m_capture.triggerMsecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+        preTriggerFrames = m_capture.preTriggerFrames;
+
+        m_postRemaining = m_config.postTriggerFrames;
+        if (m_postRemaining > 0) {
+            m_capturing = true;
+        } else {
+            m_pending.push_back(std::move(m_capture));
+            m_capture = Window();
+            ready = true;
+        }
+    }
+
+    if (ready) {
+        m_dumpReady.notify_one();
+    }
+    qDebug() << "[PreTriggerBuffer] Triggered by" << reason << "with" << preTriggerFrames << "frames buffered";
+    return true;
+}
+
+PreTriggerBuffer::Stats PreTriggerBuffer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.enabled = m_enabled;
+    stats.busy = m_busy;
+    stats.bufferedFrames = static_cast<int>(m_ring.size());
+    stats.depthFrames = depthFor(m_frameBytes);
+    stats.memoryBytes = m_memoryBytes;
+    return stats;
+}
+
+int PreTriggerBuffer::depthFor(size_t frameBytes) const
+{
+    int depth = qMax(0, m_config.preTriggerFrames);
+    if (m_config.maxBytes > 0 && frameBytes > 0) {
+        const qint64 slotBytes = static_cast<qint64>(roundUp(frameBytes, RawSequence::BLOCK_SIZE));
+        depth = static_cast<int>(qMin<qint64>(depth, m_config.maxBytes / slotBytes));
+    }
+    return depth;
+}
+
+void PreTriggerBuffer::releaseSlots(std::vector<Slot> &list, size_t keep)
+{
+    while (list.size() > keep) {
+        m_memoryBytes -= list.back().bytes;
+        list.pop_back();
+    }
+}
+
+void PreTriggerBuffer::dumpLoop()
+{
+    for (;;) {
+        Window window;
+        QString path;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_dumpReady.wait(lock, [this]() { return !m_pending.empty() || m_stop; });
+
+            if (m_pending.empty()) {
+                break;
+            }
+
+            window = std::move(m_pending.front());
+            m_pending.pop_front();
+            path = m_config.path;
+        }
+
+        const QString filePath = QString("%1/pretrigger_%2_%3.bseq")
+                                 .arg(path, QDateTime::fromMSecsSinceEpoch(window.triggerMsecsSinceEpoch)
+                                                .toString("yyyyMMdd_HHmmss_zzz"))
+                                 .arg(window.number, 3, 10, QChar('0'));
+        size_t bytes = 0;
+        for (const Slot &slot : window.frames) {
+            bytes += RawSequence::payloadSize(slot.frame);
+        }
+
+        QString message;
+        const int64_t start = FrameHandle::currentTimestampNs();
+        const bool success = writeWindow(window, filePath, message);
+        const double seconds = (FrameHandle::currentTimestampNs() - start) / 1e9;
+        const int frameCount = static_cast<int>(window.frames.size());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (success) {
+                m_stats.dumpsCompleted++;
+            } else {
+                m_stats.dumpsFailed++;
+            }
+            m_stats.lastDumpFrames = frameCount;
+            m_stats.lastDumpMBps = (seconds > 0.0) ? bytes / 1e6 / seconds : 0.0;
+            m_stats.lastDumpFile = filePath;
+
+            // Back to the free list, keeping only what the ring and the next window can use
+            for (Slot &slot : window.frames) {
+                slot.frame = FrameHandle();
+                m_free.push_back(std::move(slot));
+            }
+            window.frames.clear();
+            const size_t needed = static_cast<size_t>(depthFor(m_frameBytes) + qMax(0, m_config.postTriggerFrames));
+            releaseSlots(m_free, m_enabled && needed > m_ring.size() ? needed - m_ring.size() : 0);
+            m_busy = m_capturing || !m_pending.empty();
+        }
+
+        qDebug() << "[PreTriggerBuffer]" << (success ? "Wrote" : "Failed to write") << filePath << message
+                 << QString("(%1 MB/s)").arg(bytes / 1e6 / qMax(seconds, 1e-9), 0, 'f', 1);
+        emit dumpFinished(filePath, frameCount, success, message);
+    }
+}
+
+bool PreTriggerBuffer::writeWindow(const Window &window, const QString &filePath, QString &message)
+{
+    if (window.frames.empty()) {
+        message = "No frames buffered";
+        return false;
+    }
+
+    QDir dir(QFileInfo(filePath).absolutePath());
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    RawSequenceWriter writer;
+    if (!writer.open(filePath, window.frames.front().frame, window.frames.size(), m_timestampTickFrequency, message)) {
+        return false;
+    }
+
+    // The window is written in one go, frames of another size (format change) are left out
+    int mismatched = 0;
+    for (const Slot &slot : window.frames) {
+        if (!writer.matches(slot.frame)) {
+            mismatched++;
+            continue;
+        }
+        const double exposureTime = slot.frame.exposureTime() > 0.0 ? slot.frame.exposureTime() : m_exposureTime.load();
+        if (!writer.append(slot.frame, exposureTime, message)) {
+            qDebug() << "[PreTriggerBuffer]" << message;
+        }
+    }
+    if (!writer.close(message)) {
+        return false;
+    }
+
+    // What happened and where in the sequence, next to the frames
+    QFile note(QFileInfo(filePath).path() + "/" + QFileInfo(filePath).completeBaseName() + ".txt");
+    if (note.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream out(&note);
+        out << "reason: " << window.reason << "\n";
+        out << "trigger_time: " << QDateTime::fromMSecsSinceEpoch(window.triggerMsecsSinceEpoch).toString(Qt::ISODateWithMs) << "\n";
+        out << "pre_trigger_frames: " << window.preTriggerFrames << "\n";
+        out << "post_trigger_frames: " << static_cast<int>(window.frames.size()) - window.preTriggerFrames << "\n";
+        out << "frames_written: " << writer.framesWritten() << "\n";
+        out << "frames_skipped: " << mismatched << "\n";
+    }
+
+    message = QString("%1 frames, %2 before the trigger").arg(writer.framesWritten()).arg(window.preTriggerFrames);
+    return writer.framesFailed() == 0;
+}
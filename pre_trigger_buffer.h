@@ -0,0 +1,133 @@
+#ifndef PRE_TRIGGER_BUFFER_H
+#define PRE_TRIGGER_BUFFER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "frame_handle.h"
+
+// In-memory ring of the most recent frames for event-triggered capture.
+//
+// push() is called by the grab thread and copies each frame into a slot of
+// its own, so the ring never holds on to Pylon grab buffers. Slots are
+// page-aligned and recycled, allocation only happens while the ring fills
+// or the frame size grows. trigger() freezes the frames in the ring, keeps
+// the next postTriggerFrames frames with them and hands the window to a
+// dump thread that writes it as a .bseq file (RawSequenceWriter) with a
+// .txt note beside it, while the ring fills up again. One window is
+// captured or written at a time, triggers in the meantime are ignored and
+// counted.
+class PreTriggerBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int preTriggerFrames = 100;      // Frames kept before the event
+        int postTriggerFrames = 20;      // Frames added after it
+        qint64 maxBytes = 0;             // Limits the pre-trigger frames by memory, 0 = no limit
+        QString path = "./pretrigger";
+        bool triggerOnSoftwareTrigger = true;
+    };
+
+    struct Stats
+    {
+        bool enabled = false;
+        bool busy = false;               // A window is being captured or written
+        int bufferedFrames = 0;
+        int depthFrames = 0;             // Pre-trigger frames at the current frame size
+        qint64 memoryBytes = 0;          // All slots, including a window being written
+        quint64 triggers = 0;
+        quint64 triggersIgnored = 0;
+        quint64 dumpsCompleted = 0;
+        quint64 dumpsFailed = 0;
+        int lastDumpFrames = 0;
+        double lastDumpMBps = 0.0;
+        QString lastDumpFile;
+    };
+
+    explicit PreTriggerBuffer(QObject *parent = nullptr);
+    ~PreTriggerBuffer();
+
+    // Shrinking the depth releases the slots that are no longer needed
+    void setConfig(const Config &config);
+    Config getConfig() const;
+
+    // Disabling drops the buffered frames, a window being captured is written
+    // with the frames it has
+    void setEnabled(bool enable);
+    bool isEnabled() const { return m_enabled; }
+
+    // Called from the grab thread
+    void push(const FrameHandle &frame);
+
+    // Thread-safe, for the GUI, the software trigger or an analysis result.
+    // Returns false if disabled or a window is still in progress.
+    bool trigger(const QString &reason);
+
+    // Stored in the dump files, like FrameRecorder
+    void setExposureTime(double exposureTimeUs) { m_exposureTime = exposureTimeUs; }
+    void setTimestampTickFrequency(double frequency) { m_timestampTickFrequency = frequency; }
+
+    Stats getStats() const;
+
+signals:
+    // From the dump thread
+    void dumpFinished(const QString &filePath, int frames, bool success, const QString &message);
+
+private:
+    struct FreeDeleter { void operator()(void *p) const; };
+
+    struct Slot
+    {
+        std::unique_ptr<uint8_t, FreeDeleter> memory;
+        size_t bytes = 0;
+        FrameHandle frame;               // Views memory
+    };
+
+    struct Window
+    {
+        std::vector<Slot> frames;
+        int preTriggerFrames = 0;
+        QString reason;
+        quint64 number = 0;              // Trigger count, keeps file names apart
+        qint64 triggerMsecsSinceEpoch = 0;
+    };
+
+    int depthFor(size_t frameBytes) const;
+    void releaseSlots(std::vector<Slot> &list, size_t keep);
+    void dumpLoop();
+    bool writeWindow(const Window &window, const QString &filePath, QString &message);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_dumpReady;
+    std::thread m_dumpThread;
+    bool m_stop;
+
+    // Guarded by m_mutex
+    Config m_config;
+    std::deque<Slot> m_ring;
+    std::vector<Slot> m_free;
+    Window m_capture;
+    int m_postRemaining;             // Frames still to add to m_capture
+    bool m_capturing;
+    bool m_busy;                     // From trigger() until the window is written
+    std::deque<Window> m_pending;
+    size_t m_frameBytes;             // Size of the last frame pushed
+    Stats m_stats;
+
+    std::atomic<bool> m_enabled;
+    std::atomic<qint64> m_memoryBytes;
+    std::atomic<double> m_exposureTime;
+    std::atomic<double> m_timestampTickFrequency;
+};
+
+#endif // PRE_TRIGGER_BUFFER_H
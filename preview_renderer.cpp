@@ -0,0 +1,329 @@
+#include "preview_renderer.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PREVIEW_RENDERER_X86 1
+#endif
+
+// Bytes per pixel of the formats reduce() handles, 0 for the others
+static int bytesPerPixel(QImage::Format format)
+{
+    switch (format) {
+        case QImage::Format_Grayscale8:
+        case QImage::Format_Alpha8:
+            return 1;
+        case QImage::Format_RGB888:
+        case QImage::Format_BGR888:
+            return 3;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_RGBX8888:
+        case QImage::Format_RGBA8888:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+// sums[i] += row[i], the column sums of one block row
+static void accumulateRowScalar(uint16_t *sums, const uint8_t *row, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        sums[i] = static_cast<uint16_t>(sums[i] + row[i]);
+    }
+}
+
+#ifdef PREVIEW_RENDERER_X86
+
+__attribute__((target("sse4.1")))
+static void accumulateRowSse41(uint16_t *sums, const uint8_t *row, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i)));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), _mm_add_epi16(s, v));
+    }
+    accumulateRowScalar(sums + i, row + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void accumulateRowAvx2(uint16_t *sums, const uint8_t *row, int count)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + i), _mm256_add_epi16(s, v));
+    }
+    accumulateRowScalar(sums + i, row + i, count - i);
+}
+
+#endif
+
+typedef void (*AccumulateRow)(uint16_t *sums, const uint8_t *row, int count);
+
+static AccumulateRow selectAccumulateRow()
+{
+#ifdef PREVIEW_RENDERER_X86
+    switch (MonoDisplayMapper::detectSimdLevel()) {
+        case MonoDisplayMapper::SimdAvx2:
+            return accumulateRowAvx2;
+        case MonoDisplayMapper::SimdSse41:
+            return accumulateRowSse41;
+        default:
+            break;
+    }
+#endif
+    return accumulateRowScalar;
+}
+
+PreviewRenderer::PreviewRenderer(QObject *parent)
+    : QObject(parent)
+    , m_thread(nullptr)
+    , m_running(false)
+    , m_dirty(false)
+    , m_rendering(false)
+{
+}
+
+PreviewRenderer::~PreviewRenderer()
+{
+    stop();
+}
+
+void PreviewRenderer::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_thread = new std::thread(&PreviewRenderer::renderLoop, this);
+    qDebug() << "[PreviewRenderer] Started";
+}
+
+void PreviewRenderer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_pending.notify_all();
+
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
+    delete m_thread;
+    m_thread = nullptr;
+
+    qDebug() << "[PreviewRenderer] Stopped";
+}
+
+void PreviewRenderer::submit(const FrameHandle &frame)
+{
+    if (frame.isEmpty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // The display may ask again before the camera delivers a new frame
+        if (frame.frameId() == m_frame.frameId() && frame.timestampNs() == m_frame.timestampNs()) {
+            return;
+        }
+        m_frame = frame;
+        m_dirty = true;
+    }
+    m_pending.notify_one();
+}
+
+void PreviewRenderer::setTargetSize(const QSize &size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (size == m_targetSize) {
+            return;
+        }
+        m_targetSize = size;
+        m_dirty = !m_frame.isEmpty();
+    }
+    m_pending.notify_one();
+}
+
+QSize PreviewRenderer::getTargetSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_targetSize;
+}
+
+void PreviewRenderer::setSettings(const Settings &settings)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_settings = settings;
+        m_dirty = !m_frame.isEmpty();
+    }
+    m_pending.notify_one();
+}
+
+PreviewRenderer::Settings PreviewRenderer::getSettings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_settings;
+}
+
+void PreviewRenderer::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_frame = FrameHandle();
+    m_dirty = false;
+    m_idle.wait(lock, [this]() { return !m_rendering; });
+}
+
+const char* PreviewRenderer::qualityName(Quality quality)
+{
+    switch (quality) {
+        case QualityFast:     return "Fast (decimate)";
+        case QualityBalanced: return "Balanced (area average)";
+        default:              return "Smooth (area average + bilinear)";
+    }
+}
+
+void PreviewRenderer::renderLoop()
+{
+    for (;;) {
+        FrameHandle frame;
+        QSize targetSize;
+        Settings settings;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_pending.wait(lock, [this]() { return m_dirty || !m_running; });
+
+            if (!m_running) {
+                break;
+            }
+
+            frame = m_frame;
+            targetSize = m_targetSize;
+            settings = m_settings;
+            m_dirty = false;
+            m_rendering = true;
+        }
+
+        const qint64 start = FrameHandle::currentTimestampNs();
+        QImage image = render(frame, targetSize, settings);
+        const qint64 convertNs = FrameHandle::currentTimestampNs() - start;
+        const qint64 frameId = frame.frameId();
+        const qint64 timestampNs = frame.timestampNs();
+
+        // The image owns its pixels, the grab buffer can go before clear() returns
+        frame = FrameHandle();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rendering = false;
+        }
+        m_idle.notify_all();
+
+        if (!image.isNull()) {
+            emit previewReady(image, frameId, timestampNs, convertNs);
+        }
+    }
+}
+
+QImage PreviewRenderer::render(const FrameHandle &frame, const QSize &targetSize, const Settings &settings)
+{
+    // Deep mono frames go through the window/level mapping, the mapper is only
+    // rebuilt when the bit depth or the settings change
+    if (frame.bitDepth() > 8) {
+        const int maxValue = (1 << frame.bitDepth()) - 1;
+        if (settings.fullRange) {
+            m_mapper.configure(frame.bitDepth(), 0, maxValue, settings.gamma);
+        } else {
+            m_mapper.configure(frame.bitDepth(), settings.windowLow, settings.windowHigh, settings.gamma);
+        }
+    }
+
+    QImage image = frame.toQImage(m_mapper, settings.whiteBalance, settings.bayerFullResolution);
+    if (image.isNull() || targetSize.width() <= 0 || targetSize.height() <= 0) {
+        return QImage();
+    }
+
+    // Largest integer reduction that still leaves at least the fitted size
+    const int factor = std::min(image.width() / targetSize.width(), image.height() / targetSize.height());
+    if (factor > 1) {
+        image = reduce(image, factor, settings.quality != QualityFast);
+    }
+
+    image = image.scaled(targetSize, Qt::KeepAspectRatio,
+                         settings.quality == QualitySmooth ? Qt::SmoothTransformation : Qt::FastTransformation);
+
+    // Mono8 and RGB/BGR8 previews may still wrap the frame buffer, which is
+    // released once this frame is replaced
+    if (image.constBits() == frame.image().data) {
+        image = image.copy();
+    }
+    return image;
+}
+
+QImage PreviewRenderer::reduce(const QImage &image, int factor, bool average)
+{
+    const int bpp = bytesPerPixel(image.format());
+    factor = std::min(factor, static_cast<int>(MAX_REDUCE_FACTOR));
+    const int outWidth = image.width() / std::max(1, factor);
+    const int outHeight = image.height() / std::max(1, factor);
+
+    if (bpp == 0 || factor <= 1 || outWidth <= 0 || outHeight <= 0) {
+        return image;
+    }
+
+    QImage out(outWidth, outHeight, image.format());
+
+    if (!average) {
+        for (int y = 0; y < outHeight; ++y) {
+            const uint8_t *row = image.constScanLine(y * factor);
+            uint8_t *dst = out.scanLine(y);
+            for (int x = 0; x < outWidth; ++x) {
+                std::memcpy(dst + x * bpp, row + static_cast<size_t>(x) * factor * bpp, bpp);
+            }
+        }
+        return out;
+    }
+
+    static const AccumulateRow accumulateRow = selectAccumulateRow();
+
+    // Sum each block's rows into 16-bit column sums (factor * 255 fits), then
+    // add up factor columns per output pixel and divide with rounding
+    const int count = outWidth * factor * bpp;
+    const unsigned area = static_cast<unsigned>(factor * factor);
+    std::vector<uint16_t> sums(count);
+
+    for (int y = 0; y < outHeight; ++y) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int k = 0; k < factor; ++k) {
+            accumulateRow(sums.data(), image.constScanLine(y * factor + k), count);
+        }
+
+        uint8_t *dst = out.scanLine(y);
+        const uint16_t *block = sums.data();
+        for (int x = 0; x < outWidth; ++x, block += factor * bpp) {
+            for (int c = 0; c < bpp; ++c) {
+                unsigned sum = 0;
+                for (int j = 0; j < factor; ++j) {
+                    sum += block[j * bpp + c];
+                }
+                dst[x * bpp + c] = static_cast<uint8_t>((sum + area / 2) / area);
+            }
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,109 @@
+#ifndef PREVIEW_RENDERER_H
+#define PREVIEW_RENDERER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "frame_handle.h"
+#include "mono_display_mapper.h"
+#include "bayer_demosaic.h"
+
+// Renders display-sized preview images on a worker thread.
+//
+// submit() hands over the newest frame and returns at once; a frame that is
+// still waiting when the next one arrives is replaced, so the worker always
+// renders the latest frame. The worker converts the frame to 8 bits per
+// channel (window/level, demosaic), shrinks it by an integer factor to at
+// least the target size and fits the rest with QImage::scaled(), which is
+// cheap on the already reduced image. The GUI thread only receives
+// previewReady() with an image that is ready to blit.
+//
+// Changing the target size or the settings renders the last frame again.
+// That frame may wrap a grab buffer, so clear() has to drop it before the
+// frame source closes.
+class PreviewRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Quality {
+        QualityFast,      // Keep every Nth pixel, nearest-neighbour fit
+        QualityBalanced,  // Average NxN blocks, nearest-neighbour fit
+        QualitySmooth     // Average NxN blocks, bilinear fit
+    };
+
+    struct Settings
+    {
+        Quality quality = QualityBalanced;
+
+        // Mono10/12/16 window/level, raw sensor units
+        bool fullRange = true;
+        int windowLow = 0;
+        int windowHigh = 4095;
+        double gamma = 1.0;
+
+        // Bayer formats
+        BayerDemosaic::WhiteBalance whiteBalance;
+        bool bayerFullResolution = false;
+    };
+
+    explicit PreviewRenderer(QObject *parent = nullptr);
+    ~PreviewRenderer();
+
+    // Start the worker thread, stop() waits for it to exit
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Newest frame to preview, frames already rendered are ignored
+    void submit(const FrameHandle &frame);
+
+    // The preview keeps the aspect ratio and fits inside this size
+    void setTargetSize(const QSize &size);
+    QSize getTargetSize() const;
+    void setSettings(const Settings &settings);
+    Settings getSettings() const;
+
+    // Drops the last frame and waits for a render in progress, thread-safe
+    void clear();
+
+    static const char* qualityName(Quality quality);
+
+    // Shrink an 8-bit image (Grayscale8, RGB888, BGR888 and similar) by an
+    // integer factor in both directions: block averages, or every factor-th
+    // pixel when average is false. Other formats are returned unchanged.
+    static QImage reduce(const QImage &image, int factor, bool average);
+
+signals:
+    // Emitted from the worker thread. convertNs is the time spent rendering.
+    void previewReady(const QImage &image, qint64 frameId, qint64 timestampNs, qint64 convertNs);
+
+private:
+    void renderLoop();
+    QImage render(const FrameHandle &frame, const QSize &targetSize, const Settings &settings);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_pending;
+    std::condition_variable m_idle;    // m_rendering went false
+    std::thread* m_thread;
+    std::atomic<bool> m_running;
+
+    // Guarded by m_mutex
+    FrameHandle m_frame;          // Newest frame, kept to re-render on changes
+    bool m_dirty;                 // m_frame has not been rendered with the current settings
+    bool m_rendering;             // The worker holds a frame of its own
+    QSize m_targetSize;
+    Settings m_settings;
+
+    // Only used by the worker thread
+    MonoDisplayMapper m_mapper;
+
+    // Largest reduction factor, keeps the 16-bit column sums from overflowing
+    static const int MAX_REDUCE_FACTOR = 256;
+};
+
+#endif // PREVIEW_RENDERER_H
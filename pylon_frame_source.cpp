@@ -0,0 +1,456 @@
+#include "pylon_frame_source.h"
+#include <QDebug>
+#include <algorithm>
+
+using namespace Pylon;
+
+PylonFrameSource::PylonFrameSource(DeviceType type, const QString &ipAddress)
+    : m_type(type)
+    , m_ipAddress(ipAddress)
+    , m_camera(nullptr)
+    , m_bufferFactory(nullptr)
+    , m_wakeUp(WaitObjectEx::Create())
+    , m_imageHandler(nullptr)
+    , m_skippedFrames(0)
+    , m_upcomingImage(false)
+    , m_tickFrequency(0.0)
+{
+}
+
+PylonFrameSource::~PylonFrameSource()
+{
+    close();
+}
+
+bool PylonFrameSource::open(QString &error)
+{
+    if (m_camera) {
+        return true;
+    }
+
+    try {
+        CDeviceInfo targetDevice;
+        bool found = (m_type == DeviceEmulator) ? findEmulatorDevice(targetDevice, error)
+                                                : findGigEDevice(targetDevice, error);
+        if (!found) {
+            return false;
+        }
+
+        // Create camera object with specific device
+        m_camera = new CInstantCamera(CTlFactory::GetInstance().CreateDevice(targetDevice));
+        qDebug() << "[PylonFrameSource] Camera created successfully";
+
+        // Grab buffers come from our preallocated pool, laid out in startGrabbing()
+        m_bufferFactory = new PooledBufferFactory();
+        m_camera->SetBufferFactory(m_bufferFactory, Cleanup_None);
+
+        // Get camera information
+        try {
+            CDeviceInfo deviceInfo = m_camera->GetDeviceInfo();
+            m_name = QString::fromUtf8(deviceInfo.GetFriendlyName().c_str());
+            m_model = QString::fromUtf8(deviceInfo.GetModelName().c_str());
+            m_serial = QString::fromUtf8(deviceInfo.GetSerialNumber().c_str());
+
+            qDebug() << "[PylonFrameSource] Camera Name:" << m_name;
+            qDebug() << "[PylonFrameSource] Camera Model:" << m_model;
+            qDebug() << "[PylonFrameSource] Camera Serial:" << m_serial;
+        }
+        catch (const GenericException& e) {
+            qDebug() << "[PylonFrameSource] Error getting camera info:" << e.GetDescription();
+        }
+
+        // Open camera
+        m_camera->Open();
+        qDebug() << "[PylonFrameSource] Camera opened successfully";
+
+        // GigE cameras state their tick rate, USB3 and newer GigE cameras count nanoseconds
+        m_tickFrequency = 1e9;
+        CIntegerParameter tickFrequency(m_camera->GetNodeMap(), "GevTimestampTickFrequency");
+        if (tickFrequency.IsReadable() && tickFrequency.GetValue() > 0) {
+            m_tickFrequency = static_cast<double>(tickFrequency.GetValue());
+        }
+        qDebug() << "[PylonFrameSource] Timestamp tick frequency:" << m_tickFrequency;
+        return true;
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[PylonFrameSource] Error opening camera:" << e.GetDescription();
+        error = "Connection failed";
+        if (m_camera) {
+            delete m_camera;
+            m_camera = nullptr;
+        }
+        if (m_bufferFactory) {
+            m_bufferFactory->release();
+            m_bufferFactory = nullptr;
+        }
+        return false;
+    }
+}
+
+bool PylonFrameSource::findGigEDevice(CDeviceInfo &targetDevice, QString &error)
+{
+    DeviceInfoList_t allDevices;
+    CTlFactory::GetInstance().EnumerateDevices(allDevices);
+
+    qDebug() << "[PylonFrameSource] Total devices found:" << allDevices.size();
+
+    // Check all devices for IP address and find specific IP camera
+    size_t gigeDeviceCount = 0;
+    bool foundTargetCamera = false;
+
+    for (const auto& deviceInfo : allDevices) {
+        qDebug() << "[PylonFrameSource] Found device:"
+                 << QString::fromUtf8(deviceInfo.GetFriendlyName().c_str())
+                 << "Device Class:" << deviceInfo.GetDeviceClass();
+
+        if (deviceInfo.GetDeviceClass() == BaslerGigEDeviceClass) {
+            gigeDeviceCount++;
+        }
+
+        // Non-GigE devices may expose an IP address as well
+        try {
+            QString deviceIP = QString::fromUtf8(deviceInfo.GetIpAddress().c_str());
+            if (!deviceIP.isEmpty()) {
+                qDebug() << "[PylonFrameSource] Device IP:" << deviceIP;
+            }
+
+            if (!foundTargetCamera && m_serialFilter.isEmpty() && deviceIP == m_ipAddress) {
+                targetDevice = deviceInfo;
+                foundTargetCamera = true;
+                qDebug() << "[PylonFrameSource] Found target camera at IP" << m_ipAddress;
+            }
+        }
+        catch (const GenericException& e) {
+            // IP address not available for this device type
+        }
+
+        if (!foundTargetCamera && !m_serialFilter.isEmpty()
+            && QString::fromUtf8(deviceInfo.GetSerialNumber().c_str()) == m_serialFilter) {
+            targetDevice = deviceInfo;
+            foundTargetCamera = true;
+            qDebug() << "[PylonFrameSource] Found target camera with serial" << m_serialFilter;
+        }
+    }
+
+    if (gigeDeviceCount == 0) {
+        qDebug() << "[PylonFrameSource] No GigE camera found!";
+        error = "No camera found";
+        return false;
+    }
+
+    qDebug() << "[PylonFrameSource] Found" << gigeDeviceCount << "GigE camera(s)";
+
+    if (!foundTargetCamera) {
+        qDebug() << "[PylonFrameSource] Target camera ("
+                 << (m_serialFilter.isEmpty() ? m_ipAddress : m_serialFilter) << ") not found!";
+        error = "Target camera not found";
+        return false;
+    }
+
+    return true;
+}
+
+bool PylonFrameSource::findEmulatorDevice(CDeviceInfo &targetDevice, QString &error)
+{
+    DeviceInfoList_t emulatorDevices;
+    CDeviceInfo filter;
+    filter.SetDeviceClass(BaslerCamEmuDeviceClass);
+
+    DeviceInfoList_t filters;
+    filters.push_back(filter);
+
+    if (CTlFactory::GetInstance().EnumerateDevices(emulatorDevices, filters) == 0) {
+        qDebug() << "[PylonFrameSource] No camera emulator found, is PYLON_CAMEMU set?";
+        error = "No camera emulator found";
+        return false;
+    }
+
+    qDebug() << "[PylonFrameSource] Found" << emulatorDevices.size() << "emulated camera(s)";
+    if (m_serialFilter.isEmpty()) {
+        targetDevice = emulatorDevices[0];
+        return true;
+    }
+
+    for (const auto& deviceInfo : emulatorDevices) {
+        if (QString::fromUtf8(deviceInfo.GetSerialNumber().c_str()) == m_serialFilter) {
+            targetDevice = deviceInfo;
+            return true;
+        }
+    }
+
+    qDebug() << "[PylonFrameSource] Emulated camera" << m_serialFilter << "not found!";
+    error = "Target camera not found";
+    return false;
+}
+
+void PylonFrameSource::close()
+{
+    // Give the held buffer back before the camera goes away
+    m_grabResult.Release();
+    m_waitObjects.RemoveAll();
+
+    if (m_camera) {
+        try {
+            if (m_camera->IsOpen()) {
+                m_camera->Close();
+            }
+        }
+        catch (const GenericException& e) {
+            qDebug() << "[PylonFrameSource] Error closing camera:" << e.GetDescription();
+        }
+        if (m_imageHandler) {
+            m_camera->DeregisterImageEventHandler(m_imageHandler);
+        }
+        delete m_camera;
+        m_camera = nullptr;
+    }
+    delete m_imageHandler;
+    m_imageHandler = nullptr;
+
+    // Frames elsewhere may still hold grab buffers, the factory stays until they are freed
+    if (m_bufferFactory) {
+        m_bufferFactory->release();
+        m_bufferFactory = nullptr;
+    }
+}
+
+bool PylonFrameSource::isOpen() const
+{
+    return m_camera && m_camera->IsOpen();
+}
+
+QList<PylonFrameSource::DeviceEntry> PylonFrameSource::enumerateDevices(DeviceType type)
+{
+    QList<DeviceEntry> entries;
+
+    try {
+        CDeviceInfo filter;
+        filter.SetDeviceClass(type == DeviceEmulator ? BaslerCamEmuDeviceClass : BaslerGigEDeviceClass);
+        DeviceInfoList_t filters;
+        filters.push_back(filter);
+
+        DeviceInfoList_t devices;
+        CTlFactory::GetInstance().EnumerateDevices(devices, filters);
+
+        for (const auto& deviceInfo : devices) {
+            DeviceEntry entry;
+            entry.serial = QString::fromUtf8(deviceInfo.GetSerialNumber().c_str());
+            entry.model = QString::fromUtf8(deviceInfo.GetModelName().c_str());
+            entry.name = QString::fromUtf8(deviceInfo.GetFriendlyName().c_str());
+            if (type == DeviceGigE) {
+                entry.ipAddress = QString::fromUtf8(deviceInfo.GetIpAddress().c_str());
+            }
+            entries.append(entry);
+        }
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[PylonFrameSource] Error enumerating devices:" << e.GetDescription();
+    }
+
+    return entries;
+}
+
+size_t PylonFrameSource::computeBufferSize() const
+{
+    GenApi::INodeMap& nodeMap = m_camera->GetNodeMap();
+
+    CIntegerParameter widthParam(nodeMap, "Width");
+    CIntegerParameter heightParam(nodeMap, "Height");
+    CEnumParameter pixelFormatParam(nodeMap, "PixelFormat");
+
+    EPixelType pixelType = CPixelTypeMapper::GetPylonPixelTypeByName(pixelFormatParam.GetValue().c_str());
+    size_t bits = static_cast<size_t>(widthParam.GetValue()) * heightParam.GetValue() * BitPerPixel(pixelType);
+    size_t size = (bits + 7) / 8;
+
+    // Chunk data or row padding can make the payload larger than the image
+    CIntegerParameter payloadParam(nodeMap, "PayloadSize");
+    if (payloadParam.IsReadable()) {
+        size = std::max(size, static_cast<size_t>(payloadParam.GetValue()));
+    }
+
+    return size;
+}
+
+static EGrabStrategy pylonGrabStrategy(IFrameSource::GrabStrategy strategy)
+{
+    switch (strategy) {
+        case IFrameSource::GrabLatestImageOnly: return GrabStrategy_LatestImageOnly;
+        case IFrameSource::GrabLatestImages:    return GrabStrategy_LatestImages;
+        case IFrameSource::GrabUpcomingImage:   return GrabStrategy_UpcomingImage;
+        default:                                return GrabStrategy_OneByOne;
+    }
+}
+
+void PylonFrameSource::prepareGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition)
+{
+    size_t bufferSize = bufferConfig.size > 0 ? bufferConfig.size : computeBufferSize();
+
+    if (!m_bufferFactory->preallocate(bufferSize, bufferConfig.count, bufferConfig.hugePages, bufferConfig.lockMemory)) {
+        qDebug() << "[PylonFrameSource] Buffer pool allocation failed, buffers come from the heap";
+    }
+
+    m_camera->MaxNumBuffer.SetValue(bufferConfig.count);
+    if (acquisition.strategy == GrabLatestImages) {
+        // The output queue cannot hold more frames than there are buffers
+        m_camera->OutputQueueSize.SetValue(qBound(1, acquisition.queueSize, bufferConfig.count));
+    }
+
+    m_skippedFrames = 0;
+    m_wakeUp.Reset();
+}
+
+void PylonFrameSource::startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition)
+{
+    prepareGrabbing(bufferConfig, acquisition);
+
+    m_waitObjects.RemoveAll();
+    m_waitObjects.Add(m_camera->GetGrabResultWaitObject());
+    m_waitObjects.Add(m_wakeUp);
+
+    m_upcomingImage = (acquisition.strategy == GrabUpcomingImage);
+    m_camera->StartGrabbing(pylonGrabStrategy(acquisition.strategy), GrabLoop_ProvidedByUser);
+    qDebug() << "[PylonFrameSource] Polling with" << grabStrategyName(acquisition.strategy);
+}
+
+bool PylonFrameSource::startGrabbingEventDriven(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition,
+                                                FrameCallback callback)
+{
+    // UpcomingImage queues a buffer per retrieve call, which only makes sense
+    // when the caller decides when to wait
+    if (acquisition.strategy == GrabUpcomingImage || !callback) {
+        return false;
+    }
+
+    prepareGrabbing(bufferConfig, acquisition);
+
+    if (!m_imageHandler) {
+        m_imageHandler = new ImageHandler(this);
+    }
+    m_frameCallback = callback;
+    m_upcomingImage = false;
+    m_camera->RegisterImageEventHandler(m_imageHandler, RegistrationMode_ReplaceAll, Cleanup_None);
+
+    try {
+        m_camera->StartGrabbing(pylonGrabStrategy(acquisition.strategy), GrabLoop_ProvidedByInstantCamera);
+    }
+    catch (const GenericException&) {
+        m_camera->DeregisterImageEventHandler(m_imageHandler);
+        m_frameCallback = FrameCallback();
+        throw;
+    }
+
+    qDebug() << "[PylonFrameSource] Event-driven with" << grabStrategyName(acquisition.strategy);
+    return true;
+}
+
+QString PylonFrameSource::getBufferInfo() const
+{
+    return m_bufferFactory ? m_bufferFactory->describe() : QString();
+}
+
+void PylonFrameSource::stopGrabbing()
+{
+    // Waits for the grab loop thread, no callback runs after this
+    m_camera->StopGrabbing();
+
+    if (m_frameCallback) {
+        m_camera->DeregisterImageEventHandler(m_imageHandler);
+        m_frameCallback = FrameCallback();
+    }
+}
+
+void PylonFrameSource::interruptRetrieve()
+{
+    m_wakeUp.Signal();
+}
+
+IFrameSource::RetrieveStatus PylonFrameSource::retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error)
+{
+    // UpcomingImage only queues a buffer inside RetrieveResult(), the wait object
+    // would never be signalled before it. interruptRetrieve() cannot cut this
+    // wait short, it ends with the timeout.
+    if (m_upcomingImage) {
+        if (!m_camera->RetrieveResult(timeoutMs, m_grabResult, TimeoutHandling_Return)) {
+            return RetrieveTimeout;
+        }
+        return convertResult(m_grabResult, frame, error);
+    }
+
+    // Timing out is normal, being woken up by interruptRetrieve() looks the same
+    unsigned int index = 0;
+    if (!m_waitObjects.WaitForAny(timeoutMs, &index)) {
+        return RetrieveTimeout;
+    }
+    if (index != 0) {
+        m_wakeUp.Reset();
+        return RetrieveTimeout;
+    }
+
+    if (!m_camera->RetrieveResult(0, m_grabResult, TimeoutHandling_Return)) {
+        return RetrieveTimeout;
+    }
+
+    return convertResult(m_grabResult, frame, error);
+}
+
+IFrameSource::RetrieveStatus PylonFrameSource::convertResult(const CGrabResultPtr &grabResult, FrameHandle &frame,
+                                                             QString &error)
+{
+    // Frames the strategy dropped in favour of this one
+    m_skippedFrames += grabResult->GetNumberOfSkippedImages();
+
+    if (!grabResult->GrabSucceeded()) {
+        error = QString::fromUtf8(grabResult->GetErrorDescription().c_str());
+        return RetrieveFailed;
+    }
+
+    // Wrap the grab buffer without copying it
+    frame = FrameHandle::fromGrabResult(grabResult);
+    if (frame.isEmpty()) {
+        error = QString("Unsupported pixel format %1").arg(grabResult->GetPixelType());
+        return RetrieveFailed;
+    }
+    return RetrieveOk;
+}
+
+bool PylonFrameSource::latchTimestamp(uint64_t &ticks, int64_t &hostNs)
+{
+    if (!m_camera || !m_camera->IsOpen()) {
+        return false;
+    }
+
+    try {
+        // SFNC name first, then the GigE Vision one of older cameras
+        CCommandParameter latch(m_camera->GetNodeMap(), "TimestampLatch");
+        CIntegerParameter value(m_camera->GetNodeMap(), "TimestampLatchValue");
+        if (!latch.IsWritable()) {
+            latch = CCommandParameter(m_camera->GetNodeMap(), "GevTimestampControlLatch");
+            value = CIntegerParameter(m_camera->GetNodeMap(), "GevTimestampValue");
+        }
+        if (!latch.IsWritable() || !value.IsReadable()) {
+            return false;
+        }
+
+        // The camera latched somewhere within the round trip, take the middle
+        const int64_t before = FrameHandle::currentTimestampNs();
+        latch.Execute();
+        const int64_t after = FrameHandle::currentTimestampNs();
+        ticks = static_cast<uint64_t>(value.GetValue());
+        hostNs = before + (after - before) / 2;
+        return true;
+    }
+    catch (const GenericException& e) {
+        qDebug() << "[PylonFrameSource] Cannot latch timestamp:" << e.GetDescription();
+        return false;
+    }
+}
+
+void PylonFrameSource::ImageHandler::OnImageGrabbed(CInstantCamera &camera, const CGrabResultPtr &grabResult)
+{
+    Q_UNUSED(camera);
+
+    FrameHandle frame;
+    QString error;
+    RetrieveStatus status = m_source->convertResult(grabResult, frame, error);
+    m_source->m_frameCallback(status, frame, error);
+}
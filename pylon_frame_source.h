@@ -0,0 +1,102 @@
+#ifndef PYLON_FRAME_SOURCE_H
+#define PYLON_FRAME_SOURCE_H
+
+#include <QList>
+#include <atomic>
+#include "frame_source.h"
+#include "pooled_buffer_factory.h"
+
+// Frame source backed by a Pylon CInstantCamera.
+//
+// DeviceGigE opens the GigE camera with the given IP address.
+// DeviceEmulator opens the first Pylon camera emulator device; the emulator
+// transport layer only lists devices when PYLON_CAMEMU is set before
+// PylonInitialize() (BaslerCamera takes care of that), PYLON_CAMEMU=N lists N.
+// With a serial number set, the device with that serial is opened instead.
+class PylonFrameSource : public IFrameSource
+{
+public:
+    enum DeviceType {
+        DeviceGigE,
+        DeviceEmulator
+    };
+
+    // One enumerated device
+    struct DeviceEntry
+    {
+        QString serial;
+        QString model;
+        QString name;
+        QString ipAddress;   // Empty for the emulator
+    };
+
+    PylonFrameSource(DeviceType type, const QString &ipAddress);
+    ~PylonFrameSource();
+
+    // Select the device by serial number, empty selects by type as above
+    void setSerialNumber(const QString &serial) { m_serialFilter = serial; }
+
+    // Devices of the given type that are currently visible
+    static QList<DeviceEntry> enumerateDevices(DeviceType type);
+
+    bool open(QString &error) override;
+    void close() override;
+    bool isOpen() const override;
+
+    QString getName() const override { return m_name; }
+    QString getModel() const override { return m_model; }
+    QString getSerial() const override { return m_serial; }
+
+    Pylon::CInstantCamera* getCamera() override { return m_camera; }
+
+    void startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition) override;
+    void stopGrabbing() override;
+    RetrieveStatus retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error) override;
+    void interruptRetrieve() override;
+    bool startGrabbingEventDriven(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition,
+                                  FrameCallback callback) override;
+    quint64 getSkippedFrameCount() const override { return m_skippedFrames; }
+    QString getBufferInfo() const override;
+    double getTimestampTickFrequency() const override { return m_tickFrequency; }
+    bool latchTimestamp(uint64_t &ticks, int64_t &hostNs) override;
+
+private:
+    class ImageHandler : public Pylon::CImageEventHandler
+    {
+    public:
+        explicit ImageHandler(PylonFrameSource *source) : m_source(source) {}
+        void OnImageGrabbed(Pylon::CInstantCamera &camera, const Pylon::CGrabResultPtr &grabResult) override;
+
+    private:
+        PylonFrameSource *m_source;
+    };
+
+    void prepareGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition);
+    RetrieveStatus convertResult(const Pylon::CGrabResultPtr &grabResult, FrameHandle &frame, QString &error);
+
+    bool findGigEDevice(Pylon::CDeviceInfo &targetDevice, QString &error);
+    bool findEmulatorDevice(Pylon::CDeviceInfo &targetDevice, QString &error);
+    size_t computeBufferSize() const;
+
+    DeviceType m_type;
+    QString m_ipAddress;
+    QString m_serialFilter;
+
+    Pylon::CInstantCamera* m_camera;
+    Pylon::CGrabResultPtr m_grabResult;
+    PooledBufferFactory* m_bufferFactory; // Released after m_camera, see PooledBufferFactory::release()
+
+    Pylon::WaitObjectEx m_wakeUp;         // Signalled by interruptRetrieve()
+    Pylon::WaitObjects m_waitObjects;     // Grab results and m_wakeUp
+    ImageHandler* m_imageHandler;         // Registered while grabbing event-driven
+    FrameCallback m_frameCallback;
+    std::atomic<quint64> m_skippedFrames;
+    bool m_upcomingImage;                 // Polling with GrabStrategy_UpcomingImage
+    double m_tickFrequency;               // Camera timestamp ticks per second
+
+    QString m_name;
+    QString m_model;
+    QString m_serial;
+};
+
+#endif // PYLON_FRAME_SOURCE_H
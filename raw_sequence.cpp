@@ -0,0 +1,512 @@
+#include "raw_sequence.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Headers are written as they are laid out in memory
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The .bseq format is little-endian"
+#endif
+
+using namespace RawSequence;
+
+static size_t roundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool isAligned(const void *pointer)
+{
+    return reinterpret_cast<uintptr_t>(pointer) % BLOCK_SIZE == 0;
+}
+
+size_t RawSequence::payloadSize(const FrameHandle &frame)
+{
+    const cv::Mat &image = frame.image();
+    return image.total() * image.elemSize();
+}
+
+size_t RawSequence::recordSize(size_t payloadSize)
+{
+    return BLOCK_SIZE + roundUp(payloadSize, BLOCK_SIZE);
+}
+
+void RawSequenceWriter::FreeDeleter::operator()(void *p) const
+{
+    std::free(p);
+}
+
+RawSequenceWriter::AlignedBuffer RawSequenceWriter::allocate(size_t bytes)
+{
+    // Zeroed once, so padding never carries stale data into the file
+    AlignedBuffer buffer(static_cast<uint8_t*>(std::aligned_alloc(BLOCK_SIZE, roundUp(bytes, BLOCK_SIZE))));
+    if (buffer) {
+        std::memset(buffer.get(), 0, roundUp(bytes, BLOCK_SIZE));
+    }
+    return buffer;
+}
+
+RawSequenceWriter::RawSequenceWriter()
+    : m_fd(-1)
+    , m_direct(false)
+    , m_capacity(0)
+    , m_recordCount(0)
+    , m_nextOffset(0)
+    , m_framesWritten(0)
+    , m_framesFailed(0)
+    , m_bytesWritten(0)
+    , m_writeLatency(nullptr)
+{
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+RawSequenceWriter::~RawSequenceWriter()
+{
+    QString error;
+    if (isOpen() && !close(error)) {
+        qDebug() << "[RawSequenceWriter]" << error;
+    }
+}
+
+bool RawSequenceWriter::open(const QString &filePath, const FrameHandle &first, quint64 capacity,
+                             double timestampTickFrequency, QString &error)
+{
+    if (isOpen() && !close(error)) {
+        return false;
+    }
+    if (first.isEmpty() || capacity == 0) {
+        error = "Nothing to record";
+        return false;
+    }
+
+    const size_t payload = payloadSize(first);
+    const size_t record = recordSize(payload);
+
+    m_headerBlocks = allocate(MAX_BATCH_RECORDS * BLOCK_SIZE);
+    m_tailBlocks = allocate(MAX_BATCH_RECORDS * BLOCK_SIZE);
+    m_copyBuffers = allocate(MAX_BATCH_RECORDS * (record - BLOCK_SIZE));
+    if (!m_headerBlocks || !m_tailBlocks || !m_copyBuffers) {
+        error = "Cannot allocate the record buffers";
+        return false;
+    }
+
+    const QByteArray path = filePath.toLocal8Bit();
+    m_direct = true;
+    m_fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0644);
+    if (m_fd < 0 && errno == EINVAL) {
+        // tmpfs and some network file systems refuse O_DIRECT
+        m_direct = false;
+        m_fd = ::open(path.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (m_fd < 0) {
+        error = QString("Cannot open %1: %2").arg(filePath, std::strerror(errno));
+        return false;
+    }
+
+    // Reserve the whole file now so appending never waits for the allocator
+    const uint64_t indexBytes = roundUp(sizeof(IndexHeader) + capacity * sizeof(IndexEntry), BLOCK_SIZE);
+    const uint64_t fileBytes = BLOCK_SIZE + capacity * record + indexBytes;
+    if (::fallocate(m_fd, 0, 0, static_cast<off_t>(fileBytes)) != 0) {
+        if (errno == ENOSPC) {
+            error = QString("Not enough space for %1 frames in %2").arg(capacity).arg(filePath);
+            ::close(m_fd);
+            m_fd = -1;
+            ::unlink(path.constData());
+            return false;
+        }
+        qDebug() << "[RawSequenceWriter] fallocate failed, file grows while recording:" << std::strerror(errno);
+    }
+
+    std::memset(&m_header, 0, sizeof(m_header));
+    std::memcpy(m_header.magic, "BSEQRAW1", sizeof(m_header.magic));
+    m_header.version = 1;
+    m_header.headerSize = BLOCK_SIZE;
+    m_header.recordSize = record;
+    m_header.payloadSize = payload;
+    m_header.width = static_cast<uint32_t>(first.width());
+    m_header.height = static_cast<uint32_t>(first.height());
+    m_header.pixelType = static_cast<uint32_t>(first.pixelType());
+    m_header.timestampTickFrequency = timestampTickFrequency;
+    m_header.createdMsecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+
+    m_filePath = filePath;
+    m_capacity = capacity;
+    m_recordCount = 0;
+    m_nextOffset = BLOCK_SIZE;
+    m_staged.clear();
+    m_staged.reserve(MAX_BATCH_RECORDS);
+    m_index.clear();
+    m_index.reserve(capacity);
+
+    if (!writeFileHeader(error)) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    qDebug() << "[RawSequenceWriter] Opened" << filePath << (m_direct ? "with O_DIRECT" : "buffered")
+             << "for" << capacity << "frames of" << record << "bytes";
+    return true;
+}
+
+bool RawSequenceWriter::matches(const FrameHandle &frame) const
+{
+    return isOpen() && !frame.isEmpty() &&
+           static_cast<uint32_t>(frame.width()) == m_header.width &&
+           static_cast<uint32_t>(frame.height()) == m_header.height &&
+           static_cast<uint32_t>(frame.pixelType()) == m_header.pixelType &&
+           payloadSize(frame) == m_header.payloadSize;
+}
+
+bool RawSequenceWriter::append(const FrameHandle &frame, double exposureTimeUs, QString &error)
+{
+    if (!matches(frame)) {
+        error = "Frame does not match the open sequence";
+        return false;
+    }
+    if (isFull()) {
+        error = QString("%1 is full").arg(m_filePath);
+        return false;
+    }
+    if (static_cast<int>(m_staged.size()) >= MAX_BATCH_RECORDS && !flush(error)) {
+        m_framesFailed++;
+        return false;
+    }
+
+    const int slot = static_cast<int>(m_staged.size());
+    const size_t payload = m_header.payloadSize;
+    const size_t paddedPayload = m_header.recordSize - BLOCK_SIZE;
+
+    uint8_t *headerBlock = m_headerBlocks.get() + slot * BLOCK_SIZE;
+    RecordHeader *header = reinterpret_cast<RecordHeader*>(headerBlock);
+    std::memset(header, 0, sizeof(RecordHeader));
+    std::memcpy(header->magic, "FRAM", sizeof(header->magic));
+    header->headerSize = BLOCK_SIZE;
+    header->sequenceIndex = m_recordCount;
+    header->frameId = frame.frameId();
+    header->blockId = frame.blockId();
+    header->cameraTimestamp = frame.cameraTimestamp();
+    header->hostTimestampNs = frame.timestampNs();
+    header->pixelType = static_cast<uint32_t>(frame.pixelType());
+    header->width = static_cast<uint32_t>(frame.width());
+    header->height = static_cast<uint32_t>(frame.height());
+    header->skippedImages = frame.skippedImages();
+    header->payloadSize = payload;
+    header->exposureTimeUs = exposureTimeUs;
+    m_iov.push_back({headerBlock, BLOCK_SIZE});
+
+    const cv::Mat &image = frame.image();
+    if (image.isContinuous() && isAligned(image.data)) {
+        // Straight from the grab buffer, only the last partial block is copied
+        const size_t direct = payload / BLOCK_SIZE * BLOCK_SIZE;
+        if (direct > 0) {
+            m_iov.push_back({image.data, direct});
+        }
+        if (direct < payload) {
+            uint8_t *tail = m_tailBlocks.get() + slot * BLOCK_SIZE;
+            std::memcpy(tail, image.data + direct, payload - direct);
+            std::memset(tail + (payload - direct), 0, BLOCK_SIZE - (payload - direct));
+            m_iov.push_back({tail, BLOCK_SIZE});
+        }
+    } else {
+        // Row padding or an unaligned buffer, pack the rows into the copy arena
+        uint8_t *copy = m_copyBuffers.get() + slot * paddedPayload;
+        const size_t rowBytes = image.cols * image.elemSize();
+        for (int y = 0; y < image.rows; ++y) {
+            std::memcpy(copy + y * rowBytes, image.ptr(y), rowBytes);
+        }
+        m_iov.push_back({copy, paddedPayload});
+    }
+
+    Staged staged;
+    staged.frame = frame;
+    staged.entry.offset = m_nextOffset;
+    staged.entry.frameId = frame.frameId();
+    staged.entry.cameraTimestamp = frame.cameraTimestamp();
+    staged.entry.hostTimestampNs = frame.timestampNs();
+    m_staged.push_back(staged);
+
+    m_nextOffset += m_header.recordSize;
+    m_recordCount++;
+    return true;
+}
+
+bool RawSequenceWriter::flush(QString &error)
+{
+    if (m_staged.empty()) {
+        return true;
+    }
+
+    const uint64_t offset = m_staged.front().entry.offset;
+    const size_t bytes = m_staged.size() * m_header.recordSize;
+    const bool ok = writeAt(m_iov.data(), static_cast<int>(m_iov.size()), offset, bytes, error);
+
+    if (ok) {
+        const int64_t now = FrameHandle::currentTimestampNs();
+        for (const Staged &staged : m_staged) {
+            m_index.push_back(staged.entry);
+            if (m_writeLatency) {
+                m_writeLatency->record(now - staged.frame.timestampNs());
+            }
+        }
+        m_framesWritten += m_staged.size();
+        m_bytesWritten += bytes;
+        if (!m_direct) {
+            dropFromCache(offset, bytes);
+        }
+    } else {
+        // The slots stay in the file as holes the index does not point at
+        m_framesFailed += m_staged.size();
+    }
+
+    // Releases the grab buffers written in place
+    m_staged.clear();
+    m_iov.clear();
+    return ok;
+}
+
+bool RawSequenceWriter::close(QString &error)
+{
+    if (!isOpen()) {
+        return true;
+    }
+
+    bool ok = flush(error);
+
+    // Index right behind the last record slot
+    const uint64_t indexOffset = BLOCK_SIZE + m_recordCount * m_header.recordSize;
+    const size_t indexBytes = roundUp(sizeof(IndexHeader) + m_index.size() * sizeof(IndexEntry), BLOCK_SIZE);
+    AlignedBuffer index = allocate(indexBytes);
+    if (index) {
+        IndexHeader *indexHeader = reinterpret_cast<IndexHeader*>(index.get());
+        std::memcpy(indexHeader->magic, "BSEQIDX1", sizeof(indexHeader->magic));
+        indexHeader->count = m_index.size();
+        if (!m_index.empty()) {
+            std::memcpy(index.get() + sizeof(IndexHeader), m_index.data(), m_index.size() * sizeof(IndexEntry));
+        }
+
+        struct iovec iov = {index.get(), indexBytes};
+        QString indexError;
+        if (writeAt(&iov, 1, indexOffset, indexBytes, indexError)) {
+            m_header.frameCount = m_index.size();
+            m_header.indexOffset = indexOffset;
+        } else {
+            ok = false;
+            error = indexError;
+        }
+    } else {
+        ok = false;
+        error = "Cannot allocate the index";
+    }
+
+    QString headerError;
+    if (!writeFileHeader(headerError)) {
+        ok = false;
+        error = headerError;
+    }
+
+    // Give back the preallocated space of the records that were never written
+    const uint64_t usedBytes = m_header.indexOffset ? indexOffset + indexBytes : indexOffset;
+    if (::ftruncate(m_fd, static_cast<off_t>(usedBytes)) != 0) {
+        qDebug() << "[RawSequenceWriter] ftruncate failed:" << std::strerror(errno);
+    }
+    if (::fdatasync(m_fd) != 0 && ok) {
+        ok = false;
+        error = QString("Cannot sync %1: %2").arg(m_filePath, std::strerror(errno));
+    }
+    ::close(m_fd);
+    m_fd = -1;
+
+    qDebug() << "[RawSequenceWriter] Closed" << m_filePath << "with" << m_index.size() << "frames";
+    return ok;
+}
+
+bool RawSequenceWriter::writeAt(const struct iovec *iov, int count, uint64_t offset, size_t bytes, QString &error)
+{
+    std::vector<struct iovec> pending(iov, iov + count);
+    size_t first = 0;
+    size_t remaining = bytes;
+
+    while (remaining > 0) {
+        const ssize_t written = ::pwritev(m_fd, pending.data() + first, static_cast<int>(pending.size() - first),
+                                          static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = QString("Write to %1 failed: %2").arg(m_filePath, std::strerror(errno));
+            return false;
+        }
+        if (written == 0) {
+            error = QString("Write to %1 made no progress").arg(m_filePath);
+            return false;
+        }
+
+        // Short write, e.g. the disk filled up: continue behind what made it
+        offset += written;
+        remaining -= written;
+        size_t advance = static_cast<size_t>(written);
+        while (first < pending.size() && advance >= pending[first].iov_len) {
+            advance -= pending[first].iov_len;
+            first++;
+        }
+        if (advance > 0) {
+            pending[first].iov_base = static_cast<uint8_t*>(pending[first].iov_base) + advance;
+            pending[first].iov_len -= advance;
+        }
+    }
+    return true;
+}
+
+bool RawSequenceWriter::writeFileHeader(QString &error)
+{
+    AlignedBuffer block = allocate(BLOCK_SIZE);
+    if (!block) {
+        error = "Cannot allocate the file header";
+        return false;
+    }
+    std::memcpy(block.get(), &m_header, sizeof(m_header));
+    struct iovec iov = {block.get(), BLOCK_SIZE};
+    return writeAt(&iov, 1, 0, BLOCK_SIZE, error);
+}
+
+void RawSequenceWriter::dropFromCache(uint64_t offset, size_t bytes)
+{
+    // Without O_DIRECT: write back now and evict, so recording does not fill the page cache
+    ::sync_file_range(m_fd, static_cast<off_t>(offset), static_cast<off_t>(bytes),
+                      SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    ::posix_fadvise(m_fd, static_cast<off_t>(offset), static_cast<off_t>(bytes), POSIX_FADV_DONTNEED);
+}
+
+RawSequenceReader::RawSequenceReader()
+    : m_map(nullptr)
+    , m_mapBytes(0)
+    , m_indexed(false)
+{
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+RawSequenceReader::~RawSequenceReader()
+{
+    close();
+}
+
+bool RawSequenceReader::open(const QString &filePath, QString &error)
+{
+    close();
+
+    const QByteArray path = filePath.toLocal8Bit();
+    const int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = QString("Cannot open %1: %2").arg(filePath, std::strerror(errno));
+        return false;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(BLOCK_SIZE)) {
+        error = QString("%1 is not a raw sequence").arg(filePath);
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping outlives the descriptor
+    const size_t bytes = static_cast<size_t>(status.st_size);
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = QString("Cannot map %1: %2").arg(filePath, std::strerror(errno));
+        return false;
+    }
+    m_map = static_cast<uint8_t*>(map);
+    m_mapBytes = bytes;
+    ::madvise(m_map, m_mapBytes, MADV_SEQUENTIAL);
+
+    std::memcpy(&m_header, m_map, sizeof(m_header));
+    if (std::memcmp(m_header.magic, "BSEQRAW1", sizeof(m_header.magic)) != 0 || m_header.version != 1 ||
+        m_header.headerSize != BLOCK_SIZE || m_header.payloadSize == 0 ||
+        m_header.recordSize != recordSize(m_header.payloadSize)) {
+        error = QString("%1 is not a raw sequence or has an unknown version").arg(filePath);
+        close();
+        return false;
+    }
+
+    const uint64_t recordBytes = m_header.recordSize;
+    const uint64_t indexOffset = m_header.indexOffset;
+    if (indexOffset != 0 && indexOffset + sizeof(IndexHeader) <= m_mapBytes) {
+        const IndexHeader *index = reinterpret_cast<const IndexHeader*>(m_map + indexOffset);
+        const uint64_t entriesBytes = (m_mapBytes - indexOffset - sizeof(IndexHeader)) / sizeof(IndexEntry) * sizeof(IndexEntry);
+        if (std::memcmp(index->magic, "BSEQIDX1", sizeof(index->magic)) == 0 &&
+            index->count * sizeof(IndexEntry) <= entriesBytes) {
+            const IndexEntry *entries = reinterpret_cast<const IndexEntry*>(m_map + indexOffset + sizeof(IndexHeader));
+            m_offsets.reserve(index->count);
+            for (uint64_t i = 0; i < index->count; ++i) {
+                if (entries[i].offset < BLOCK_SIZE || entries[i].offset + recordBytes > indexOffset) {
+                    break;
+                }
+                m_offsets.push_back(entries[i].offset);
+            }
+            m_indexed = (m_offsets.size() == index->count);
+        }
+    }
+
+    if (!m_indexed) {
+        // Not closed (or a damaged index): every slot that holds a record header counts
+        m_offsets.clear();
+        const uint64_t end = indexOffset != 0 ? qMin<uint64_t>(indexOffset, m_mapBytes) : m_mapBytes;
+        uint64_t slot = 0;
+        for (uint64_t offset = BLOCK_SIZE; offset + recordBytes <= end; offset += recordBytes, ++slot) {
+            const RecordHeader *header = reinterpret_cast<const RecordHeader*>(m_map + offset);
+            if (std::memcmp(header->magic, "FRAM", sizeof(header->magic)) == 0 && header->sequenceIndex == slot &&
+                header->payloadSize == m_header.payloadSize) {
+                m_offsets.push_back(offset);
+            }
+        }
+        qDebug() << "[RawSequenceReader]" << filePath << "has no index, recovered" << m_offsets.size() << "frames";
+    }
+
+    m_filePath = filePath;
+    qDebug() << "[RawSequenceReader] Opened" << filePath << "with" << m_offsets.size() << "frames,"
+             << m_header.width << "x" << m_header.height << "pixel type" << m_header.pixelType;
+    return true;
+}
+
+void RawSequenceReader::close()
+{
+    if (m_map) {
+        ::munmap(m_map, m_mapBytes);
+    }
+    m_map = nullptr;
+    m_mapBytes = 0;
+    m_offsets.clear();
+    m_indexed = false;
+}
+
+const RecordHeader* RawSequenceReader::record(quint64 index) const
+{
+    if (index >= m_offsets.size()) {
+        return nullptr;
+    }
+    return reinterpret_cast<const RecordHeader*>(m_map + m_offsets[index]);
+}
+
+const uint8_t* RawSequenceReader::pixels(quint64 index) const
+{
+    if (index >= m_offsets.size()) {
+        return nullptr;
+    }
+    return m_map + m_offsets[index] + BLOCK_SIZE;
+}
+
+void RawSequenceReader::prefetch(quint64 index, quint64 count) const
+{
+    const quint64 end = qMin<quint64>(index + count, m_offsets.size());
+    for (quint64 i = index; i < end; ++i) {
+        ::madvise(m_map + m_offsets[i], m_header.recordSize, MADV_WILLNEED);
+    }
+}
@@ -0,0 +1,203 @@
+#ifndef RAW_SEQUENCE_H
+#define RAW_SEQUENCE_H
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+#include "frame_handle.h"
+#include "latency_histogram.h"
+
+// Raw frame sequence container (.bseq).
+//
+// Layout, little-endian, every part starting on a BLOCK_SIZE boundary:
+//   FileHeader            one block
+//   record 0 .. n-1       recordSize bytes each: a RecordHeader block,
+//                         then the pixel data padded to whole blocks
+//   IndexHeader + n IndexEntry, padded to a whole block
+//
+// All records of a file have the same geometry and pixel format, so record
+// k lives at BLOCK_SIZE + k * recordSize. The file header points at the
+// index once the file has been closed; a file that was not closed has
+// indexOffset 0 and its records can still be found by that formula.
+namespace RawSequence
+{
+    static const size_t BLOCK_SIZE = 4096;
+
+    struct FileHeader
+    {
+        char magic[8];                  // "BSEQRAW1"
+        uint32_t version;
+        uint32_t headerSize;            // BLOCK_SIZE
+        uint64_t recordSize;
+        uint64_t payloadSize;           // Pixel data bytes per frame
+        uint32_t width;
+        uint32_t height;
+        uint32_t pixelType;             // Pylon EPixelType
+        uint32_t reserved;
+        uint64_t frameCount;            // Entries in the index
+        uint64_t indexOffset;           // 0 until the file is closed
+        double timestampTickFrequency;  // Camera timestamp ticks per second, 0 if unknown
+        int64_t createdMsecsSinceEpoch;
+    };
+
+    struct RecordHeader
+    {
+        char magic[4];                  // "FRAM"
+        uint32_t headerSize;            // BLOCK_SIZE, the pixel data follows
+        uint64_t sequenceIndex;         // Record number in this file
+        int64_t frameId;
+        uint64_t blockId;
+        uint64_t cameraTimestamp;       // Camera ticks, 0 if unknown
+        int64_t hostTimestampNs;        // FrameHandle::timestampNs()
+        uint32_t pixelType;
+        uint32_t width;
+        uint32_t height;
+        uint32_t skippedImages;
+        uint64_t payloadSize;
+        double exposureTimeUs;          // 0 if unknown
+    };
+
+    struct IndexHeader
+    {
+        char magic[8];                  // "BSEQIDX1"
+        uint64_t count;
+    };
+
+    struct IndexEntry
+    {
+        uint64_t offset;                // Byte offset of the record
+        int64_t frameId;
+        uint64_t cameraTimestamp;
+        int64_t hostTimestampNs;
+    };
+
+    static_assert(sizeof(FileHeader) == 80, "FileHeader layout");
+    static_assert(sizeof(RecordHeader) == 80, "RecordHeader layout");
+    static_assert(sizeof(IndexHeader) == 16, "IndexHeader layout");
+    static_assert(sizeof(IndexEntry) == 32, "IndexEntry layout");
+
+    // Bytes of pixel data a frame contributes
+    size_t payloadSize(const FrameHandle &frame);
+    size_t recordSize(size_t payloadSize);
+}
+
+// Appends frames to a .bseq file without going through the page cache.
+//
+// open() preallocates the file for the given number of records with
+// fallocate() and opens it with O_DIRECT (plain writes followed by
+// writeback and POSIX_FADV_DONTNEED on file systems that refuse it).
+// append() only stages a record: the header and the unaligned tail of the
+// pixel data are copied into aligned blocks, page-aligned pixel data is
+// referenced in place and the frame kept alive. flush() submits all staged
+// records with one pwritev(). close() writes the index, completes the file
+// header and gives back the preallocated space that was not used.
+//
+// Not thread-safe, FrameRecorder drives it from one writer thread.
+class RawSequenceWriter
+{
+public:
+    static const int MAX_BATCH_RECORDS = 8;
+
+    RawSequenceWriter();
+    ~RawSequenceWriter();
+
+    bool open(const QString &filePath, const FrameHandle &first, quint64 capacity,
+              double timestampTickFrequency, QString &error);
+    bool close(QString &error);
+    bool isOpen() const { return m_fd >= 0; }
+
+    // Same geometry and pixel format as the records of the open file
+    bool matches(const FrameHandle &frame) const;
+    bool isFull() const { return m_recordCount >= m_capacity; }
+
+    bool append(const FrameHandle &frame, double exposureTimeUs, QString &error);
+    bool flush(QString &error);
+
+    // Receives the frame age when its record has been written, may be nullptr
+    void setWriteLatencyHistogram(LatencyHistogram *histogram) { m_writeLatency = histogram; }
+
+    QString filePath() const { return m_filePath; }
+    bool isDirect() const { return m_direct; }
+    quint64 recordCount() const { return m_recordCount; }   // Written and staged, this file
+    // Totals over all files this writer has had open
+    quint64 framesWritten() const { return m_framesWritten; }
+    quint64 framesFailed() const { return m_framesFailed; }
+    quint64 bytesWritten() const { return m_bytesWritten; }
+
+private:
+    struct FreeDeleter { void operator()(void *p) const; };
+    typedef std::unique_ptr<uint8_t, FreeDeleter> AlignedBuffer;
+
+    struct Staged
+    {
+        FrameHandle frame;               // Pixel data may be written in place
+        RawSequence::IndexEntry entry;
+    };
+
+    static AlignedBuffer allocate(size_t bytes);
+    bool writeAt(const struct iovec *iov, int count, uint64_t offset, size_t bytes, QString &error);
+    bool writeFileHeader(QString &error);
+    void dropFromCache(uint64_t offset, size_t bytes);
+
+    int m_fd;
+    bool m_direct;
+    QString m_filePath;
+    RawSequence::FileHeader m_header;
+    quint64 m_capacity;
+    quint64 m_recordCount;
+    uint64_t m_nextOffset;
+
+    AlignedBuffer m_headerBlocks;   // MAX_BATCH_RECORDS record header blocks
+    AlignedBuffer m_tailBlocks;     // MAX_BATCH_RECORDS blocks for the end of the pixel data
+    AlignedBuffer m_copyBuffers;    // Whole records for frames that cannot be written in place
+    std::vector<Staged> m_staged;
+    std::vector<struct iovec> m_iov;
+    std::vector<RawSequence::IndexEntry> m_index;
+
+    quint64 m_framesWritten;
+    quint64 m_framesFailed;
+    quint64 m_bytesWritten;
+    LatencyHistogram *m_writeLatency;
+};
+
+// Read-only view of a .bseq file through a memory mapping.
+//
+// open() maps the whole file and takes the record offsets from the index,
+// or, for a file that was not closed, by checking every record slot for a
+// record header. Nothing is copied: record() and pixels() point into the
+// mapping, which stays valid until close() or the reader is destroyed.
+// The reader does not change after open(), any thread may read from it.
+class RawSequenceReader
+{
+public:
+    RawSequenceReader();
+    ~RawSequenceReader();
+
+    bool open(const QString &filePath, QString &error);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    QString filePath() const { return m_filePath; }
+    const RawSequence::FileHeader& header() const { return m_header; }
+    bool isIndexed() const { return m_indexed; }             // false when recovered by scanning
+    quint64 frameCount() const { return m_offsets.size(); }
+
+    const RawSequence::RecordHeader* record(quint64 index) const;
+    const uint8_t* pixels(quint64 index) const;
+
+    // Asks the kernel to read the records ahead, e.g. the next ones to play
+    void prefetch(quint64 index, quint64 count) const;
+
+private:
+    QString m_filePath;
+    uint8_t *m_map;
+    size_t m_mapBytes;
+    RawSequence::FileHeader m_header;
+    std::vector<uint64_t> m_offsets;
+    bool m_indexed;
+};
+
+#endif // RAW_SEQUENCE_H
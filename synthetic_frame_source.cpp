@@ -0,0 +1,256 @@
+#include "synthetic_frame_source.h"
+#include <QDebug>
+
+using namespace Pylon;
+
+SyntheticFrameSource::SyntheticFrameSource(int width, int height, EPixelType pixelType, double frameRate)
+    : m_width(qMax(1, width))
+    , m_height(qMax(1, height))
+    , m_pixelType(isSupportedPixelType(pixelType) ? pixelType : PixelType_Mono8)
+    , m_frameRate(qMax(0.0, frameRate))
+    , m_open(false)
+    , m_frameWidth(0)
+    , m_frameHeight(0)
+    , m_framePixelType(PixelType_Mono8)
+    , m_framePeriod(Clock::duration::zero())
+    , m_frameId(0)
+    , m_interrupted(false)
+{
+}
+
+bool SyntheticFrameSource::open(QString &error)
+{
+    Q_UNUSED(error);
+
+    m_open = true;
+    m_frameId = 0;
+
+    qDebug() << "[SyntheticFrameSource] Opened:" << getWidth() << "x" << getHeight()
+             << "pixel type" << getPixelType() << "@" << getFrameRate() << "fps";
+    return true;
+}
+
+void SyntheticFrameSource::close()
+{
+    m_open = false;
+    m_pattern.release();
+}
+
+void SyntheticFrameSource::startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition)
+{
+    // Frames share the pattern, there is no buffer pool to size or queue to drop from
+    Q_UNUSED(bufferConfig);
+    Q_UNUSED(acquisition);
+
+    double frameRate;
+    {
+        std::lock_guard<std::mutex> lock(m_settingsMutex);
+        m_frameWidth = m_width;
+        m_frameHeight = m_height;
+        m_framePixelType = m_pixelType;
+        frameRate = m_frameRate;
+    }
+
+    m_framePeriod = Clock::duration::zero();
+    if (frameRate > 0.0) {
+        m_framePeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / frameRate));
+    }
+    m_nextFrameTime = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_interrupted = false;
+    }
+
+    renderPattern();
+}
+
+void SyntheticFrameSource::stopGrabbing()
+{
+}
+
+void SyntheticFrameSource::interruptRetrieve()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_interrupted = true;
+    }
+    m_wakeUp.notify_all();
+}
+
+bool SyntheticFrameSource::waitUntil(Clock::time_point time)
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeUp.wait_until(lock, time, [this]() { return m_interrupted; });
+
+    const bool interrupted = m_interrupted;
+    m_interrupted = false;
+    return !interrupted;
+}
+
+void SyntheticFrameSource::renderPattern()
+{
+    const int width = m_frameWidth;
+    const int height = m_frameHeight;
+    const bool color = (m_framePixelType == PixelType_RGB8packed || m_framePixelType == PixelType_BGR8packed);
+    const bool bayer = (m_framePixelType == PixelType_BayerRG8);
+
+    double maxValue = 255.0;
+    int type = color ? CV_8UC3 : CV_8UC1;
+    if (m_framePixelType == PixelType_Mono10) {
+        maxValue = 1023.0;
+        type = CV_16UC1;
+    } else if (m_framePixelType == PixelType_Mono12) {
+        maxValue = 4095.0;
+        type = CV_16UC1;
+    } else if (m_framePixelType == PixelType_Mono16) {
+        maxValue = 65535.0;
+        type = CV_16UC1;
+    }
+
+    // Frames still in flight keep the previous pattern, always allocate a new one
+    cv::Mat pattern(height, width * 2, type);
+
+    // Columns x and x + width are identical so any window of the pattern wraps seamlessly
+    for (int y = 0; y < height; ++y) {
+        const double fy = static_cast<double>(y) / height;
+        for (int x = 0; x < width * 2; ++x) {
+            const double fx = static_cast<double>(x % width) / width;
+            if (color) {
+                pattern.at<cv::Vec3b>(y, x) = cv::Vec3b(cv::saturate_cast<uchar>(255.0 * fx),
+                                                        cv::saturate_cast<uchar>(255.0 * fy),
+                                                        cv::saturate_cast<uchar>(255.0 * (1.0 - fx)));
+            } else if (bayer) {
+                // Same gradient as the colour formats, sampled through an RGGB mosaic
+                const double value = ((y & 1) == 0) ? ((x & 1) == 0 ? 1.0 - fx : fy)
+                                                    : ((x & 1) == 0 ? fy : fx);
+                pattern.at<uchar>(y, x) = cv::saturate_cast<uchar>(255.0 * value);
+            } else if (type == CV_16UC1) {
+                pattern.at<ushort>(y, x) = cv::saturate_cast<ushort>(maxValue * (0.75 * fx + 0.25 * fy));
+            } else {
+                pattern.at<uchar>(y, x) = cv::saturate_cast<uchar>(maxValue * (0.75 * fx + 0.25 * fy));
+            }
+        }
+    }
+
+    m_pattern = pattern;
+}
+
+IFrameSource::RetrieveStatus SyntheticFrameSource::retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error)
+{
+    Q_UNUSED(error);
+
+    if (m_pattern.empty()) {
+        return RetrieveTimeout;
+    }
+
+    // Pace to the configured frame rate like a free-running camera would
+    Clock::time_point captureTime = Clock::now();
+    int64_t missedFrames = 0;
+    if (m_framePeriod > Clock::duration::zero()) {
+        const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        if (m_nextFrameTime > deadline) {
+            waitUntil(deadline);
+            return RetrieveTimeout;
+        }
+        if (!waitUntil(m_nextFrameTime)) {
+            return RetrieveTimeout;
+        }
+
+        // Do not burst to catch up after a stall, drop the missed frames instead
+        captureTime = m_nextFrameTime;
+        m_nextFrameTime += m_framePeriod;
+        const Clock::time_point now = Clock::now();
+        if (m_nextFrameTime < now) {
+            missedFrames = (now - m_nextFrameTime) / m_framePeriod + 1;
+            m_nextFrameTime = now + m_framePeriod;
+        }
+    }
+
+    // Scroll the pattern by a few columns per frame
+    const int step = qMax(1, m_frameWidth / 120);
+    int offset = static_cast<int>((m_frameId * step) % m_frameWidth);
+    if (m_framePixelType == PixelType_BayerRG8) {
+        offset &= ~1; // Keep the mosaic phase
+    }
+
+    const uint64_t cameraTimestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        captureTime.time_since_epoch()).count();
+    frame = FrameHandle::fromImage(m_pattern(cv::Rect(offset, 0, m_frameWidth, m_frameHeight)),
+                                   m_framePixelType, m_frameId, cameraTimestamp);
+    m_frameId += 1 + missedFrames;
+    return RetrieveOk;
+}
+
+bool SyntheticFrameSource::latchTimestamp(uint64_t &ticks, int64_t &hostNs)
+{
+    // The "camera" clock is the host clock
+    hostNs = FrameHandle::currentTimestampNs();
+    ticks = static_cast<uint64_t>(hostNs);
+    return true;
+}
+
+void SyntheticFrameSource::setResolution(int width, int height)
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    m_width = qMax(1, width);
+    m_height = qMax(1, height);
+}
+
+void SyntheticFrameSource::setPixelType(EPixelType pixelType)
+{
+    if (!isSupportedPixelType(pixelType)) {
+        qDebug() << "[SyntheticFrameSource] Unsupported pixel type:" << pixelType;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    m_pixelType = pixelType;
+}
+
+void SyntheticFrameSource::setFrameRate(double frameRate)
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    m_frameRate = qMax(0.0, frameRate);
+}
+
+int SyntheticFrameSource::getWidth() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    return m_width;
+}
+
+int SyntheticFrameSource::getHeight() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    return m_height;
+}
+
+EPixelType SyntheticFrameSource::getPixelType() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    return m_pixelType;
+}
+
+double SyntheticFrameSource::getFrameRate() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    return m_frameRate;
+}
+
+bool SyntheticFrameSource::isSupportedPixelType(EPixelType pixelType)
+{
+    // The formats FrameHandle can wrap natively
+    switch (pixelType) {
+        case PixelType_Mono8:
+        case PixelType_Mono10:
+        case PixelType_Mono12:
+        case PixelType_Mono16:
+        case PixelType_RGB8packed:
+        case PixelType_BGR8packed:
+        case PixelType_BayerRG8:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SYNTHETIC_FRAME_SOURCE_H
+#define SYNTHETIC_FRAME_SOURCE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "frame_source.h"
+
+// Software frame generator for running the pipeline without a camera.
+//
+// Produces a scrolling gradient test pattern at the configured resolution,
+// pixel format and frame rate. A frame rate of 0 generates frames as fast as
+// the grab loop asks for them, which is what throughput measurements want.
+// The pattern is rendered once per startGrabbing() and every frame is a view
+// into it, so generating a frame costs no pixel copies. There is no frame
+// queue, so every grab strategy behaves like LatestImageOnly. Frames are
+// stamped with their scheduled capture time on the host's steady clock as
+// the camera timestamp, and frames missed during a stall leave a gap in the
+// frame IDs, like a free-running camera would.
+class SyntheticFrameSource : public IFrameSource
+{
+public:
+    SyntheticFrameSource(int width, int height, Pylon::EPixelType pixelType, double frameRate);
+
+    bool open(QString &error) override;
+    void close() override;
+    bool isOpen() const override { return m_open; }
+
+    QString getName() const override { return "Synthetic Source"; }
+    QString getModel() const override { return "Synthetic Generator"; }
+    QString getSerial() const override { return "N/A"; }
+
+    void startGrabbing(const BufferConfig &bufferConfig, const AcquisitionConfig &acquisition) override;
+    void stopGrabbing() override;
+    RetrieveStatus retrieveFrame(unsigned int timeoutMs, FrameHandle &frame, QString &error) override;
+    void interruptRetrieve() override;
+    double getTimestampTickFrequency() const override { return 1e9; }
+    bool latchTimestamp(uint64_t &ticks, int64_t &hostNs) override;
+
+    // Settings take effect on the next startGrabbing()
+    void setResolution(int width, int height);
+    void setPixelType(Pylon::EPixelType pixelType);
+    void setFrameRate(double frameRate);
+    int getWidth() const;
+    int getHeight() const;
+    Pylon::EPixelType getPixelType() const;
+    double getFrameRate() const;
+
+    static bool isSupportedPixelType(Pylon::EPixelType pixelType);
+
+private:
+    void renderPattern();
+
+    using Clock = std::chrono::steady_clock;
+
+    // Sleeps until the time point, false when interruptRetrieve() ended it early
+    bool waitUntil(Clock::time_point time);
+
+    mutable std::mutex m_settingsMutex;
+    int m_width;
+    int m_height;
+    Pylon::EPixelType m_pixelType;
+    double m_frameRate;
+
+    // Grab thread state
+    bool m_open;
+    cv::Mat m_pattern;      // Twice the frame width, frames are views into it
+    int m_frameWidth;
+    int m_frameHeight;
+    Pylon::EPixelType m_framePixelType;
+    Clock::duration m_framePeriod;
+    Clock::time_point m_nextFrameTime;
+    int64_t m_frameId;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeUp;
+    bool m_interrupted;     // Guarded by m_wakeMutex
+};
+
+#endif // SYNTHETIC_FRAME_SOURCE_H
@@ -0,0 +1,128 @@
+#include "thread_affinity.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool ThreadAffinity::pinCurrentThread(int core, QString &error)
+{
+    return pinCurrentThread(QVector<int>{core}, error);
+}
+
+bool ThreadAffinity::pinCurrentThread(const QVector<int> &cores, QString &error)
+{
+#ifdef __linux__
+    if (cores.isEmpty()) {
+        error = "No cores given";
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int core : cores) {
+        if (core < 0 || core >= CPU_SETSIZE) {
+            error = QString("Core %1 out of range").arg(core);
+            return false;
+        }
+        CPU_SET(core, &cpus);
+    }
+
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+        error = QString("Cannot pin to cores %1: %2").arg(formatCoreList(cores)).arg(strerror(result));
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(cores);
+    error = "Thread affinity is not supported on this platform";
+    return false;
+#endif
+}
+
+QVector<int> ThreadAffinity::allowedCores()
+{
+    QVector<int> cores;
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &cpus)) {
+                cores.append(core);
+            }
+        }
+        return cores;
+    }
+#endif
+    const int count = static_cast<int>(std::thread::hardware_concurrency());
+    for (int core = 0; core < qMax(1, count); ++core) {
+        cores.append(core);
+    }
+    return cores;
+}
+
+int ThreadAffinity::coreForIndex(int index, int firstCore)
+{
+    const QVector<int> cores = allowedCores();
+
+    int start = 0;
+    while (start < cores.size() && cores[start] < firstCore) {
+        start++;
+    }
+    if (start == cores.size()) {
+        start = 0;
+    }
+    return cores[(start + qMax(0, index)) % cores.size()];
+}
+
+bool ThreadAffinity::parseCoreList(const QString &text, QVector<int> &cores)
+{
+    cores.clear();
+
+    const QStringList ranges = text.split(',', Qt::SkipEmptyParts);
+    for (const QString &range : ranges) {
+        const QStringList bounds = range.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = bounds.value(0).trimmed().toInt(&firstOk);
+        const int last = bounds.size() > 1 ? bounds.value(1).trimmed().toInt(&lastOk) : first;
+        if (bounds.size() > 2 || !firstOk || (bounds.size() > 1 && !lastOk) || first < 0 || last < first) {
+            cores.clear();
+            return false;
+        }
+        for (int core = first; core <= last; ++core) {
+            if (!cores.contains(core)) {
+                cores.append(core);
+            }
+        }
+    }
+
+    std::sort(cores.begin(), cores.end());
+    return true;
+}
+
+QString ThreadAffinity::formatCoreList(const QVector<int> &cores)
+{
+    QVector<int> sorted = cores;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Collapse consecutive cores into ranges
+    QStringList ranges;
+    for (int i = 0; i < sorted.size(); ) {
+        int j = i;
+        while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1) {
+            j++;
+        }
+        ranges.append(i == j ? QString::number(sorted[i])
+                             : QString("%1-%2").arg(sorted[i]).arg(sorted[j]));
+        i = j + 1;
+    }
+    return ranges.join(",");
+}
@@ -0,0 +1,33 @@
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <QString>
+#include <QVector>
+
+// Pins threads to CPU cores (Linux sched affinity).
+//
+// Used to keep each camera's grab thread on a core of its own, so several
+// pipelines on one host do not migrate across cores or compete with each
+// other's caches.
+class ThreadAffinity
+{
+public:
+    // Pin the calling thread to one core or a set of cores, false with a
+    // reason when a core does not exist or the call is not permitted
+    static bool pinCurrentThread(int core, QString &error);
+    static bool pinCurrentThread(const QVector<int> &cores, QString &error);
+
+    // Cores the process may run on, in ascending order
+    static QVector<int> allowedCores();
+
+    // Core for the index-th pipeline when the allowed cores are handed out
+    // round robin, starting at the first allowed core >= firstCore
+    static int coreForIndex(int index, int firstCore);
+
+    // Core lists in the kernel's cpulist format ("0-3,8,10-11"). parse
+    // returns false on malformed input; duplicates are removed.
+    static bool parseCoreList(const QString &text, QVector<int> &cores);
+    static QString formatCoreList(const QVector<int> &cores);
+};
+
+#endif // THREAD_AFFINITY_H
@@ -0,0 +1,147 @@
+#include "thread_policy.h"
+#include "thread_affinity.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// From <numaif.h>, without depending on libnuma
+static const int MEMORY_POLICY_PREFERRED = 1;
+static const int MAX_MEMORY_NODES = 64;
+
+#ifdef __linux__
+
+// SCHED_FIFO/RR, falling back to the rlimit ceiling and then to SCHED_OTHER
+static void applyScheduling(const ThreadPolicy::Config &config, ThreadPolicy::Applied &applied, QStringList &notes)
+{
+    if (config.scheduling == ThreadPolicy::SchedulingDefault) {
+        return;
+    }
+
+    const int policy = (config.scheduling == ThreadPolicy::SchedulingFifo) ? SCHED_FIFO : SCHED_RR;
+    const int priority = qBound(sched_get_priority_min(policy), config.priority, sched_get_priority_max(policy));
+
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int result = pthread_setschedparam(pthread_self(), policy, &param);
+
+    // Unprivileged processes may still use real-time priorities up to RLIMIT_RTPRIO
+    if (result == EPERM) {
+        rlimit limit;
+        if (getrlimit(RLIMIT_RTPRIO, &limit) == 0 && limit.rlim_cur > 0) {
+            param.sched_priority = static_cast<int>(qMin<rlim_t>(limit.rlim_cur, static_cast<rlim_t>(priority)));
+            result = pthread_setschedparam(pthread_self(), policy, &param);
+        }
+    }
+
+    if (result != 0) {
+        notes.append(QString("%1 %2 denied: %3")
+                     .arg(ThreadPolicy::schedulingName(config.scheduling)).arg(priority).arg(strerror(result)));
+        return;
+    }
+
+    applied.scheduling = config.scheduling;
+    applied.priority = param.sched_priority;
+    if (param.sched_priority != priority) {
+        notes.append(QString("priority limited to %1 by RLIMIT_RTPRIO").arg(param.sched_priority));
+    }
+}
+
+static void applyMemoryNode(int node, ThreadPolicy::Applied &applied, QStringList &notes)
+{
+    if (node < 0) {
+        return;
+    }
+    if (node >= MAX_MEMORY_NODES || node >= ThreadPolicy::nodeCount()) {
+        notes.append(QString("node %1 does not exist").arg(node));
+        return;
+    }
+
+    // Preferred rather than bound, so a full node does not fail allocations
+    unsigned long mask = 1UL << node;
+    if (syscall(SYS_set_mempolicy, MEMORY_POLICY_PREFERRED, &mask, MAX_MEMORY_NODES + 1) != 0) {
+        notes.append(QString("node %1 not applied: %2").arg(node).arg(strerror(errno)));
+        return;
+    }
+    applied.memoryNode = node;
+}
+
+#endif
+
+ThreadPolicy::Applied ThreadPolicy::applyToCurrentThread(const Config &config)
+{
+    Applied applied;
+    QStringList notes;
+
+#ifdef __linux__
+    // Affinity first, so the memory policy matches where the thread runs
+    QVector<int> cores = config.cores;
+    if (cores.isEmpty() && config.memoryNode >= 0) {
+        cores = nodeCores(config.memoryNode);
+    }
+    if (!cores.isEmpty()) {
+        QString error;
+        if (ThreadAffinity::pinCurrentThread(cores, error)) {
+            applied.cores = cores;
+        } else {
+            notes.append(error);
+        }
+    }
+
+    applyMemoryNode(config.memoryNode, applied, notes);
+    applyScheduling(config, applied, notes);
+#else
+    if (config.scheduling != SchedulingDefault || !config.cores.isEmpty() || config.memoryNode >= 0) {
+        notes.append("thread policies are not supported on this platform");
+    }
+#endif
+
+    applied.description = (applied.scheduling == SchedulingDefault)
+                        ? QString(schedulingName(SchedulingDefault))
+                        : QString("%1 %2").arg(schedulingName(applied.scheduling)).arg(applied.priority);
+    applied.description += applied.cores.isEmpty() ? QString(", any core")
+                                                   : ", cores " + ThreadAffinity::formatCoreList(applied.cores);
+    if (applied.memoryNode >= 0) {
+        applied.description += QString(", node %1").arg(applied.memoryNode);
+    }
+    if (!notes.isEmpty()) {
+        applied.description += " (" + notes.join("; ") + ")";
+    }
+    return applied;
+}
+
+const char* ThreadPolicy::schedulingName(Scheduling scheduling)
+{
+    switch (scheduling) {
+        case SchedulingFifo:       return "SCHED_FIFO";
+        case SchedulingRoundRobin: return "SCHED_RR";
+        default:                   return "SCHED_OTHER";
+    }
+}
+
+int ThreadPolicy::nodeCount()
+{
+    QStringList nodes = QDir("/sys/devices/system/node").entryList(QStringList() << "node*", QDir::Dirs);
+    return qMax(1, static_cast<int>(nodes.size()));
+}
+
+QVector<int> ThreadPolicy::nodeCores(int node)
+{
+    QVector<int> cores;
+    QFile file(QString("/sys/devices/system/node/node%1/cpulist").arg(node));
+    if (file.open(QIODevice::ReadOnly)) {
+        ThreadAffinity::parseCoreList(QString::fromLatin1(file.readAll()).trimmed(), cores);
+    }
+    return cores;
+}
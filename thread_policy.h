@@ -0,0 +1,54 @@
+#ifndef THREAD_POLICY_H
+#define THREAD_POLICY_H
+
+#include <QString>
+#include <QVector>
+
+// Real-time scheduling, CPU placement and NUMA memory placement for the
+// acquisition and recorder threads (Linux).
+//
+// Each part of the configuration is applied on its own and falls back
+// without failing the thread: SCHED_FIFO/SCHED_RR without CAP_SYS_NICE is
+// retried at the RLIMIT_RTPRIO ceiling and otherwise left at SCHED_OTHER,
+// missing cores or nodes are skipped. Applied says what actually took
+// effect, so the UI can report it.
+class ThreadPolicy
+{
+public:
+    enum Scheduling {
+        SchedulingDefault,     // SCHED_OTHER, left as is
+        SchedulingFifo,        // SCHED_FIFO, runs until it blocks
+        SchedulingRoundRobin   // SCHED_RR, time-sliced among equal priorities
+    };
+
+    struct Config
+    {
+        Scheduling scheduling = SchedulingDefault;
+        int priority = 50;        // 1..99, only for FIFO/RR
+        QVector<int> cores;       // Empty leaves the affinity alone, or uses the memory node's cores
+        int memoryNode = -1;      // Preferred NUMA node for new allocations, -1 = leave alone
+    };
+
+    struct Applied
+    {
+        Scheduling scheduling = SchedulingDefault;
+        int priority = 0;
+        QVector<int> cores;       // Empty when the affinity was not changed
+        int memoryNode = -1;
+        QString description;      // E.g. "SCHED_FIFO 50, cores 2-3, node 0"
+    };
+
+    // Apply to the calling thread. Memory placement only affects pages the
+    // thread touches from now on, so call this before allocating buffers.
+    static Applied applyToCurrentThread(const Config &config);
+
+    static const char* schedulingName(Scheduling scheduling);
+
+    // NUMA nodes present, 1 on machines without NUMA information
+    static int nodeCount();
+
+    // Cores of a NUMA node, empty when unknown
+    static QVector<int> nodeCores(int node);
+};
+
+#endif // THREAD_POLICY_H